@@ -0,0 +1,418 @@
+/**************************************************************************************************
+  Filename:       hal_flash.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    RAM-backed simulation of the internal flash for the POSIX host.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "hal_board_cfg.h"
+#include "hal_flash.h"
+#include "hal_mcu.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_HOST_FLASH_SIZE  (HAL_FLASH_PAGE_CNT * (uint32)HAL_FLASH_PAGE_SIZE)
+
+// The flash of a node with its wear counters, since the last halHostFlashReset().
+typedef struct
+{
+  uint32 writes;                        // Words written.
+  uint32 erases[HAL_FLASH_PAGE_CNT];    // Erases of each page.
+  uint32 readCalls;                     // Calls of HalFlashRead().
+  uint32 writeCalls;                    // Calls of HalFlashWrite().
+  uint8 image[HAL_HOST_FLASH_SIZE];
+} halHostFlash_t;
+
+/* One flash per simulated node, mapped shared on first use so that what a fork()ed child
+ * writes, up to a simulated power cut, is left to the parent.
+ */
+static halHostFlash_t *halHostFlash[HAL_HOST_NODE_CNT];
+static uint8 halHostFlashIdx = 0;
+
+// Flash steps, word writes or page erases, still to do before the power is cut.
+static uint32 halHostFlashCutCnt = HAL_HOST_FLASH_NO_CUT;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static halHostFlash_t *halHostFlashNode(void);
+static void halHostFlashStep(void);
+
+/**************************************************************************************************
+ * @fn          halHostFlashNode
+ *
+ * @brief       This function returns the selected flash, mapping it erased on first use.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the flash of the selected node.
+ **************************************************************************************************
+ */
+static halHostFlash_t *halHostFlashNode(void)
+{
+  if (halHostFlash[halHostFlashIdx] == NULL)
+  {
+    void *pMap = mmap(NULL, sizeof(halHostFlash_t), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pMap == MAP_FAILED)
+    {
+      abort();
+    }
+    halHostFlash[halHostFlashIdx] = pMap;
+    halHostFlashReset();
+  }
+
+  return halHostFlash[halHostFlashIdx];
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashStep
+ *
+ * @brief       This function is called ahead of each word write and page erase. When the steps
+ *              armed by halHostFlashCut() have run out, the power is cut: the process ends at
+ *              once with HAL_HOST_CUT_EXIT, without the step in progress being done.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void halHostFlashStep(void)
+{
+  if (halHostFlashCutCnt != HAL_HOST_FLASH_NO_CUT)
+  {
+    if (halHostFlashCutCnt == 0)
+    {
+      _exit(HAL_HOST_CUT_EXIT);
+    }
+    halHostFlashCutCnt--;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashSelect
+ *
+ * @brief       This function selects the flash image that HalFlashRead/Write/Erase work on, so
+ *              that each simulated node keeps its own NV.
+ *
+ * input parameters
+ *
+ * @param       node - Index of the node's image, less than HAL_HOST_NODE_CNT.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halHostFlashSelect(uint8 node)
+{
+  if (node < HAL_HOST_NODE_CNT)
+  {
+    halHostFlashIdx = node;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashImage
+ *
+ * @brief       This function returns the selected RAM image that simulates the internal flash, so
+ *              that a harness can snapshot, corrupt or restore it. A never written image is erased.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to HAL_FLASH_PAGE_CNT pages of HAL_FLASH_PAGE_SIZE bytes.
+ **************************************************************************************************
+ */
+uint8 *halHostFlashImage(void)
+{
+  return halHostFlashNode()->image;
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashReset
+ *
+ * @brief       This function erases every page of the selected flash image and clears its
+ *              wear counters.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halHostFlashReset(void)
+{
+  halHostFlash_t *pFlash = halHostFlashNode();
+
+  (void)memset(pFlash, 0, sizeof(halHostFlash_t) - HAL_HOST_FLASH_SIZE);
+  (void)memset(pFlash->image, 0xFF, HAL_HOST_FLASH_SIZE);
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashCut
+ *
+ * @brief       This function arms a simulated power cut in place of the flash step, word write
+ *              or page erase, that follows the next 'steps' ones; a HalFlashWrite() of several
+ *              words can be cut between any two of them. Stepping through every count from 0
+ *              in a fork()ed child, until one runs to completion, visits every point at which
+ *              the power can fail.
+ *
+ * input parameters
+ *
+ * @param       steps - Count of steps to let through, HAL_HOST_FLASH_NO_CUT to disarm.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halHostFlashCut(uint32 steps)
+{
+  halHostFlashCutCnt = steps;
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashWrites
+ *
+ * @brief       This function returns the count of words written to the selected flash.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Count of 4-byte words written since the last halHostFlashReset().
+ **************************************************************************************************
+ */
+uint32 halHostFlashWrites(void)
+{
+  return halHostFlashNode()->writes;
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashErases
+ *
+ * @brief       This function returns the count of erases of a page of the selected flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid flash page number.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Count of erases since the last halHostFlashReset().
+ **************************************************************************************************
+ */
+uint32 halHostFlashErases(uint8 pg)
+{
+  return halHostFlashNode()->erases[pg];
+}
+
+/**************************************************************************************************
+ * @fn          halHostFlashCalls
+ *
+ * @brief       This function returns the counts of HalFlashRead() and HalFlashWrite() calls on
+ *              the selected flash, each of which costs a setup (and a DMA transfer for a write)
+ *              on the target, whatever its length.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * @param       pReads - Count of HalFlashRead() calls since the last halHostFlashReset().
+ * @param       pWrites - Count of HalFlashWrite() calls since the last halHostFlashReset().
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halHostFlashCalls(uint32 *pReads, uint32 *pWrites)
+{
+  halHostFlash_t *pFlash = halHostFlashNode();
+
+  *pReads = pFlash->readCalls;
+  *pWrites = pFlash->writeCalls;
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashRead
+ *
+ * @brief       This function reads 'cnt' bytes from the internal flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid flash page number.
+ * @param       offset - A valid offset into the page.
+ * @param       buf - A valid buffer space at least as big as the 'cnt' parameter.
+ * @param       cnt - A valid number of bytes to read.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt)
+{
+  halHostFlash_t *pFlash = halHostFlashNode();
+  const uint8 *pData = pFlash->image + ((uint32)pg * HAL_FLASH_PAGE_SIZE) + offset;
+
+  pFlash->readCalls++;
+
+  while (cnt--)
+  {
+    *buf++ = *pData++;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashWrite
+ *
+ * @brief       This function writes 'cnt' bytes to the internal flash.
+ *              Like the real flash controller, a write can only clear bits, so writing a word
+ *              that is not erased leaves the AND of the old and new values.
+ *
+ * input parameters
+ *
+ * @param       addr - Valid HAL flash write address: actual addr / 4 and quad-aligned.
+ * @param       buf - Valid buffer space at least as big as 'cnt' X 4.
+ * @param       cnt - Number of 4-byte blocks to write.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt)
+{
+  halHostFlash_t *pFlash = halHostFlashNode();
+  uint8 *pData = pFlash->image + ((uint32)addr * HAL_FLASH_WORD_SIZE);
+
+  pFlash->writeCalls++;
+
+  while (cnt--)
+  {
+    uint8 len = HAL_FLASH_WORD_SIZE;
+
+    halHostFlashStep();
+    pFlash->writes++;
+
+    while (len--)
+    {
+      *pData++ &= *buf++;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashErase
+ *
+ * @brief       This function erases the specified page of the internal flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid flash page number to erase.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashErase(uint8 pg)
+{
+  halHostFlash_t *pFlash = halHostFlashNode();
+
+  halHostFlashStep();
+  pFlash->erases[pg]++;
+
+  (void)memset(pFlash->image + ((uint32)pg * HAL_FLASH_PAGE_SIZE), 0xFF, HAL_FLASH_PAGE_SIZE);
+}
+
+/**************************************************************************************************
+*/
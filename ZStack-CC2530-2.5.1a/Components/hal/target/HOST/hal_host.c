@@ -0,0 +1,387 @@
+/**************************************************************************************************
+  Filename:       hal_host.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Clock, reset and driver stubs for the POSIX host simulation.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal_adc.h"
+#include "hal_assert.h"
+#include "hal_board_cfg.h"
+#include "hal_drivers.h"
+#include "hal_mcu.h"
+#include "hal_sleep.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// Period of the MAC backoff timer that osalTimeUpdate() converts to milliseconds.
+#define HAL_HOST_BACKOFF_US        320
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Global Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+volatile uint8 halHostIntEnable = 1;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if HAL_HOST_VIRTUAL_CLOCK
+static unsigned long long halHostClockVirt = 0;
+#else
+static struct timespec halHostClockBase;
+static uint8 halHostClockInit = FALSE;
+#endif
+
+#if HAL_HOST_NODE_CNT > 1
+/* Bounds of the RAM that each simulated node has its own copy of: the .data and .bss of
+ * OSAL, OSAL NV, the board, ZMAC and the node's tasks, which the linker script of the
+ * simulation build (Projects/zstack/HOST/Sim/sim_nodes.ld) gathers in one place.
+ */
+extern uint8 __hal_host_node_start[];
+extern uint8 __hal_host_node_end[];
+
+// The saved RAM of each node, allocated on the first selection.
+static uint8 *halHostNodeRam[HAL_HOST_NODE_CNT];
+static uint8 halHostNodeIdx = 0;
+#endif
+
+/**************************************************************************************************
+ * @fn          halHostClockUs
+ *
+ * @brief       This function returns the microseconds elapsed on CLOCK_MONOTONIC since it was
+ *              first called, or the virtual clock in simulation mode, truncated to 32 bits.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Elapsed microseconds, wrapping after 71.6 minutes.
+ **************************************************************************************************
+ */
+uint32 halHostClockUs(void)
+{
+  return (uint32)halHostClockUs64();
+}
+
+/**************************************************************************************************
+ * @fn          halHostClockUs64
+ *
+ * @brief       This function returns the microseconds elapsed on CLOCK_MONOTONIC since it was
+ *              first called, or the virtual clock in simulation mode, without wrapping, for the
+ *              counters derived from it.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Elapsed microseconds.
+ **************************************************************************************************
+ */
+unsigned long long halHostClockUs64(void)
+{
+#if HAL_HOST_VIRTUAL_CLOCK
+  return halHostClockVirt;
+#else
+  struct timespec now;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+  if (!halHostClockInit)
+  {
+    halHostClockBase = now;
+    halHostClockInit = TRUE;
+  }
+
+  return (((unsigned long long)(now.tv_sec - halHostClockBase.tv_sec) * 1000000) +
+          ((now.tv_nsec - halHostClockBase.tv_nsec) / 1000));
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          halHostClockAdvance
+ *
+ * @brief       This function moves the virtual clock forward. A simulation harness calls it to
+ *              step every node to the time of its next event; the real clock ignores it.
+ *
+ * input parameters
+ *
+ * @param       us - Microseconds to advance.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halHostClockAdvance(uint32 us)
+{
+#if HAL_HOST_VIRTUAL_CLOCK
+  halHostClockVirt += us;
+#else
+  (void)us;
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          halHostNodeSelect
+ *
+ * @brief       This function makes a node of a simulated network the one that runs: it saves the
+ *              RAM of the node that ran last and loads that of the new one, so that each node has
+ *              its own task events, heap, timers and NV state, and selects the node's flash. On
+ *              the first call every node is given the RAM as it is then, before any init.
+ *
+ * input parameters
+ *
+ * @param       node - Index of the node, less than HAL_HOST_NODE_CNT.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halHostNodeSelect(uint8 node)
+{
+#if HAL_HOST_NODE_CNT > 1
+  size_t len = (size_t)(__hal_host_node_end - __hal_host_node_start);
+  uint8 idx;
+
+  if (node >= HAL_HOST_NODE_CNT)
+  {
+    return;
+  }
+
+  if (halHostNodeRam[0] == NULL)
+  {
+    for (idx = 0; idx < HAL_HOST_NODE_CNT; idx++)
+    {
+      if ((halHostNodeRam[idx] = malloc(len)) == NULL)
+      {
+        abort();
+      }
+      (void)memcpy(halHostNodeRam[idx], __hal_host_node_start, len);
+    }
+  }
+
+  if (node != halHostNodeIdx)
+  {
+    (void)memcpy(halHostNodeRam[halHostNodeIdx], __hal_host_node_start, len);
+    (void)memcpy(__hal_host_node_start, halHostNodeRam[node], len);
+    halHostNodeIdx = node;
+  }
+#endif
+
+  halHostFlashSelect(node);
+}
+
+/**************************************************************************************************
+ * @fn          macMcuPrecisionCount
+ *
+ * @brief       This function stands in for the MAC backoff timer that drives osalTimeUpdate():
+ *              a free running count of 320 usec ticks. It is taken from the 64-bit clock, so
+ *              that it wraps at 2^32 ticks like the target counter does, not when the
+ *              microsecond count does.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Count of 320 usec ticks.
+ **************************************************************************************************
+ */
+uint32 macMcuPrecisionCount(void)
+{
+  return (uint32)(halHostClockUs64() / HAL_HOST_BACKOFF_US);
+}
+
+/**************************************************************************************************
+ * @fn          halHostReset
+ *
+ * @brief       This function simulates the watchdog reset of HAL_SYSTEM_RESET() by ending the
+ *              process; a harness that needs to survive resets should run the stack in a child.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Does not return.
+ **************************************************************************************************
+ */
+void halHostReset(void)
+{
+  exit(EXIT_FAILURE);
+}
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       This function replaces the hazard lights of hal_assert.c, which spin forever on
+ *              the target, with an abort() so that a failed HAL_ASSERT ends the process with a core.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Does not return.
+ **************************************************************************************************
+ */
+void halAssertHandler(void)
+{
+  abort();
+}
+
+/**************************************************************************************************
+ * @fn          Hal_ProcessPoll
+ *
+ * @brief       This function is called by OSAL to poll the H/W drivers; none are simulated.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          HalAdcCheckVdd
+ *
+ * @brief       This function is used by OSAL NV to check the supply before writing to flash;
+ *              the host supply is always good.
+ *
+ * input parameters
+ *
+ * @param       vdd - The board-specific Vdd reading to check for.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE.
+ **************************************************************************************************
+ */
+bool HalAdcCheckVdd(uint8 vdd)
+{
+  (void)vdd;
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn          halSleep
+ *
+ * @brief       This function puts the process to sleep until the next OSAL timer expires, as the
+ *              CC2530 would sleep in PM2 (only used with POWER_SAVING). With the virtual clock
+ *              the sleep is skipped and time jumps straight to the timeout.
+ *
+ * input parameters
+ *
+ * @param       osal_timeout - Next OSAL timer timeout in msec, 0 if no timer is running.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSleep(uint16 osal_timeout)
+{
+#if !HAL_HOST_VIRTUAL_CLOCK
+  struct timespec req;
+#endif
+
+  if (osal_timeout == 0)
+  {
+    osal_timeout = 1;  // Nothing but the caller can raise an event, just yield briefly.
+  }
+
+#if HAL_HOST_VIRTUAL_CLOCK
+  halHostClockAdvance((uint32)osal_timeout * 1000);
+#else
+  req.tv_sec = osal_timeout / 1000;
+  req.tv_nsec = (long)(osal_timeout % 1000) * 1000000L;
+  (void)nanosleep(&req, NULL);
+#endif
+}
+
+/**************************************************************************************************
+*/
@@ -0,0 +1,181 @@
+/**************************************************************************************************
+  Filename:       hal_mcu.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Simulated MCU abstraction for running OSAL as a POSIX process.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef _HAL_MCU_H
+#define _HAL_MCU_H
+
+/*
+ *  Target : POSIX host simulation of the CC2530
+ *
+ *  Lets the portable OSAL sources (scheduler, timers, heap, messages and NV) build and run
+ *  as an ordinary Linux process. There are no interrupts: the critical section is a flag
+ *  that is only ever touched by the single thread running osal_run_system().
+ *
+ *  Sources: the C files of osal/common and hal/target/HOST, osal/mcu/cc2530/OSAL_Nv.c and
+ *           Projects/zstack/ZMain/HOST/OnBoard.c, plus the application's osalInitTasks().
+ *  Include: hal/target/HOST, hal/include, osal/include, services/saddr and
+ *           Projects/zstack/ZMain/HOST, ahead of any other target directory.
+ *  Build:   Projects/zstack/HOST/CMakeLists.txt builds these as static libraries, with the
+ *           defines of the CC2530DB f8w*.cfg files, and the benchmarks and checks in ctest.
+ *
+ *  Simulation: with HAL_HOST_VIRTUAL_CLOCK the harness sets halHostRandSeed, then calls
+ *           osal_run_system() itself and halHostClockAdvance() up to the next event, so a
+ *           run replays exactly. With HAL_HOST_NODE_CNT above 1, and the sim_nodes.ld
+ *           linker script, halHostNodeSelect() swaps in the RAM of one of many nodes, each
+ *           with its own tasks, heap, timers and NV image, that share the one clock.
+ *
+ *  Power fail: the flash images are shared with fork()ed children. For each count N from 0,
+ *           the harness forks a child that calls halHostFlashCut(N) and runs a workload,
+ *           until a child exits other than with HAL_HOST_CUT_EXIT; after each cut, a
+ *           second child runs osal_nv_init() on the image left and checks the items against
+ *           the harness's model. halHostFlashWrites() and halHostFlashErases() give the wear.
+ */
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+#include "hal_defs.h"
+#include "hal_types.h"
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Target Defines
+ * ------------------------------------------------------------------------------------------------
+ */
+#define HAL_MCU_HOST
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                     Compiler Abstraction
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* ---------------------- GNU Compiler ---------------------- */
+#if defined __GNUC__
+#define HAL_COMPILER_GCC
+#define HAL_MCU_LITTLE_ENDIAN()   (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define HAL_ISR_FUNC_DECLARATION(f,v)   void f(void)
+#define HAL_ISR_FUNC_PROTOTYPE(f,v)     void f(void)
+#define HAL_ISR_FUNCTION(f,v)           HAL_ISR_FUNC_PROTOTYPE(f,v); HAL_ISR_FUNC_DECLARATION(f,v)
+
+/* ------------------ Unrecognized Compiler ------------------ */
+#else
+#error "ERROR: Unknown compiler."
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Interrupt Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+extern volatile uint8 halHostIntEnable;   /* Simulated EA bit */
+
+#define HAL_ENABLE_INTERRUPTS()         st( halHostIntEnable = 1; )
+#define HAL_DISABLE_INTERRUPTS()        st( halHostIntEnable = 0; )
+#define HAL_INTERRUPTS_ARE_ENABLED()    (halHostIntEnable)
+
+typedef unsigned char halIntState_t;
+#define HAL_ENTER_CRITICAL_SECTION(x)   st( x = halHostIntEnable;  HAL_DISABLE_INTERRUPTS(); )
+#define HAL_EXIT_CRITICAL_SECTION(x)    st( halHostIntEnable = x; )
+#define HAL_CRITICAL_STATEMENT(x)       st( halIntState_t _s; HAL_ENTER_CRITICAL_SECTION(_s); x; HAL_EXIT_CRITICAL_SECTION(_s); )
+
+#define HAL_ENTER_ISR()
+#define HAL_EXIT_ISR()
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Reset Macro
+ * ------------------------------------------------------------------------------------------------
+ */
+extern void halHostReset(void);
+
+#define WD_KICK()
+#define HAL_SYSTEM_RESET()  st( HAL_DISABLE_INTERRUPTS(); halHostReset(); )
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Sleep Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+#define CLEAR_SLEEP_MODE()
+#define ALLOW_SLEEP_MODE()
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Host Simulation
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Microseconds elapsed since the first call, on CLOCK_MONOTONIC or the virtual clock. */
+extern uint32 halHostClockUs(void);
+extern unsigned long long halHostClockUs64(void);
+
+/* Moves the virtual clock forward, ignored unless HAL_HOST_VIRTUAL_CLOCK is TRUE. */
+extern void halHostClockAdvance(uint32 us);
+
+/* Selects the flash image of a node, less than HAL_HOST_NODE_CNT. */
+extern void halHostFlashSelect(uint8 node);
+
+/* Selects the RAM and the flash image of a node, less than HAL_HOST_NODE_CNT. */
+extern void halHostNodeSelect(uint8 node);
+
+/* The RAM image backing HalFlashRead/Write/Erase, HAL_FLASH_PAGE_SIZE bytes per page. */
+extern uint8 *halHostFlashImage(void);
+
+/* Returns every page of the simulated flash to the erased (0xFF) state and clears its counters. */
+extern void halHostFlashReset(void);
+
+/* Exit status of a process ended by a simulated power cut. */
+#define HAL_HOST_CUT_EXIT        3
+
+/* halHostFlashCut() count that never cuts the power. */
+#define HAL_HOST_FLASH_NO_CUT    0xFFFFFFFFUL
+
+/* Cuts the power in place of the flash word write or page erase that follows 'steps' more. */
+extern void halHostFlashCut(uint32 steps);
+
+/* Wear of the selected flash: words written, and erases of a page. */
+extern uint32 halHostFlashWrites(void);
+extern uint32 halHostFlashErases(uint8 pg);
+
+/* Calls of HalFlashRead() and HalFlashWrite() on the selected flash. */
+extern void halHostFlashCalls(uint32 *pReads, uint32 *pWrites);
+
+/**************************************************************************************************
+ */
+#endif
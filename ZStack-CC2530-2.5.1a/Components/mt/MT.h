@@ -94,6 +94,8 @@ extern "C"
 #define MT_SYS_OSAL_NV_DELETE                0x12
 #define MT_SYS_OSAL_NV_LENGTH                0x13
 #define MT_SYS_SET_TX_POWER                  0x14
+#define MT_SYS_OSAL_NV_BOOT_STAT             0x15
+#define MT_SYS_OSAL_NV_HOT_STAT              0x16
 
 /* AREQ to host */
 #define MT_SYS_RESET_IND                     0x80
@@ -372,6 +374,10 @@ extern "C"
 #define MT_DEBUG_SET_THRESHOLD               0x00
 
 #define MT_DEBUG_MAC_DATA_DUMP               0x10
+#define MT_DEBUG_HEAP_SITES                  0x11
+#define MT_DEBUG_HEAP_SIZES                  0x12
+#define MT_DEBUG_TASK_PROF                   0x13
+#define MT_DEBUG_NV_WEAR                     0x14
 
 /* AREQ */
 #define MT_DEBUG_MSG                         0x80
@@ -50,6 +50,7 @@
 #include "mac_rx.h"
 #include "mac_tx.h"
 #include "nwk_globals.h"
+#include "OSAL_Nv.h"
 
 /***************************************************************************************************
  * LOCAL FUNCTIONs
@@ -58,6 +59,33 @@
 #if defined (MT_DEBUG_FUNC)
 static void MT_DebugSetThreshold(uint8 *pBuf);
 static void MT_DebugMacDataDump(void);
+#if OSALMEM_SITE_PROFILER
+static void MT_DebugHeapSites(uint8 *pBuf);
+static void MT_DebugHeapSizes(void);
+#endif
+#if OSAL_TASK_PROFILER
+static void MT_DebugTaskProf(uint8 *pBuf);
+#endif
+static void MT_DebugNvWear(void);
+#endif
+
+/***************************************************************************************************
+ * CONSTANTS
+ ***************************************************************************************************/
+
+#if defined (MT_DEBUG_FUNC) && OSALMEM_SITE_PROFILER
+/* Allocation sites reported per MT_DEBUG_HEAP_SITES response, and the number of trailing
+ * characters of each site's file name that are sent.
+ */
+#define MT_DEBUG_HEAP_SITES_MAX              6
+#define MT_DEBUG_HEAP_NAME_LEN               12
+#define MT_DEBUG_HEAP_SITE_LEN               (9 + MT_DEBUG_HEAP_NAME_LEN)
+#endif
+
+#if defined (MT_DEBUG_FUNC)
+// NV pages reported per MT_DEBUG_NV_WEAR response, and the bytes sent for each page.
+#define MT_DEBUG_NV_PAGES_MAX                8
+#define MT_DEBUG_NV_PAGE_LEN                 7
 #endif
 
 #if defined (MT_DEBUG_FUNC)
@@ -84,6 +112,26 @@ uint8 MT_DebugCommandProcessing(uint8 *pBuf)
       MT_DebugMacDataDump();
       break;
 
+#if OSALMEM_SITE_PROFILER
+    case MT_DEBUG_HEAP_SITES:
+      MT_DebugHeapSites(pBuf);
+      break;
+
+    case MT_DEBUG_HEAP_SIZES:
+      MT_DebugHeapSizes();
+      break;
+#endif
+
+#if OSAL_TASK_PROFILER
+    case MT_DEBUG_TASK_PROF:
+      MT_DebugTaskProf(pBuf);
+      break;
+#endif
+
+    case MT_DEBUG_NV_WEAR:
+      MT_DebugNvWear();
+      break;
+
     default:
       status = MT_RPC_ERR_COMMAND_ID;
       break;
@@ -162,6 +210,221 @@ static void MT_DebugMacDataDump(void)
   MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
                                        MT_DEBUG_MAC_DATA_DUMP, sizeof(buf), buf);
 }
+
+#if OSALMEM_SITE_PROFILER
+/***************************************************************************************************
+ * @fn      MT_DebugHeapSites
+ *
+ * @brief   Process the debug Heap Sites request: report the live bytes, peak bytes and
+ *          allocation count of up to MT_DEBUG_HEAP_SITES_MAX allocation sites, starting at
+ *          the requested site index.
+ *
+ * @param   pBuf - pointer to received buffer
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_DebugHeapSites(uint8 *pBuf)
+{
+  uint8 *pRsp;
+  uint8 *pOut;
+  uint8 startIdx;
+  uint8 siteCnt;
+  uint8 cnt = 0;
+
+  /* parse header */
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+  startIdx = *pBuf;
+
+  pRsp = osal_mem_alloc(4 + (MT_DEBUG_HEAP_SITES_MAX * MT_DEBUG_HEAP_SITE_LEN));
+  if (pRsp == NULL)
+  {
+    uint8 retValue = ZMemError;
+
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                                 MT_DEBUG_HEAP_SITES, 1, &retValue);
+    return;
+  }
+
+  siteCnt = osal_heap_site_cnt();
+  pOut = pRsp + 4;
+
+  while ((cnt < MT_DEBUG_HEAP_SITES_MAX) && ((uint8)(startIdx + cnt) < siteCnt))
+  {
+    osalMemSite_t site;
+    uint8 nameLen = 0;
+
+    (void)osal_heap_site_get(startIdx + cnt, &site);
+
+    *pOut++ = LO_UINT16(site.lnum);
+    *pOut++ = HI_UINT16(site.lnum);
+    *pOut++ = LO_UINT16(site.live);
+    *pOut++ = HI_UINT16(site.live);
+    *pOut++ = LO_UINT16(site.peak);
+    *pOut++ = HI_UINT16(site.peak);
+    *pOut++ = LO_UINT16(site.cnt);
+    *pOut++ = HI_UINT16(site.cnt);
+
+    if (site.fname != NULL)
+    {
+      /* Send the tail of the file name, which carries the base name. */
+      const char *pName = site.fname;
+      int len = osal_strlen((char *)pName);
+
+      if (len > MT_DEBUG_HEAP_NAME_LEN)
+      {
+        pName += (len - MT_DEBUG_HEAP_NAME_LEN);
+        len = MT_DEBUG_HEAP_NAME_LEN;
+      }
+      nameLen = (uint8)len;
+      *pOut++ = nameLen;
+      pOut = osal_memcpy(pOut, pName, nameLen);
+    }
+    else
+    {
+      *pOut++ = nameLen;
+    }
+
+    cnt++;
+  }
+
+  pRsp[0] = ZSuccess;
+  pRsp[1] = siteCnt;
+  pRsp[2] = startIdx;
+  pRsp[3] = cnt;
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                               MT_DEBUG_HEAP_SITES, (uint8)(pOut - pRsp), pRsp);
+
+  osal_mem_free(pRsp);
+}
+
+/***************************************************************************************************
+ * @fn      MT_DebugHeapSizes
+ *
+ * @brief   Process the debug Heap Sizes request: report the request size histogram.
+ *
+ * @param   void
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_DebugHeapSizes(void)
+{
+  uint8 buf[1 + (OSALMEM_SIZE_HIST_CNT * 2)];
+  uint8 *pBuf = buf;
+  uint8 idx;
+
+  *pBuf++ = ZSuccess;
+
+  for (idx = 0; idx < OSALMEM_SIZE_HIST_CNT; idx++)
+  {
+    uint16 cnt = osal_heap_size_hist(idx);
+
+    *pBuf++ = LO_UINT16(cnt);
+    *pBuf++ = HI_UINT16(cnt);
+  }
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                               MT_DEBUG_HEAP_SIZES, sizeof(buf), buf);
+}
+#endif /* OSALMEM_SITE_PROFILER */
+
+#if OSAL_TASK_PROFILER
+/***************************************************************************************************
+ * @fn      MT_DebugTaskProf
+ *
+ * @brief   Process the debug Task Profile request: report the queueing delay and handler
+ *          runtime histograms and worst cases of a task, in 320 usec ticks, and optionally
+ *          reset them.
+ *
+ * @param   pBuf - pointer to received buffer
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_DebugTaskProf(uint8 *pBuf)
+{
+  uint8 buf[2 + (OSAL_TASK_PROF_HIST_CNT * 4) + 16];
+  uint8 *pOut = buf;
+  osalTaskProf_t prof;
+  uint8 taskId;
+  uint8 idx;
+
+  /* parse header */
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+  taskId = pBuf[0];
+
+  *pOut++ = osal_task_prof_get(taskId, &prof, pBuf[1]);
+  *pOut++ = taskId;
+
+  if (buf[0] != SUCCESS)
+  {
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                                 MT_DEBUG_TASK_PROF, 2, buf);
+    return;
+  }
+
+  for (idx = 0; idx < OSAL_TASK_PROF_HIST_CNT; idx++)
+  {
+    *pOut++ = LO_UINT16(prof.queueHist[idx]);
+    *pOut++ = HI_UINT16(prof.queueHist[idx]);
+  }
+  for (idx = 0; idx < OSAL_TASK_PROF_HIST_CNT; idx++)
+  {
+    *pOut++ = LO_UINT16(prof.runHist[idx]);
+    *pOut++ = HI_UINT16(prof.runHist[idx]);
+  }
+
+  pOut = osal_buffer_uint32(pOut, prof.queueMax);
+  *pOut++ = LO_UINT16(prof.queueMaxEvt);
+  *pOut++ = HI_UINT16(prof.queueMaxEvt);
+  pOut = osal_buffer_uint32(pOut, prof.runMax);
+  *pOut++ = LO_UINT16(prof.runMaxEvt);
+  *pOut++ = HI_UINT16(prof.runMaxEvt);
+  pOut = osal_buffer_uint32(pOut, prof.runTotal);
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                               MT_DEBUG_TASK_PROF, sizeof(buf), buf);
+}
+#endif /* OSAL_TASK_PROFILER */
+
+/***************************************************************************************************
+ * @fn      MT_DebugNvWear
+ *
+ * @brief   Process the debug NV Wear request: report the erase count, the free bytes and the
+ *          bytes awaiting compaction of each NV page, and which page is the reserve page.
+ *
+ * @param   void
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_DebugNvWear(void)
+{
+  uint8 buf[2 + (MT_DEBUG_NV_PAGES_MAX * MT_DEBUG_NV_PAGE_LEN)];
+  uint8 *pOut = buf + 2;
+  osalNvPageStat_t stat;
+  uint8 idx;
+
+  for (idx = 0; idx < MT_DEBUG_NV_PAGES_MAX; idx++)
+  {
+    if (osal_nv_page_stat(idx, &stat) != SUCCESS)
+    {
+      break;
+    }
+
+    *pOut++ = LO_UINT16(stat.eraseCnt);
+    *pOut++ = HI_UINT16(stat.eraseCnt);
+    *pOut++ = LO_UINT16(stat.freeLen);
+    *pOut++ = HI_UINT16(stat.freeLen);
+    *pOut++ = LO_UINT16(stat.lostLen);
+    *pOut++ = HI_UINT16(stat.lostLen);
+    *pOut++ = stat.reserve;
+  }
+
+  buf[0] = ZSuccess;
+  buf[1] = idx;
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                               MT_DEBUG_NV_WEAR, (uint8)(pOut - buf), buf);
+}
 #endif
 
 /***************************************************************************************************
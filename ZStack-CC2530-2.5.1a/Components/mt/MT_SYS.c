@@ -111,6 +111,8 @@ void MT_SysGetExtAddr(void);
 void MT_SysOsalNVItemInit(uint8 *pBuf);
 void MT_SysOsalNVDelete(uint8 *pBuf);
 void MT_SysOsalNVLength(uint8 *pBuf);
+void MT_SysOsalNVBootStat(void);
+void MT_SysOsalNVHotStat(void);
 void MT_SysOsalNVRead(uint8 *pBuf);
 void MT_SysOsalNVWrite(uint8 *pBuf);
 void MT_SysOsalStartTimer(uint8 *pBuf);
@@ -185,6 +187,14 @@ uint8 MT_SysCommandProcessing(uint8 *pBuf)
     case MT_SYS_OSAL_NV_WRITE:
       MT_SysOsalNVWrite(pBuf);
       break;
+
+    case MT_SYS_OSAL_NV_BOOT_STAT:
+      MT_SysOsalNVBootStat();
+      break;
+
+    case MT_SYS_OSAL_NV_HOT_STAT:
+      MT_SysOsalNVHotStat();
+      break;
 #endif
 
     case MT_SYS_OSAL_START_TIMER:
@@ -608,6 +618,64 @@ void MT_SysOsalNVLength(uint8 *pBuf)
                                  MT_SYS_OSAL_NV_LENGTH, 2, rsp);
 }
 
+/***************************************************************************************************
+ * @fn      MT_SysOsalNVBootStat
+ *
+ * @brief   Report the cost of the NV initialization at the last boot: item data bytes read back
+ *          to verify checksums, item headers read, and page scans with and without the help of
+ *          a page summary.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysOsalNVBootStat(void)
+{
+  osalNvBootStat_t stat;
+  uint8 rsp[8];
+
+  osal_nv_boot_stat(&stat);
+
+  (void)osal_buffer_uint32(rsp, stat.chkBytes);
+  rsp[4] = LO_UINT16(stat.hdrCnt);
+  rsp[5] = HI_UINT16(stat.hdrCnt);
+  rsp[6] = stat.sumScans;
+  rsp[7] = stat.fullScans;
+
+  /* Build and send back the response */
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                 MT_SYS_OSAL_NV_BOOT_STAT, sizeof(rsp), rsp);
+}
+
+/***************************************************************************************************
+ * @fn      MT_SysOsalNVHotStat
+ *
+ * @brief   Report the NV item lookups answered by the hot item cache and those that missed it,
+ *          the entries it gave up to other items, and its size and occupancy.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysOsalNVHotStat(void)
+{
+  osalNvHotStat_t stat;
+  uint8 rsp[12];
+
+  osal_nv_hot_stat(&stat);
+
+  (void)osal_buffer_uint32(rsp, stat.hits);
+  (void)osal_buffer_uint32(rsp+4, stat.misses);
+  rsp[8] = LO_UINT16(stat.evicts);
+  rsp[9] = HI_UINT16(stat.evicts);
+  rsp[10] = stat.size;
+  rsp[11] = stat.used;
+
+  /* Build and send back the response */
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                 MT_SYS_OSAL_NV_HOT_STAT, sizeof(rsp), rsp);
+}
+
 /***************************************************************************************************
  * @fn      MT_SysOsalStartTimer
  *
@@ -49,6 +49,7 @@
 #include "OSAL.h"
 #include "OSAL_Tasks.h"
 #include "OSAL_Memory.h"
+#include "OSAL_Nv.h"
 #include "OSAL_PwrMgr.h"
 #include "OSAL_Clock.h"
 
@@ -66,21 +67,56 @@
  * MACROS
  */
 
+// Ready-task bitmap, one bit per task in priority order
+#define OSAL_READY_SET( idx )  (osalReadyMap[(idx) >> 3] |= BV( (idx) & 0x07 ))
+#define OSAL_READY_CLR( idx )  (osalReadyMap[(idx) >> 3] &= ~BV( (idx) & 0x07 ))
+
 /*********************************************************************
  * CONSTANTS
  */
 
+/* Bounded fairness for osal_run_system().
+ * 0 - strict priority: the first ready task in tasksArr[] always runs.
+ * N - after N consecutive dispatches during which a lower priority task
+ *     was kept waiting, the next dispatch goes round-robin to the ready
+ *     task following the last one picked this way, so tasks such as MT
+ *     or the application still run while NWK/MAC are busy.
+ */
+#if !defined OSAL_FAIRNESS_LIMIT
+#define OSAL_FAIRNESS_LIMIT  0
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+// Prefix of a shared buffer from osal_ref_alloc()
+typedef union
+{
+  halDataAlign_t alignDummy;
+  uint8 cnt;            // Number of references held
+} osalRefHdr_t;
+
+// Prefix of a message from osal_msg_allocate_ref(), ahead of its osal_msg_hdr_t
+typedef union
+{
+  halDataAlign_t alignDummy;
+  void *ref_ptr;        // Shared buffer the message holds a reference on
+} osalMsgRefHdr_t;
+
+// Per-task message FIFO
+typedef struct
+{
+  osal_msg_q_t head;
+  osal_msg_q_t tail;
+  uint16 cnt;          // Messages currently queued
+  uint16 maxCnt;       // High-water mark of cnt
+} osalTaskQ_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
 
-// Message Pool Definitions
-osal_msg_q_t osal_qHead;
-
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -89,6 +125,10 @@ osal_msg_q_t osal_qHead;
  * EXTERNAL FUNCTIONS
  */
 
+#if OSAL_TASK_PROFILER
+extern uint32 macMcuPrecisionCount(void);
+#endif
+
 /*********************************************************************
  * LOCAL VARIABLES
  */
@@ -96,10 +136,38 @@ osal_msg_q_t osal_qHead;
 // Index of active task
 static uint8 activeTaskID = TASK_NO_TASK;
 
+// Message queues, one per task (tasksCnt entries)
+static osalTaskQ_t *osalTaskQ;
+
+// Bitmap of tasks with pending events, kept by osal_set_event()/osal_clear_event()
+static uint8 *osalReadyMap;
+static uint8 osalReadyBytes;
+
+// Lowest set bit of a nibble
+static const uint8 CODE osalFfsTbl[16] = {
+  0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0
+};
+
+#if OSAL_FAIRNESS_LIMIT
+static uint8 osalFairCnt;                // Dispatches that passed over a ready task
+static uint8 osalFairIdx = TASK_NO_TASK; // Task picked by the last fair dispatch
+#endif
+
+#if OSAL_TASK_PROFILER
+static osalTaskProf_t *osalTaskProf;    // Profile of each task (tasksCnt entries)
+static uint32 *osalReadyStamp;          // When each task last became ready
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
 
+static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 push );
+static uint8 osal_ready_find( uint8 idx );
+#if OSAL_TASK_PROFILER
+static void osal_task_prof_hist( uint16 *pHist, uint32 ticks );
+#endif
+
 /*********************************************************************
  * HELPER FUNCTIONS
  */
@@ -318,9 +386,9 @@ uint32 osal_build_uint32( uint8 *swapped, uint8 len )
  *
  * @return  pointer to buffer
  */
-unsigned char * _ltoa(unsigned long l, unsigned char *buf, unsigned char radix)
+unsigned char * _ltoa(uint32 l, unsigned char *buf, unsigned char radix)
 {
-#if defined( __GNUC__ )
+#if defined( __GNUC__ ) && !defined( HAL_MCU_HOST )
   return ( (char*)ltoa( l, buf, radix ) );
 #else
   unsigned char tmp1[10] = "", tmp2[10] = "", tmp3[10] = "";
@@ -467,11 +535,141 @@ uint8 osal_msg_deallocate( uint8 *msg_ptr )
 
   x = (uint8 *)((uint8 *)msg_ptr - sizeof( osal_msg_hdr_t ));
 
+  if ( ((osal_msg_hdr_t *)x)->len & OSAL_MSG_LEN_REF )
+  {
+    // Drop the message's reference on its shared buffer
+    osalMsgRefHdr_t *ref = (osalMsgRefHdr_t *)x - 1;
+
+    osal_ref_release( ref->ref_ptr );
+    x = (uint8 *)ref;
+  }
+
   osal_mem_free( (void *)x );
 
   return ( SUCCESS );
 }
 
+/*********************************************************************
+ * @fn      osal_msg_allocate_ref
+ *
+ * @brief
+ *
+ *    This function allocates a message buffer that holds a reference
+ *    on a shared buffer from osal_ref_alloc(). It is used to deliver
+ *    one read-only payload to several tasks without copying it: each
+ *    task gets its own message pointing at the shared buffer, and the
+ *    reference is dropped by osal_msg_deallocate().
+ *
+ * @param   uint16 len - wanted message length (not including the
+ *                       shared buffer)
+ * @param   void *ref_ptr - shared buffer from osal_ref_alloc()
+ *
+ * @return  pointer to allocated buffer or NULL if allocation failed.
+ */
+uint8 * osal_msg_allocate_ref( uint16 len, void *ref_ptr )
+{
+  osalMsgRefHdr_t *ref;
+  osal_msg_hdr_t *hdr;
+
+  if ( (len == 0) || (len & OSAL_MSG_LEN_REF) || (ref_ptr == NULL) )
+    return ( NULL );
+
+  ref = (osalMsgRefHdr_t *) osal_mem_alloc( (short)(len + sizeof( osalMsgRefHdr_t ) +
+                                                    sizeof( osal_msg_hdr_t )) );
+  if ( ref )
+  {
+    osal_ref_add( ref_ptr );
+    ref->ref_ptr = ref_ptr;
+
+    hdr = (osal_msg_hdr_t *)(ref + 1);
+    hdr->next = NULL;
+    hdr->len = len | OSAL_MSG_LEN_REF;
+    hdr->dest_id = TASK_NO_TASK;
+    return ( (uint8 *) (hdr + 1) );
+  }
+  else
+    return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      osal_ref_alloc
+ *
+ * @brief
+ *
+ *    This function allocates a reference-counted buffer. The caller
+ *    holds the first reference and must drop it with osal_ref_release()
+ *    once it has handed the buffer out with osal_msg_allocate_ref().
+ *    The contents must not be changed once the buffer is shared.
+ *
+ * @param   uint16 len - wanted buffer length
+ *
+ * @return  pointer to allocated buffer or NULL if allocation failed.
+ */
+void *osal_ref_alloc( uint16 len )
+{
+  osalRefHdr_t *hdr;
+
+  if ( len == 0 )
+    return ( NULL );
+
+  hdr = (osalRefHdr_t *) osal_mem_alloc( (short)(len + sizeof( osalRefHdr_t )) );
+  if ( hdr )
+  {
+    hdr->cnt = 1;
+    return ( (void *) (hdr + 1) );
+  }
+  else
+    return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      osal_ref_add
+ *
+ * @brief
+ *
+ *    This function takes another reference on a shared buffer.
+ *
+ * @param   void *ref_ptr - shared buffer from osal_ref_alloc()
+ *
+ * @return  none
+ */
+void osal_ref_add( void *ref_ptr )
+{
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+  ((osalRefHdr_t *)ref_ptr - 1)->cnt++;
+  HAL_EXIT_CRITICAL_SECTION(intState);   // Release interrupts.
+}
+
+/*********************************************************************
+ * @fn      osal_ref_release
+ *
+ * @brief
+ *
+ *    This function drops a reference on a shared buffer and frees the
+ *    buffer when the last reference is gone.
+ *
+ * @param   void *ref_ptr - shared buffer from osal_ref_alloc()
+ *
+ * @return  none
+ */
+void osal_ref_release( void *ref_ptr )
+{
+  osalRefHdr_t *hdr = (osalRefHdr_t *)ref_ptr - 1;
+  halIntState_t intState;
+  uint8 cnt;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+  cnt = --hdr->cnt;
+  HAL_EXIT_CRITICAL_SECTION(intState);   // Release interrupts.
+
+  if ( cnt == 0 )
+  {
+    osal_mem_free( (void *)hdr );
+  }
+}
+
 /*********************************************************************
  * @fn      osal_msg_send
  *
@@ -486,12 +684,53 @@ uint8 osal_msg_deallocate( uint8 *msg_ptr )
  *
  * @param   uint8 destination task - Send msg to?  Task ID
  * @param   uint8 *msg_ptr - pointer to new message buffer
- * @param   uint8 len - length of data in message
  *
  * @return  SUCCESS, INVALID_TASK, INVALID_MSG_POINTER
  */
 uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
 {
+  return ( osal_msg_enqueue_push( destination_task, msg_ptr, FALSE ) );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_push_front
+ *
+ * @brief
+ *
+ *    This function is called by a task to push a command message
+ *    to the head of another task's message queue, so that it is
+ *    received before any message already waiting for that task.
+ *    Otherwise it behaves like osal_msg_send().
+ *
+ * @param   uint8 destination task - Send msg to?  Task ID
+ * @param   uint8 *msg_ptr - pointer to new message buffer
+ *
+ * @return  SUCCESS, INVALID_TASK, INVALID_MSG_POINTER
+ */
+uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr )
+{
+  return ( osal_msg_enqueue_push( destination_task, msg_ptr, TRUE ) );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_enqueue_push
+ *
+ * @brief
+ *
+ *    This function queues a message on the destination task's FIFO,
+ *    at the tail or at the head, and sets the message ready event.
+ *
+ * @param   uint8 destination task - Send msg to?  Task ID
+ * @param   uint8 *msg_ptr - pointer to new message buffer
+ * @param   uint8 push - TRUE to queue at the head, FALSE at the tail
+ *
+ * @return  SUCCESS, INVALID_TASK, INVALID_MSG_POINTER
+ */
+static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 push )
+{
+  osalTaskQ_t *taskQ;
+  halIntState_t intState;
+
   if ( msg_ptr == NULL )
     return ( INVALID_MSG_POINTER );
 
@@ -511,12 +750,39 @@ uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
 
   OSAL_MSG_ID( msg_ptr ) = destination_task;
 
+  taskQ = &osalTaskQ[destination_task];
+
+  // Hold off interrupts
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
   // queue message
-  osal_msg_enqueue( &osal_qHead, msg_ptr );
+  if ( taskQ->head == NULL )
+  {
+    taskQ->head = msg_ptr;
+    taskQ->tail = msg_ptr;
+  }
+  else if ( push )
+  {
+    OSAL_MSG_NEXT( msg_ptr ) = taskQ->head;
+    taskQ->head = msg_ptr;
+  }
+  else
+  {
+    OSAL_MSG_NEXT( taskQ->tail ) = msg_ptr;
+    taskQ->tail = msg_ptr;
+  }
+
+  if ( ++taskQ->cnt > taskQ->maxCnt )
+  {
+    taskQ->maxCnt = taskQ->cnt;
+  }
 
   // Signal the task that a message is waiting
   osal_set_event( destination_task, SYS_EVENT_MSG );
 
+  // Release interrupts
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
   return ( SUCCESS );
 }
 
@@ -535,42 +801,34 @@ uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
  */
 uint8 *osal_msg_receive( uint8 task_id )
 {
-  osal_msg_hdr_t *listHdr;
-  osal_msg_hdr_t *prevHdr = NULL;
-  osal_msg_hdr_t *foundHdr = NULL;
+  osalTaskQ_t    *taskQ;
+  osal_msg_hdr_t *foundHdr;
   halIntState_t   intState;
 
+  if ( task_id >= tasksCnt )
+  {
+    return ( NULL );
+  }
+
+  taskQ = &osalTaskQ[task_id];
+
   // Hold off interrupts
   HAL_ENTER_CRITICAL_SECTION(intState);
 
-  // Point to the top of the queue
-  listHdr = osal_qHead;
+  // Take the oldest message for this task
+  foundHdr = taskQ->head;
 
-  // Look through the queue for a message that belongs to the asking task
-  while ( listHdr != NULL )
+  if ( foundHdr != NULL )
   {
-    if ( (listHdr - 1)->dest_id == task_id )
-    {
-      if ( foundHdr == NULL )
-      {
-        // Save the first one
-        foundHdr = listHdr;
-      }
-      else
-      {
-        // Second msg found, stop looking
-        break;
-      }
-    }
-    if ( foundHdr == NULL )
-    {
-      prevHdr = listHdr;
-    }
-    listHdr = OSAL_MSG_NEXT( listHdr );
+    taskQ->head = OSAL_MSG_NEXT( foundHdr );
+    taskQ->cnt--;
+
+    OSAL_MSG_NEXT( foundHdr ) = NULL;
+    OSAL_MSG_ID( foundHdr ) = TASK_NO_TASK;
   }
 
-  // Is there more than one?
-  if ( listHdr != NULL )
+  // Is there another one?
+  if ( taskQ->head != NULL )
   {
     // Yes, Signal the task that a message is waiting
     osal_set_event( task_id, SYS_EVENT_MSG );
@@ -578,16 +836,10 @@ uint8 *osal_msg_receive( uint8 task_id )
   else
   {
     // No more
+    taskQ->tail = NULL;
     osal_clear_event( task_id, SYS_EVENT_MSG );
   }
 
-  // Did we find a message?
-  if ( foundHdr != NULL )
-  {
-    // Take out of the link list
-    osal_msg_extract( &osal_qHead, foundHdr, prevHdr );
-  }
-
   // Release interrupts
   HAL_EXIT_CRITICAL_SECTION(intState);
 
@@ -617,14 +869,19 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
   osal_msg_hdr_t *pHdr;
   halIntState_t intState;
 
+  if (task_id >= tasksCnt)
+  {
+    return NULL;
+  }
+
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
-  pHdr = osal_qHead;  // Point to the top of the queue.
+  pHdr = osalTaskQ[task_id].head;  // Point to the top of the task's queue.
 
-  // Look through the queue for a message that matches the task_id and event parameters.
+  // Look through the queue for a message that matches the event parameter.
   while (pHdr != NULL)
   {
-    if (((pHdr-1)->dest_id == task_id) && (((osal_event_hdr_t *)pHdr)->event == event))
+    if (((osal_event_hdr_t *)pHdr)->event == event)
     {
       break;
     }
@@ -637,6 +894,56 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
   return (osal_event_hdr_t *)pHdr;
 }
 
+/*********************************************************************
+ * @fn      osal_msg_q_count
+ *
+ * @brief
+ *
+ *    This function returns the number of messages waiting for a task.
+ *
+ * @param   uint8 task_id - task ID
+ *
+ * @return  number of queued messages, 0 for an invalid task
+ */
+uint16 osal_msg_q_count( uint8 task_id )
+{
+  return ( (task_id < tasksCnt) ? osalTaskQ[task_id].cnt : 0 );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_q_max
+ *
+ * @brief
+ *
+ *    This function returns the largest number of messages that have
+ *    been waiting for a task at once (queue depth high-water mark).
+ *
+ * @param   uint8 task_id - task ID
+ * @param   uint8 reset - TRUE to restart the high-water mark from the
+ *                        current queue depth
+ *
+ * @return  high-water mark, 0 for an invalid task
+ */
+uint16 osal_msg_q_max( uint8 task_id, uint8 reset )
+{
+  uint16 maxCnt = 0;
+
+  if ( task_id < tasksCnt )
+  {
+    halIntState_t intState;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+    maxCnt = osalTaskQ[task_id].maxCnt;
+    if ( reset )
+    {
+      osalTaskQ[task_id].maxCnt = osalTaskQ[task_id].cnt;
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState);  // Release interrupts.
+  }
+
+  return ( maxCnt );
+}
+
 /*********************************************************************
  * @fn      osal_msg_enqueue
  *
@@ -849,7 +1156,17 @@ uint8 osal_set_event( uint8 task_id, uint16 event_flag )
   {
     halIntState_t   intState;
     HAL_ENTER_CRITICAL_SECTION(intState);    // Hold off interrupts
+#if OSAL_TASK_PROFILER
+    if ( (tasksEvents[task_id] == 0) && event_flag )
+    {
+      osalReadyStamp[task_id] = macMcuPrecisionCount();
+    }
+#endif
     tasksEvents[task_id] |= event_flag;  // Stuff the event bit(s)
+    if ( event_flag )
+    {
+      OSAL_READY_SET( task_id );
+    }
     HAL_EXIT_CRITICAL_SECTION(intState);     // Release interrupts
     return ( SUCCESS );
   }
@@ -879,6 +1196,10 @@ uint8 osal_clear_event( uint8 task_id, uint16 event_flag )
     halIntState_t   intState;
     HAL_ENTER_CRITICAL_SECTION(intState);    // Hold off interrupts
     tasksEvents[task_id] &= ~(event_flag);   // Clear the event bit(s)
+    if ( tasksEvents[task_id] == 0 )
+    {
+      OSAL_READY_CLR( task_id );
+    }
     HAL_EXIT_CRITICAL_SECTION(intState);     // Release interrupts
     return ( SUCCESS );
   }
@@ -987,8 +1308,22 @@ uint8 osal_init_system( void )
   // Initialize the Memory Allocation System
   osal_mem_init();
 
-  // Initialize the message queue
-  osal_qHead = NULL;
+  // Initialize the message queues
+  osalTaskQ = osal_mem_alloc( sizeof( osalTaskQ_t ) * tasksCnt );
+  osal_memset( osalTaskQ, 0, sizeof( osalTaskQ_t ) * tasksCnt );
+
+  // Initialize the ready-task bitmap
+  osalReadyBytes = (tasksCnt + 7) >> 3;
+  osalReadyMap = osal_mem_alloc( osalReadyBytes );
+  osal_memset( osalReadyMap, 0, osalReadyBytes );
+
+#if OSAL_TASK_PROFILER
+  // Initialize the task profiles
+  osalTaskProf = osal_mem_alloc( sizeof( osalTaskProf_t ) * tasksCnt );
+  osal_memset( osalTaskProf, 0, sizeof( osalTaskProf_t ) * tasksCnt );
+  osalReadyStamp = osal_mem_alloc( sizeof( uint32 ) * tasksCnt );
+  osal_memset( osalReadyStamp, 0, sizeof( uint32 ) * tasksCnt );
+#endif
 
   // Initialize the timers
   osalTimerInit();
@@ -1027,15 +1362,59 @@ void osal_start_system( void )
   }
 }
 
+/*********************************************************************
+ * @fn      osal_ready_find
+ *
+ * @brief
+ *
+ *   Find the first task, at or after idx, whose bit is set in the
+ *   ready-task bitmap.
+ *
+ * @param   uint8 idx - task index to start from
+ *
+ * @return  task index, or tasksCnt if none is ready
+ */
+static uint8 osal_ready_find( uint8 idx )
+{
+  uint8 byte = idx >> 3;
+  uint8 bits;
+
+  if ( idx >= tasksCnt )
+  {
+    return ( tasksCnt );
+  }
+
+  bits = osalReadyMap[byte] & (uint8)(0xFF << (idx & 0x07));
+
+  while ( bits == 0 )
+  {
+    if ( ++byte >= osalReadyBytes )
+    {
+      return ( tasksCnt );
+    }
+    bits = osalReadyMap[byte];
+  }
+
+  idx = byte << 3;
+  if ( (bits & 0x0F) == 0 )
+  {
+    bits >>= 4;
+    idx += 4;
+  }
+
+  return ( idx + osalFfsTbl[bits & 0x0F] );
+}
+
 /*********************************************************************
  * @fn      osal_run_system
  *
  * @brief
  *
- *   This function will make one pass through the OSAL taskEvents table
- *   and call the task_event_processor() function for the first task that
- *   is found with at least one event pending. If there are no pending
- *   events (all tasks), this function puts the processor into Sleep.
+ *   This function will look up the ready-task bitmap and call the
+ *   task_event_processor() function for the highest priority task
+ *   with at least one event pending (see OSAL_FAIRNESS_LIMIT for the
+ *   exception). If there are no pending events (all tasks), this
+ *   function puts the processor into Sleep.
  *
  * @param   void
  *
@@ -1043,17 +1422,37 @@ void osal_start_system( void )
  */
 void osal_run_system( void )
 {
-  uint8 idx = 0;
+  uint8 idx;
 
   osalTimeUpdate();
   Hal_ProcessPoll();
 
-  do {
-    if (tasksEvents[idx])  // Task is highest priority that is ready.
+  idx = osal_ready_find( 0 );  // Task is highest priority that is ready.
+
+#if OSAL_FAIRNESS_LIMIT
+  if ( idx < tasksCnt )
+  {
+    if ( osal_ready_find( idx + 1 ) == tasksCnt )
     {
-      break;
+      // Nobody else is waiting
+      osalFairCnt = 0;
     }
-  } while (++idx < tasksCnt);
+    else if ( ++osalFairCnt > OSAL_FAIRNESS_LIMIT )
+    {
+      // Round-robin to the next ready task after the last fair pick, passing over
+      // the one that strict priority picks anyway and wrapping back to just after it.
+      uint8 fairIdx = ( osalFairIdx < tasksCnt ) ? osal_ready_find( osalFairIdx + 1 ) : tasksCnt;
+
+      if ( (fairIdx <= idx) || (fairIdx >= tasksCnt) )
+      {
+        fairIdx = osal_ready_find( idx + 1 );
+      }
+      idx = fairIdx;
+      osalFairIdx = idx;
+      osalFairCnt = 0;
+    }
+  }
+#endif
 
   if (idx < tasksCnt)
   {
@@ -1063,16 +1462,62 @@ void osal_run_system( void )
     HAL_ENTER_CRITICAL_SECTION(intState);
     events = tasksEvents[idx];
     tasksEvents[idx] = 0;  // Clear the Events for this task.
+    OSAL_READY_CLR( idx );
     HAL_EXIT_CRITICAL_SECTION(intState);
 
-    activeTaskID = idx;
-    events = (tasksArr[idx])( idx, events );
-    activeTaskID = TASK_NO_TASK;
+    if ( events )
+    {
+#if OSAL_TASK_PROFILER
+      osalTaskProf_t *pProf = osalTaskProf + idx;
+      uint16 pending = events;
+      uint32 begin = macMcuPrecisionCount();
+      uint32 ticks = begin - osalReadyStamp[idx];
+
+      osal_task_prof_hist( pProf->queueHist, ticks );
+      if ( ticks > pProf->queueMax )
+      {
+        pProf->queueMax = ticks;
+        pProf->queueMaxEvt = pending;
+      }
+#endif
 
-    HAL_ENTER_CRITICAL_SECTION(intState);
-    tasksEvents[idx] |= events;  // Add back unprocessed events to the current task.
-    HAL_EXIT_CRITICAL_SECTION(intState);
+      activeTaskID = idx;
+      events = (tasksArr[idx])( idx, events );
+      activeTaskID = TASK_NO_TASK;
+
+#if OSAL_TASK_PROFILER
+      ticks = macMcuPrecisionCount() - begin;
+
+      osal_task_prof_hist( pProf->runHist, ticks );
+      pProf->runTotal += ticks;
+      if ( ticks > pProf->runMax )
+      {
+        pProf->runMax = ticks;
+        pProf->runMaxEvt = pending & ~events;
+      }
+#endif
+
+      HAL_ENTER_CRITICAL_SECTION(intState);
+#if OSAL_TASK_PROFILER
+      if ( (tasksEvents[idx] == 0) && events )
+      {
+        osalReadyStamp[idx] = begin + ticks;  // Unprocessed events wait from now on
+      }
+#endif
+      tasksEvents[idx] |= events;  // Add back unprocessed events to the current task.
+      if ( tasksEvents[idx] )
+      {
+        OSAL_READY_SET( idx );
+      }
+      HAL_EXIT_CRITICAL_SECTION(intState);
+    }
+  }
+#if OSAL_NV_IDLE_COMPACT
+  else if ( osal_nv_compact() )  // Complete pass with no activity - compact NV a slice at a time.
+  {
+    // Not to sleep until the NV page compaction in progress is done.
   }
+#endif
 #if defined( POWER_SAVING )
   else  // Complete pass through all task events with no activity?
   {
@@ -1182,5 +1627,68 @@ uint8 osal_self( void )
   return ( activeTaskID );
 }
 
+#if OSAL_TASK_PROFILER
+/*********************************************************************
+ * @fn      osal_task_prof_hist
+ *
+ * @brief
+ *
+ *   Count a time in its power-of-two histogram bucket.
+ *
+ * @param   uint16 *pHist - histogram of OSAL_TASK_PROF_HIST_CNT buckets
+ * @param   uint32 ticks - time in 320 usec ticks
+ *
+ * @return  none
+ */
+static void osal_task_prof_hist( uint16 *pHist, uint32 ticks )
+{
+  uint8 bin = 0;
+
+  while ( ticks && (bin < (OSAL_TASK_PROF_HIST_CNT - 1)) )
+  {
+    ticks >>= 1;
+    bin++;
+  }
+
+  if ( pHist[bin] != 0xFFFF )
+  {
+    pHist[bin]++;
+  }
+}
+
+/*********************************************************************
+ * @fn      osal_task_prof_get
+ *
+ * @brief
+ *
+ *   This function returns the profile of a task: histograms and worst
+ *   cases of the delay from an event being set to the task's dispatch
+ *   in osal_run_system(), and of the task's event handler runtime, with
+ *   the events involved in the worst cases.
+ *
+ * @param   uint8 task_id - task to report
+ * @param   osalTaskProf_t *pProf - buffer for the profile
+ * @param   uint8 reset - TRUE to start the task's profile afresh
+ *
+ * @return  SUCCESS, INVALID_TASK
+ */
+uint8 osal_task_prof_get( uint8 task_id, osalTaskProf_t *pProf, uint8 reset )
+{
+  if ( task_id >= tasksCnt )
+  {
+    return ( INVALID_TASK );
+  }
+
+  osal_memcpy( pProf, osalTaskProf + task_id, sizeof( osalTaskProf_t ) );
+
+  if ( reset )
+  {
+    osal_memset( osalTaskProf + task_id, 0, sizeof( osalTaskProf_t ) );
+  }
+
+  return ( SUCCESS );
+}
+#endif /* OSAL_TASK_PROFILER */
+
 /*********************************************************************
  */
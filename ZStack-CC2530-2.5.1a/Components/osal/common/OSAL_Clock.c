@@ -59,6 +59,8 @@
 
 #define	DAY      86400UL  // 24 hours * 60 minutes * 60 seconds
 
+#define	BACKOFF_USEC  320UL  // Period of the MAC backoff timer
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -241,6 +243,36 @@ UTCTime osal_getClock( void )
   return ( OSAL_timeSeconds );
 }
 
+/*********************************************************************
+ * @fn      osal_clock_us
+ *
+ * @brief   Reads the monotonic microsecond clock. It counts the same
+ *          free-running MAC backoff timer as osalTimeUpdate(), which
+ *          the MAC keeps in step with the sleep timer across sleep, so
+ *          the resolution is 320 usec on the CC2530 (1 usec on the host
+ *          port). The count wraps every 71.5 minutes; compare values
+ *          with OSAL_CLOCK_US_REACHED().
+ *
+ * @param   none
+ *
+ * @return  microseconds
+ */
+uint32 osal_clock_us( void )
+{
+#if defined HAL_MCU_HOST
+  return ( halHostClockUs() );
+#else
+  halIntState_t intState;
+  uint32 ticks;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  ticks = macMcuPrecisionCount();
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ( ticks * BACKOFF_USEC );
+#endif
+}
+
 /*********************************************************************
  * @fn      osal_ConvertUTCTime
  *
@@ -43,6 +43,8 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+#include <string.h>
+
 #include "comdef.h"
 #include "OSAL.h"
 #include "OSAL_Memory.h"
@@ -146,6 +148,44 @@
 #define OSALMEM_REIN              'F'
 #endif
 
+/* Size-class slabs in front of the first-fit heap.
+ * Requests that fit a class are served in O(1) from that class's freelist and only fall through
+ * to the first-fit heap when the class is exhausted. The slab pool is a separate array from
+ * theHeap, so reduce MAXMEMHEAP by OSALMEM_SLAB_POOLSZ to keep the same RAM footprint.
+ * Each class size must be an even multiple of sizeof(void *) (the freelist link).
+ */
+#if OSALMEM_SLABS
+#if !defined OSALMEM_SLAB_SZ0
+#define OSALMEM_SLAB_SZ0           16
+#endif
+#if !defined OSALMEM_SLAB_CNT0
+#define OSALMEM_SLAB_CNT0          8
+#endif
+#if !defined OSALMEM_SLAB_SZ1
+#define OSALMEM_SLAB_SZ1           32
+#endif
+#if !defined OSALMEM_SLAB_CNT1
+#define OSALMEM_SLAB_CNT1          6
+#endif
+#if !defined OSALMEM_SLAB_SZ2
+#define OSALMEM_SLAB_SZ2           64
+#endif
+#if !defined OSALMEM_SLAB_CNT2
+#define OSALMEM_SLAB_CNT2          4
+#endif
+#if !defined OSALMEM_SLAB_SZ3
+#define OSALMEM_SLAB_SZ3           128
+#endif
+#if !defined OSALMEM_SLAB_CNT3
+#define OSALMEM_SLAB_CNT3          2
+#endif
+
+#define OSALMEM_SLAB_POOLSZ       ((OSALMEM_SLAB_SZ0 * OSALMEM_SLAB_CNT0) + \
+                                   (OSALMEM_SLAB_SZ1 * OSALMEM_SLAB_CNT1) + \
+                                   (OSALMEM_SLAB_SZ2 * OSALMEM_SLAB_CNT2) + \
+                                   (OSALMEM_SLAB_SZ3 * OSALMEM_SLAB_CNT3))
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Typedefs
  * ------------------------------------------------------------------------------------------------
@@ -167,6 +207,14 @@ typedef union {
   osalMemHdrHdr_t hdr;
 } osalMemHdr_t;
 
+#if OSALMEM_SLABS
+// A free slab block holds the link to the next free block of its class.
+typedef union {
+  halDataAlign_t alignDummy;
+  void *next;
+} osalMemSlabBlk_t;
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -177,6 +225,44 @@ static __no_init osalMemHdr_t *ff1;  // First free block in the small-block buck
 
 static uint8 osalMemStat;            // Discrete status flags: 0x01 = kicked.
 
+#if OSALMEM_SLABS
+#define OSALMEM_SLAB_CNT           4
+
+static __no_init osalMemSlabBlk_t slabPool[OSALMEM_SLAB_POOLSZ / sizeof(osalMemSlabBlk_t)];
+
+static const uint16 CODE slabSz[OSALMEM_SLAB_CNT] = {
+  OSALMEM_SLAB_SZ0, OSALMEM_SLAB_SZ1, OSALMEM_SLAB_SZ2, OSALMEM_SLAB_SZ3
+};
+static const uint8 CODE slabBlkCnt[OSALMEM_SLAB_CNT] = {
+  OSALMEM_SLAB_CNT0, OSALMEM_SLAB_CNT1, OSALMEM_SLAB_CNT2, OSALMEM_SLAB_CNT3
+};
+
+static uint8 *slabEnd[OSALMEM_SLAB_CNT];  // First byte after each class's blocks in slabPool.
+static void *slabFree[OSALMEM_SLAB_CNT];  // Freelist head of each class.
+static osalMemSlabStat_t slabStat[OSALMEM_SLAB_CNT];
+#endif
+
+#if OSALMEM_SITE_PROFILER
+/* The length requested and the site of each live profiled block are kept in a table hashed on
+ * the block address, not in the block, so that profiling does not change the size of any block
+ * nor the slab or bucket it comes from, and osal_mem_free() can credit the site that allocated it.
+ */
+typedef struct {
+  void  *ptr;    // Block, NULL for an empty entry
+  uint16 len;    // Length requested
+  uint8  site;   // Index in siteTbl[]
+} osalMemSiteBlk_t;
+
+#define OSALMEM_SITE_HASH(P)  (((uint16)(size_t)(P) >> 1) % OSALMEM_SITE_BLKS)
+
+static osalMemSite_t siteTbl[OSALMEM_SITE_MAX];
+static uint8 siteCnt;
+static uint16 sizeHist[OSALMEM_SIZE_HIST_CNT];
+static osalMemSiteBlk_t siteBlk[OSALMEM_SITE_BLKS];
+static uint16 siteBlkCnt;
+static uint16 siteUntracked;
+#endif
+
 #if OSALMEM_METRICS
 static uint16 blkMax;  // Max cnt of all blocks ever seen at once.
 static uint16 blkCnt;  // Current cnt of all blocks.
@@ -208,6 +294,28 @@ static uint16 proSmallBlkMiss;
 extern int dprintf(const char *fmt, ...);
 #endif /* DPRINTF_HEAPTRACE */
 
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if OSALMEM_SITE_PROFILER && defined DPRINTF_OSALHEAPTRACE
+#error OSALMEM_SITE_PROFILER and DPRINTF_OSALHEAPTRACE cannot be used together.
+#endif
+
+#if OSALMEM_SITE_PROFILER
+static void *osalMemAlloc(uint16 size);
+static void osalMemFree(void *ptr);
+static uint16 osalMemSiteFind(void *ptr);
+#endif
+#if OSALMEM_SLABS
+static void *osalMemSlabAlloc(uint16 size);
+static uint8 osalMemSlabFree(void *ptr);
+#endif
+#if OSALMEM_METRICS
+static uint16 osal_heap_fragmentation_walk( uint16 *pLargest );
+#endif
+
 /**************************************************************************************************
  * @fn          osal_mem_init
  *
@@ -252,7 +360,141 @@ void osal_mem_init(void)
    */
   blkCnt = blkFree = 2;
 #endif
+
+#if OSALMEM_SLABS
+  {
+    uint8 *blk = (uint8 *)slabPool;
+    uint8 idx;
+
+    // Thread every block of each class onto its freelist, in address order.
+    for (idx = 0; idx < OSALMEM_SLAB_CNT; idx++)
+    {
+      uint8 cnt;
+
+      slabFree[idx] = (slabBlkCnt[idx] != 0) ? blk : NULL;
+
+      for (cnt = 0; cnt < slabBlkCnt[idx]; cnt++)
+      {
+        ((osalMemSlabBlk_t *)blk)->next = (cnt == slabBlkCnt[idx] - 1) ? NULL : blk + slabSz[idx];
+        blk += slabSz[idx];
+      }
+
+      slabEnd[idx] = blk;
+      (void)osal_memset(&slabStat[idx], 0, sizeof(osalMemSlabStat_t));
+    }
+  }
+#endif
+}
+
+#if OSALMEM_SLABS
+/**************************************************************************************************
+ * @fn          osalMemSlabAlloc
+ *
+ * @brief       Allocate from the smallest size-class that fits the request.
+ *
+ * input parameters
+ *
+ * @param size - the number of bytes requested by the caller.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the block, or NULL if the request does not fit a class or the fitting
+ *              class is exhausted (the caller then falls back to the first-fit heap).
+ */
+static void *osalMemSlabAlloc(uint16 size)
+{
+  halIntState_t intState;
+  void *blk = NULL;
+  uint8 idx;
+
+  for (idx = 0; idx < OSALMEM_SLAB_CNT; idx++)
+  {
+    if ((slabBlkCnt[idx] != 0) && (size <= slabSz[idx]))
+    {
+      break;
+    }
+  }
+
+  if (idx == OSALMEM_SLAB_CNT)
+  {
+    return NULL;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+
+  blk = slabFree[idx];
+  if (blk != NULL)
+  {
+    slabFree[idx] = ((osalMemSlabBlk_t *)blk)->next;
+
+    slabStat[idx].hit++;
+    if (slabStat[idx].max < ++slabStat[idx].used)
+    {
+      slabStat[idx].max = slabStat[idx].used;
+    }
+
+#if OSALMEM_METRICS
+    memAlo += slabSz[idx];
+    if (memMax < memAlo)
+    {
+      memMax = memAlo;
+    }
+#endif
+  }
+  else
+  {
+    slabStat[idx].miss++;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
+
+  return blk;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSlabFree
+ *
+ * @brief       Return a block to its size-class freelist if it belongs to the slab pool.
+ *
+ * input parameters
+ *
+ * @param ptr - A pointer returned by osal_mem_alloc().
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the block was a slab block and has been freed, FALSE otherwise.
+ */
+static uint8 osalMemSlabFree(void *ptr)
+{
+  halIntState_t intState;
+  uint8 idx;
+
+  if (((uint8 *)ptr < (uint8 *)slabPool) || ((uint8 *)ptr >= slabEnd[OSALMEM_SLAB_CNT-1]))
+  {
+    return FALSE;
+  }
+
+  for (idx = 0; (uint8 *)ptr >= slabEnd[idx]; idx++);
+
+  HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+
+  ((osalMemSlabBlk_t *)ptr)->next = slabFree[idx];
+  slabFree[idx] = ptr;
+  slabStat[idx].used--;
+
+#if OSALMEM_METRICS
+  memAlo -= slabSz[idx];
+#endif
+
+  HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
+
+  return TRUE;
 }
+#endif
 
 /**************************************************************************************************
  * @fn          osal_mem_kick
@@ -275,7 +517,11 @@ void osal_mem_init(void)
 void osal_mem_kick(void)
 {
   halIntState_t intState;
+#if OSALMEM_SITE_PROFILER
+  osalMemHdr_t *tmp = osalMemAlloc(1);  // The raw heap block is needed to position 'ff1'.
+#else
   osalMemHdr_t *tmp = osal_mem_alloc(1);
+#endif
 
   HAL_ASSERT((tmp != NULL));
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
@@ -285,7 +531,11 @@ void osal_mem_kick(void)
    * for sizes meeting the OSALMEM_SMALL_BLKSZ criteria.
    */
   ff1 = tmp - 1;       // Set 'ff1' to point to the first available memory after the LL block.
+#if OSALMEM_SITE_PROFILER
+  osalMemFree(tmp);
+#else
   osal_mem_free(tmp);
+#endif
   osalMemStat = 0x01;  // Set 'osalMemStat' after the free because it enables memory profiling.
 
   HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
@@ -306,7 +556,9 @@ void osal_mem_kick(void)
  *
  * @return      None.
  */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if OSALMEM_SITE_PROFILER
+static void *osalMemAlloc( uint16 size )
+#elif defined DPRINTF_OSALHEAPTRACE
 void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum )
 #else /* DPRINTF_OSALHEAPTRACE */
 void *osal_mem_alloc( uint16 size )
@@ -317,6 +569,22 @@ void *osal_mem_alloc( uint16 size )
   halIntState_t intState;
   uint8 coal = 0;
 
+#if OSALMEM_SLABS
+  // Long-lived allocations made before osal_mem_kick() always go to the LL block.
+  if (osalMemStat != 0)
+  {
+    void *blk = osalMemSlabAlloc(size);
+
+    if (blk != NULL)
+    {
+#ifdef DPRINTF_OSALHEAPTRACE
+      dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) blk, fname, lnum);
+#endif /* DPRINTF_OSALHEAPTRACE */
+      return blk;
+    }
+  }
+#endif
+
   size += OSALMEM_HDRSZ;
 
   // Calculate required bytes to add to 'size' to align to halDataAlign_t.
@@ -501,7 +769,9 @@ void *osal_mem_alloc( uint16 size )
  *
  * @return      None.
  */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if OSALMEM_SITE_PROFILER
+static void osalMemFree(void *ptr)
+#elif defined DPRINTF_OSALHEAPTRACE
 void osal_mem_free_dbg(void *ptr, const char *fname, unsigned lnum)
 #else /* DPRINTF_OSALHEAPTRACE */
 void osal_mem_free(void *ptr)
@@ -514,6 +784,13 @@ void osal_mem_free(void *ptr)
   dprintf("osal_mem_free(%lx):%s:%u\n", (unsigned) ptr, fname, lnum);
 #endif /* DPRINTF_OSALHEAPTRACE */
 
+#if OSALMEM_SLABS
+  if (osalMemSlabFree(ptr))
+  {
+    return;
+  }
+#endif
+
   HAL_ASSERT(((uint8 *)ptr >= (uint8 *)theHeap) && ((uint8 *)ptr < (uint8 *)theHeap+MAXMEMHEAP));
   HAL_ASSERT(hdr->hdr.inUse);
 
@@ -553,6 +830,301 @@ void osal_mem_free(void *ptr)
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
 }
 
+#if OSALMEM_SITE_PROFILER
+/**************************************************************************************************
+ * @fn          osal_mem_alloc_dbg
+ *
+ * @brief       Allocate a block of memory and charge it to the calling site.
+ *
+ * input parameters
+ *
+ * @param size - the number of bytes to allocate from the HEAP.
+ * @param fname - __FILE__ of the call site, NULL if unknown.
+ * @param lnum - __LINE__ of the call site.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the allocated memory, or NULL.
+ */
+void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum )
+{
+  halIntState_t intState;
+  void *ptr;
+  osalMemSite_t *pSite;
+  uint16 lim;
+  uint8 idx;
+
+  ptr = osalMemAlloc( size );
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  // Every request counts in the size histogram, whether or not it succeeded.
+  for ( idx = 0, lim = 8; (idx < OSALMEM_SIZE_HIST_CNT-1) && (size > lim); idx++, lim <<= 1 );
+  sizeHist[idx]++;
+
+  if ( ptr != NULL )
+  {
+    for ( idx = 0; idx < siteCnt; idx++ )
+    {
+      pSite = siteTbl + idx;
+
+      if ( (pSite->lnum == (uint16)lnum) &&
+           ((pSite->fname == fname) ||
+            ((pSite->fname != NULL) && (fname != NULL) && (strcmp( pSite->fname, fname ) == 0))) )
+      {
+        break;
+      }
+    }
+
+    if ( idx == siteCnt )
+    {
+      if ( siteCnt < OSALMEM_SITE_MAX-1 )
+      {
+        siteCnt++;
+        siteTbl[idx].fname = fname;
+        siteTbl[idx].lnum = (uint16)lnum;
+      }
+      else
+      {
+        // Table is full - charge the overflow entry.
+        idx = OSALMEM_SITE_MAX-1;
+        siteCnt = OSALMEM_SITE_MAX;
+      }
+    }
+
+    pSite = siteTbl + idx;
+    pSite->cnt++;
+
+    // Charge the live bytes only if the block can be credited back when it is freed.
+    if ( siteBlkCnt < OSALMEM_SITE_BLKS )
+    {
+      osalMemSiteBlk_t *pBlk = siteBlk + osalMemSiteFind( ptr );
+
+      pBlk->ptr = ptr;
+      pBlk->len = size;
+      pBlk->site = idx;
+      siteBlkCnt++;
+
+      pSite->live += size;
+      if ( pSite->peak < pSite->live )
+      {
+        pSite->peak = pSite->live;
+      }
+    }
+    else
+    {
+      siteUntracked++;
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return ptr;
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_free_dbg
+ *
+ * @brief       Free a block of memory and credit its allocation site.
+ *
+ * input parameters
+ *
+ * @param ptr - A valid pointer (i.e. a pointer returned by osal_mem_alloc()) to the memory to free.
+ * @param fname - __FILE__ of the call site, unused.
+ * @param lnum - __LINE__ of the call site, unused.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void osal_mem_free_dbg( void *ptr, const char *fname, unsigned lnum )
+{
+  halIntState_t intState;
+  uint16 hole;
+  uint16 idx;
+
+  (void)fname;
+  (void)lnum;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  hole = osalMemSiteFind( ptr );
+  if ( (hole < OSALMEM_SITE_BLKS) && (siteBlk[hole].ptr != NULL) )
+  {
+    siteTbl[siteBlk[hole].site].live -= siteBlk[hole].len;
+    siteBlk[hole].ptr = NULL;
+    siteBlkCnt--;
+
+    // Close the hole: move up any later entry of the probe run that may not skip it.
+    for ( idx = (hole + 1) % OSALMEM_SITE_BLKS; siteBlk[idx].ptr != NULL;
+          idx = (idx + 1) % OSALMEM_SITE_BLKS )
+    {
+      uint16 home = OSALMEM_SITE_HASH( siteBlk[idx].ptr );
+
+      if ( ((idx > hole) && ((home <= hole) || (home > idx))) ||
+           ((idx < hole) && ((home <= hole) && (home > idx))) )
+      {
+        siteBlk[hole] = siteBlk[idx];
+        siteBlk[idx].ptr = NULL;
+        hole = idx;
+      }
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  osalMemFree( ptr );
+}
+
+/**************************************************************************************************
+ * @fn          osalMemSiteFind
+ *
+ * @brief       Find the entry of a block in the table of live profiled blocks.
+ *
+ * input parameters
+ *
+ * @param ptr - The block.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Index of the block's entry, or of the empty entry where it belongs, or
+ *              OSALMEM_SITE_BLKS if the table is full and the block is not in it.
+ */
+static uint16 osalMemSiteFind( void *ptr )
+{
+  uint16 idx = OSALMEM_SITE_HASH( ptr );
+  uint16 cnt;
+
+  for ( cnt = 0; cnt < OSALMEM_SITE_BLKS; cnt++ )
+  {
+    if ( (siteBlk[idx].ptr == NULL) || (siteBlk[idx].ptr == ptr) )
+    {
+      return idx;
+    }
+    idx = (idx + 1) % OSALMEM_SITE_BLKS;
+  }
+
+  return OSALMEM_SITE_BLKS;
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_alloc
+ *
+ * @brief       Allocate a block of memory for a caller compiled without the profiler macros.
+ *
+ * input parameters
+ *
+ * @param size - the number of bytes to allocate from the HEAP.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the allocated memory, or NULL.
+ */
+void *(osal_mem_alloc)( uint16 size )
+{
+  return osal_mem_alloc_dbg( size, NULL, 0 );
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_free
+ *
+ * @brief       Free a block of memory for a caller compiled without the profiler macros.
+ *
+ * input parameters
+ *
+ * @param ptr - A valid pointer (i.e. a pointer returned by osal_mem_alloc()) to the memory to free.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void (osal_mem_free)( void *ptr )
+{
+  osal_mem_free_dbg( ptr, NULL, 0 );
+}
+
+/*********************************************************************
+ * @fn      osal_heap_site_cnt
+ *
+ * @brief   Return the number of allocation sites being tracked.
+ *
+ * @param   none
+ *
+ * @return  Number of valid entries for osal_heap_site_get().
+ */
+uint8 osal_heap_site_cnt( void )
+{
+  return siteCnt;
+}
+
+/*********************************************************************
+ * @fn      osal_heap_site_get
+ *
+ * @brief   Return the counters of an allocation site.
+ *
+ * @param   idx - site index, less than osal_heap_site_cnt()
+ * @param   pSite - output: counters of the site
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if idx is not a tracked site.
+ */
+uint8 osal_heap_site_get( uint8 idx, osalMemSite_t *pSite )
+{
+  halIntState_t intState;
+
+  if ( idx >= siteCnt )
+  {
+    return INVALIDPARAMETER;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+  *pSite = siteTbl[idx];
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_heap_size_hist
+ *
+ * @brief   Return the number of requests that fell in a size bucket.
+ *
+ * @param   idx - bucket index: 0 for <= 8 bytes, doubling up to
+ *                OSALMEM_SIZE_HIST_CNT-1 for everything larger.
+ *
+ * @return  Request count, 0 for an invalid bucket.
+ */
+uint16 osal_heap_size_hist( uint8 idx )
+{
+  return (idx < OSALMEM_SIZE_HIST_CNT) ? sizeHist[idx] : 0;
+}
+
+/*********************************************************************
+ * @fn      osal_heap_site_untracked
+ *
+ * @brief   Return the number of allocations that were counted but not
+ *          charged to the live bytes of their site, because more than
+ *          OSALMEM_SITE_BLKS profiled blocks were live at the time.
+ *
+ * @param   none
+ *
+ * @return  Untracked allocation count.
+ */
+uint16 osal_heap_site_untracked( void )
+{
+  return siteUntracked;
+}
+#endif
+
 #if OSALMEM_METRICS
 /*********************************************************************
  * @fn      osal_heap_block_max
@@ -609,6 +1181,126 @@ uint16 osal_heap_mem_used( void )
 {
   return memAlo;
 }
+
+/*********************************************************************
+ * @fn      osal_heap_largest_free
+ *
+ * @brief   Return the largest block the first-fit heap could allocate
+ *          right now, counting runs of adjacent free blocks as one
+ *          since osal_mem_alloc() coalesces them on demand.
+ *
+ * @param   none
+ *
+ * @return  Size in bytes of the largest free run, headers included.
+ */
+uint16 osal_heap_largest_free( void )
+{
+  uint16 largest;
+
+  (void)osal_heap_fragmentation_walk( &largest );
+
+  return largest;
+}
+
+/*********************************************************************
+ * @fn      osal_heap_fragmentation
+ *
+ * @brief   Return the external fragmentation of the first-fit heap:
+ *          the share of free bytes that are not in the largest free run.
+ *
+ * @param   none
+ *
+ * @return  Fragmentation in percent (0 when the heap has no free bytes).
+ */
+uint8 osal_heap_fragmentation( void )
+{
+  uint16 largest;
+  uint16 total = osal_heap_fragmentation_walk( &largest );
+
+  if ( total == 0 )
+  {
+    return 0;
+  }
+
+  return (uint8)(100 - (uint16)(((uint32)largest * 100) / total));
+}
+
+/*********************************************************************
+ * @fn      osal_heap_fragmentation_walk
+ *
+ * @brief   Walk the first-fit heap summing its free bytes and finding
+ *          the largest run of adjacent free blocks.
+ *
+ * @param   pLargest - output: size of the largest free run
+ *
+ * @return  Total free bytes, headers included.
+ */
+static uint16 osal_heap_fragmentation_walk( uint16 *pLargest )
+{
+  halIntState_t intState;
+  osalMemHdr_t *hdr = theHeap;
+  uint16 total = 0;
+  uint16 largest = 0;
+  uint16 run = 0;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  while ( hdr->val != 0 )
+  {
+    if ( hdr->hdr.inUse )
+    {
+      run = 0;
+    }
+    else
+    {
+      run += hdr->hdr.len;
+      total += hdr->hdr.len;
+
+      if ( largest < run )
+      {
+        largest = run;
+      }
+    }
+
+    hdr = (osalMemHdr_t *)((uint8 *)hdr + hdr->hdr.len);
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  *pLargest = largest;
+
+  return total;
+}
+#endif
+
+#if OSALMEM_SLABS
+/*********************************************************************
+ * @fn      osal_heap_slab_stats
+ *
+ * @brief   Return the usage counters of one size-class slab.
+ *
+ * @param   idx - size-class index, 0 being the smallest class
+ * @param   pStat - output: counters of the class
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if idx is not a valid class.
+ */
+uint8 osal_heap_slab_stats( uint8 idx, osalMemSlabStat_t *pStat )
+{
+  halIntState_t intState;
+
+  if ( idx >= OSALMEM_SLAB_CNT )
+  {
+    return INVALIDPARAMETER;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+  *pStat = slabStat[idx];
+  pStat->size = slabSz[idx];
+  pStat->cnt = slabBlkCnt[idx];
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return SUCCESS;
+}
 #endif
 
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
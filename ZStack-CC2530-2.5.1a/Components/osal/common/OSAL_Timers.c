@@ -55,6 +55,16 @@
  * CONSTANTS
  */
 
+/* Timer list backend selection.
+ * TRUE  - timers are kept in a delta-list sorted by expiration; each record
+ *         holds its timeout relative to the record before it, so a tick only
+ *         touches the head of the list and the timers that actually expire.
+ * FALSE - legacy unsorted list; every tick decrements every active timer.
+ */
+#if !defined OSAL_TIMERS_DELTA_LIST
+#define OSAL_TIMERS_DELTA_LIST  TRUE
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -66,6 +76,7 @@ typedef struct
   uint16 event_flag;
   uint8  task_id;
   uint16 reloadTimeout;
+  uint16 timeoutHi;     // Further OSAL_TIMERS_MAX_TIMEOUT periods to wait (long timers)
 } osalTimerRec_t;
 
 /*********************************************************************
@@ -74,6 +85,12 @@ typedef struct
 
 osalTimerRec_t *timerHead;
 
+#if OSAL_TIMERS_DELTA_LIST
+// Timers that have been taken off the head of timerHead by osalTimerUpdate()
+// but whose events have not been delivered yet.
+static osalTimerRec_t *timerExpired;
+#endif
+
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -95,6 +112,11 @@ osalTimerRec_t  *osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
 osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag );
 void osalDeleteTimer( osalTimerRec_t *rmTimer );
 
+#if OSAL_TIMERS_DELTA_LIST
+static void osalLinkTimer( osalTimerRec_t *newTimer, uint16 timeout );
+static osalTimerRec_t *osalUnlinkTimer( uint8 task_id, uint16 event_flag );
+#endif
+
 /*********************************************************************
  * FUNCTIONS
  *********************************************************************/
@@ -113,6 +135,101 @@ void osalTimerInit( void )
   osal_systemClock = 0;
 }
 
+#if OSAL_TIMERS_DELTA_LIST
+/*********************************************************************
+ * @fn      osalLinkTimer
+ *
+ * @brief   Insert a timer into the delta-list at its expiration point.
+ *          Timers with equal expiration keep the order they were added.
+ *          Ints must be disabled.
+ *
+ * @param   newTimer - timer record, not in any list
+ * @param   timeout - milliseconds from now
+ *
+ * @return  none
+ */
+static void osalLinkTimer( osalTimerRec_t *newTimer, uint16 timeout )
+{
+  osalTimerRec_t *srchTimer = timerHead;
+  osalTimerRec_t *prevTimer = NULL;
+
+  // Skip the timers that expire no later than this one
+  while ( srchTimer && (srchTimer->timeout <= timeout) )
+  {
+    timeout -= srchTimer->timeout;
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  newTimer->timeout = timeout;
+  newTimer->next = srchTimer;
+
+  // The following timer is now relative to the new one
+  if ( srchTimer )
+  {
+    srchTimer->timeout -= timeout;
+  }
+
+  if ( prevTimer == NULL )
+  {
+    timerHead = newTimer;
+  }
+  else
+  {
+    prevTimer->next = newTimer;
+  }
+}
+
+/*********************************************************************
+ * @fn      osalUnlinkTimer
+ *
+ * @brief   Take a timer out of the delta-list, handing its remaining
+ *          time to the timer after it.
+ *          Ints must be disabled.
+ *
+ * @param   task_id
+ * @param   event_flag
+ *
+ * @return  osalTimerRec_t * - the unlinked timer, NULL if not found
+ */
+static osalTimerRec_t *osalUnlinkTimer( uint8 task_id, uint16 event_flag )
+{
+  osalTimerRec_t *srchTimer = timerHead;
+  osalTimerRec_t *prevTimer = NULL;
+
+  while ( srchTimer )
+  {
+    if ( srchTimer->event_flag == event_flag &&
+         srchTimer->task_id == task_id )
+    {
+      osalTimerRec_t *nextTimer = srchTimer->next;
+
+      if ( nextTimer )
+      {
+        nextTimer->timeout += srchTimer->timeout;
+      }
+
+      if ( prevTimer == NULL )
+      {
+        timerHead = nextTimer;
+      }
+      else
+      {
+        prevTimer->next = nextTimer;
+      }
+
+      srchTimer->next = NULL;
+      break;
+    }
+
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  return ( srchTimer );
+}
+#endif // OSAL_TIMERS_DELTA_LIST
+
 /*********************************************************************
  * @fn      osalAddTimer
  *
@@ -127,6 +244,43 @@ void osalTimerInit( void )
  */
 osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout )
 {
+#if OSAL_TIMERS_DELTA_LIST
+  osalTimerRec_t *newTimer;
+
+  // Look for an existing timer first
+  newTimer = osalUnlinkTimer( task_id, event_flag );
+  if ( newTimer == NULL )
+  {
+    newTimer = osalFindTimer( task_id, event_flag );
+    if ( newTimer )
+    {
+      // Timer is waiting on the expired list - osalTimerUpdate() will
+      // re-link it with the new timeout instead of notifying the task.
+      newTimer->timeout = timeout;
+      newTimer->timeoutHi = 0;
+
+      return ( newTimer );
+    }
+
+    // New Timer
+    newTimer = osal_mem_alloc( sizeof( osalTimerRec_t ) );
+
+    if ( newTimer == NULL )
+    {
+      return ( (osalTimerRec_t *)NULL );
+    }
+
+    // Fill in new timer
+    newTimer->task_id = task_id;
+    newTimer->event_flag = event_flag;
+    newTimer->reloadTimeout = 0;
+  }
+
+  newTimer->timeoutHi = 0;
+  osalLinkTimer( newTimer, timeout );
+
+  return ( newTimer );
+#else
   osalTimerRec_t *newTimer;
   osalTimerRec_t *srchTimer;
 
@@ -136,6 +290,7 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
   {
     // Timer is found - update it.
     newTimer->timeout = timeout;
+    newTimer->timeoutHi = 0;
 
     return ( newTimer );
   }
@@ -152,6 +307,7 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
       newTimer->timeout = timeout;
       newTimer->next = (void *)NULL;
       newTimer->reloadTimeout = 0;
+      newTimer->timeoutHi = 0;
 
       // Does the timer list already exist
       if ( timerHead == NULL )
@@ -177,6 +333,7 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
     else
       return ( (osalTimerRec_t *)NULL );
   }
+#endif // OSAL_TIMERS_DELTA_LIST
 }
 
 /*********************************************************************
@@ -208,6 +365,19 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
     srchTimer = srchTimer->next;
   }
 
+#if OSAL_TIMERS_DELTA_LIST
+  if ( srchTimer == NULL )
+  {
+    // Expired, but its event has not been delivered yet
+    for ( srchTimer = timerExpired; srchTimer; srchTimer = srchTimer->next )
+    {
+      if ( srchTimer->event_flag == event_flag &&
+           srchTimer->task_id == task_id )
+        break;
+    }
+  }
+#endif
+
   return ( srchTimer );
 }
 
@@ -296,6 +466,88 @@ uint8 osal_start_reload_timer( uint8 taskID, uint16 event_id, uint16 timeout_val
   return ( (newTimer != NULL) ? SUCCESS : NO_TIMER_AVAIL );
 }
 
+/*********************************************************************
+ * @fn      osal_start_long_timer
+ *
+ * @brief
+ *
+ *   This function is called to start a timer to expire in n mSecs, like
+ *   osal_start_timerEx() but with a 32-bit timeout, so waits of more
+ *   than 65 seconds need no chaining by the caller. The timer is kept
+ *   as a 16-bit timeout plus a count of OSAL_TIMERS_MAX_TIMEOUT periods.
+ *   Use osal_stop_timerEx() to stop it.
+ *
+ * @param   uint8 taskID - task id to set timer for
+ * @param   uint16 event_id - event to be notified with
+ * @param   uint32 timeout_value - in milliseconds, values above
+ *                                 OSAL_TIMERS_MAX_LONG_TIMEOUT are
+ *                                 cut down to it.
+ *
+ * @return  SUCCESS, or NO_TIMER_AVAIL.
+ */
+uint8 osal_start_long_timer( uint8 taskID, uint16 event_id, uint32 timeout_value )
+{
+  halIntState_t intState;
+  osalTimerRec_t *newTimer;
+  uint16 timeoutHi;
+  uint16 timeoutLo;
+
+  if ( timeout_value > OSAL_TIMERS_MAX_LONG_TIMEOUT )
+  {
+    timeout_value = OSAL_TIMERS_MAX_LONG_TIMEOUT;
+  }
+
+  timeoutHi = (uint16)(timeout_value / OSAL_TIMERS_MAX_TIMEOUT);
+  timeoutLo = (uint16)(timeout_value % OSAL_TIMERS_MAX_TIMEOUT);
+  if ( (timeoutLo == 0) && timeoutHi )
+  {
+    timeoutLo = OSAL_TIMERS_MAX_TIMEOUT;
+    timeoutHi--;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  // Add timer
+  newTimer = osalAddTimer( taskID, event_id, timeoutLo );
+  if ( newTimer )
+  {
+    newTimer->timeoutHi = timeoutHi;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  return ( (newTimer != NULL) ? SUCCESS : NO_TIMER_AVAIL );
+}
+
+/*********************************************************************
+ * @fn      osal_start_deadline_timer
+ *
+ * @brief
+ *
+ *   This function is called to start a timer that expires when the
+ *   system clock (osal_GetSystemClock()) reaches a deadline. The deadline
+ *   is compared as a signed distance from the clock, so it may lie up to
+ *   2^31 - 1 msecs (24 days) ahead; one that has already passed expires
+ *   on the next tick.
+ *
+ * @param   uint8 taskID - task id to set timer for
+ * @param   uint16 event_id - event to be notified with
+ * @param   uint32 deadline - system clock value in milliseconds.
+ *
+ * @return  SUCCESS, or NO_TIMER_AVAIL.
+ */
+uint8 osal_start_deadline_timer( uint8 taskID, uint16 event_id, uint32 deadline )
+{
+  uint32 timeout = deadline - osal_GetSystemClock();
+
+  if ( (int32)timeout <= 0 )
+  {
+    timeout = 0;  // Passed already
+  }
+
+  return ( osal_start_long_timer( taskID, event_id, timeout ) );
+}
+
 /*********************************************************************
  * @fn      osal_stop_timerEx
  *
@@ -314,18 +566,36 @@ uint8 osal_stop_timerEx( uint8 task_id, uint16 event_id )
 {
   halIntState_t intState;
   osalTimerRec_t *foundTimer;
+#if OSAL_TIMERS_DELTA_LIST
+  osalTimerRec_t *freeTimer;
+#endif
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-  // Find the timer to stop
-  foundTimer = osalFindTimer( task_id, event_id );
-  if ( foundTimer )
+#if OSAL_TIMERS_DELTA_LIST
+  // A pending timer can be taken out of the delta-list right away
+  freeTimer = osalUnlinkTimer( task_id, event_id );
+  foundTimer = freeTimer;
+  if ( foundTimer == NULL )
+#endif
   {
-    osalDeleteTimer( foundTimer );
+    // Find the timer to stop
+    foundTimer = osalFindTimer( task_id, event_id );
+    if ( foundTimer )
+    {
+      osalDeleteTimer( foundTimer );
+    }
   }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
+#if OSAL_TIMERS_DELTA_LIST
+  if ( freeTimer )
+  {
+    osal_mem_free( freeTimer );
+  }
+#endif
+
   return ( (foundTimer != NULL) ? SUCCESS : INVALID_EVENT_ID );
 }
 
@@ -347,12 +617,60 @@ uint16 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
+#if OSAL_TIMERS_DELTA_LIST
+  // The time left is the sum of the deltas up to and including this timer.
+  // Timers on the expired list have no time left.
+  for ( tmr = timerHead; tmr; tmr = tmr->next )
+  {
+    rtrn += tmr->timeout;
+
+    if ( tmr->event_flag == event_id && tmr->task_id == task_id )
+      break;
+  }
+
+  if ( tmr == NULL )
+  {
+    rtrn = 0;
+  }
+#else
   tmr = osalFindTimer( task_id, event_id );
 
   if ( tmr )
   {
     rtrn = tmr->timeout;
   }
+#endif
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  return rtrn;
+}
+
+/*********************************************************************
+ * @fn      osal_get_long_timeout
+ *
+ * @brief
+ *
+ * @param   uint8 task_id - task id of timer to check
+ * @param   uint16 event_id - identifier of timer to be checked
+ *
+ * @return  Return the time left in msecs of a timer, including the
+ *          periods still to go of a long timer, zero if not found.
+ */
+uint32 osal_get_long_timeout( uint8 task_id, uint16 event_id )
+{
+  halIntState_t intState;
+  uint32 rtrn;
+  osalTimerRec_t *tmr;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  rtrn = osal_get_timeoutEx( task_id, event_id );
+  tmr = osalFindTimer( task_id, event_id );
+  if ( tmr )
+  {
+    rtrn += (uint32)tmr->timeoutHi * OSAL_TIMERS_MAX_TIMEOUT;
+  }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
@@ -386,6 +704,13 @@ uint8 osal_timer_num_active( void )
     srchTimer = srchTimer->next;
   }
 
+#if OSAL_TIMERS_DELTA_LIST
+  for ( srchTimer = timerExpired; srchTimer != NULL; srchTimer = srchTimer->next )
+  {
+    num_timers++;
+  }
+#endif
+
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
   return num_timers;
@@ -402,6 +727,103 @@ uint8 osal_timer_num_active( void )
  *********************************************************************/
 void osalTimerUpdate( uint16 updateTime )
 {
+#if OSAL_TIMERS_DELTA_LIST
+  halIntState_t intState;
+  osalTimerRec_t *srchTimer;
+  osalTimerRec_t *prevTimer = NULL;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+  // Update the system time
+  osal_systemClock += updateTime;
+
+  // The timers that expire within this update are at the head of the list,
+  // move them over to the expired list
+  timerExpired = NULL;
+  while ( timerHead && (timerHead->timeout <= updateTime) )
+  {
+    srchTimer = timerHead;
+    updateTime -= srchTimer->timeout;
+    timerHead = srchTimer->next;
+
+    if ( srchTimer->timeoutHi && srchTimer->event_flag )
+    {
+      // Long timer with periods still to go, counted from when it expired
+      srchTimer->timeoutHi--;
+      osalLinkTimer( srchTimer, OSAL_TIMERS_MAX_TIMEOUT );
+    }
+    else
+    {
+      srchTimer->timeout = 0;
+      srchTimer->next = NULL;
+
+      if ( prevTimer == NULL )
+      {
+        timerExpired = srchTimer;
+      }
+      else
+      {
+        prevTimer->next = srchTimer;
+      }
+      prevTimer = srchTimer;
+    }
+  }
+
+  // Charge what is left of the update to the first pending timer
+  if ( timerHead )
+  {
+    timerHead->timeout -= updateTime;
+  }
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  // Deliver the expired timers in expiration order
+  for ( ;; )
+  {
+    osalTimerRec_t *freeTimer = NULL;
+
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+    srchTimer = timerExpired;
+    if ( srchTimer == NULL )
+    {
+      HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+      break;
+    }
+    timerExpired = srchTimer->next;
+
+    if ( srchTimer->event_flag == 0 )
+    {
+      // Stopped after it expired
+      freeTimer = srchTimer;
+    }
+    else if ( srchTimer->timeout )
+    {
+      // Restarted after it expired
+      osalLinkTimer( srchTimer, srchTimer->timeout );
+    }
+    else
+    {
+      // Notify the task of a timeout
+      osal_set_event( srchTimer->task_id, srchTimer->event_flag );
+
+      // Check for reloading
+      if ( srchTimer->reloadTimeout )
+      {
+        osalLinkTimer( srchTimer, srchTimer->reloadTimeout );
+      }
+      else
+      {
+        freeTimer = srchTimer;
+      }
+    }
+
+    HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+    if ( freeTimer )
+    {
+      osal_mem_free( freeTimer );
+    }
+  }
+#else
   halIntState_t intState;
   osalTimerRec_t *srchTimer;
   osalTimerRec_t *prevTimer;
@@ -427,13 +849,23 @@ void osalTimerUpdate( uint16 updateTime )
       
       if (srchTimer->timeout <= updateTime)
       {
-        srchTimer->timeout = 0;
+        if ( srchTimer->timeoutHi && srchTimer->event_flag )
+        {
+          // Long timer with periods still to go, counted from when it expired
+          srchTimer->timeoutHi--;
+          srchTimer->timeout = OSAL_TIMERS_MAX_TIMEOUT - (updateTime - srchTimer->timeout);
+        }
+        else
+        {
+          srchTimer->timeout = 0;
+        }
       }
       else
       {
         srchTimer->timeout = srchTimer->timeout - updateTime;
       }
       
+
       // Check for reloading
       if ( (srchTimer->timeout == 0) && (srchTimer->reloadTimeout) && (srchTimer->event_flag) )
       {
@@ -478,9 +910,11 @@ void osalTimerUpdate( uint16 updateTime )
       }
     }
   }
+#endif // OSAL_TIMERS_DELTA_LIST
 }
 
-#ifdef POWER_SAVING
+// The host simulation also steps each node straight to its next timeout.
+#if defined( POWER_SAVING ) || defined( HAL_MCU_HOST )
 /*********************************************************************
  * @fn      osal_adjust_timers
  *
@@ -518,6 +952,10 @@ void osal_adjust_timers( void )
  *********************************************************************/
 uint16 osal_next_timeout( void )
 {
+#if OSAL_TIMERS_DELTA_LIST
+  // The head of the delta-list is always the next timer to expire
+  return ( (timerHead != NULL) ? timerHead->timeout : 0 );
+#else
   uint16 nextTimeout;
   osalTimerRec_t *srchTimer;
 
@@ -545,8 +983,9 @@ uint16 osal_next_timeout( void )
   }
 
   return ( nextTimeout );
+#endif // OSAL_TIMERS_DELTA_LIST
 }
-#endif // POWER_SAVING
+#endif // POWER_SAVING || HAL_MCU_HOST
 
 /*********************************************************************
  * @fn      osal_GetSystemClock()
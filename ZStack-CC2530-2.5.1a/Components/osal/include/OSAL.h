@@ -72,7 +72,7 @@ extern "C"
 
 #define OSAL_MSG_Q_HEAD(q_ptr)      (*(q_ptr))
 
-#define OSAL_MSG_LEN(msg_ptr)      ((osal_msg_hdr_t *) (msg_ptr) - 1)->len
+#define OSAL_MSG_LEN(msg_ptr)      (((osal_msg_hdr_t *) (msg_ptr) - 1)->len & ~OSAL_MSG_LEN_REF)
 
 #define OSAL_MSG_ID(msg_ptr)      ((osal_msg_hdr_t *) (msg_ptr) - 1)->dest_id
 
@@ -83,6 +83,23 @@ extern "C"
 /*** Interrupts ***/
 #define INTS_ALL    0xFF
 
+/*** Message Length Flags ***/
+// The message holds a reference on a shared buffer (see osal_msg_allocate_ref())
+#define OSAL_MSG_LEN_REF            0x8000
+
+/*** Task Profiler ***/
+// TRUE to time event queueing and handler runtime of every task with the
+// MAC 320 usec precision counter (see osal_task_prof_get())
+#if !defined ( OSAL_TASK_PROFILER )
+  #define OSAL_TASK_PROFILER  FALSE
+#endif
+
+// Histogram buckets: 0 ticks, 1 tick, 2-3, 4-7, ... and the last one
+// collects everything from 2^(OSAL_TASK_PROF_HIST_CNT-2) ticks up
+#if !defined ( OSAL_TASK_PROF_HIST_CNT )
+  #define OSAL_TASK_PROF_HIST_CNT  8
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -101,6 +118,18 @@ typedef struct
 
 typedef void * osal_msg_q_t;
 
+// Task profile, times are in 320 usec ticks (OSAL_TASK_PROFILER)
+typedef struct
+{
+  uint16 queueHist[OSAL_TASK_PROF_HIST_CNT]; // Ready to dispatch delay
+  uint16 runHist[OSAL_TASK_PROF_HIST_CNT];   // Event handler runtime
+  uint32 queueMax;                           // Worst ready to dispatch delay
+  uint16 queueMaxEvt;                        // Events pending at that dispatch
+  uint32 runMax;                             // Worst handler runtime
+  uint16 runMaxEvt;                          // Events processed by that run
+  uint32 runTotal;                           // Sum of handler runtime
+} osalTaskProf_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -121,11 +150,28 @@ typedef void * osal_msg_q_t;
    */
   extern uint8 osal_msg_deallocate( uint8 *msg_ptr );
 
+  /*
+   * Task Message Allocation holding a reference on a shared buffer
+   */
+  extern uint8 * osal_msg_allocate_ref( uint16 len, void *ref_ptr );
+
+  /*
+   * Reference-counted, read-only shared buffers
+   */
+  extern void *osal_ref_alloc( uint16 len );
+  extern void osal_ref_add( void *ref_ptr );
+  extern void osal_ref_release( void *ref_ptr );
+
   /*
    * Send a Task Message
    */
   extern uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr );
 
+  /*
+   * Push a Task Message to the head of the destination task's queue
+   */
+  extern uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr );
+
   /*
    * Receive a Task Message
    */
@@ -136,6 +182,16 @@ typedef void * osal_msg_q_t;
    */
   extern osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event);
 
+  /*
+   * Number of Task Messages waiting for a task
+   */
+  extern uint16 osal_msg_q_count( uint8 task_id );
+
+  /*
+   * High-water mark of a task's message queue depth
+   */
+  extern uint16 osal_msg_q_max( uint8 task_id, uint8 reset );
+
   /*
    * Enqueue a Task Message
    */
@@ -220,6 +276,13 @@ typedef void * osal_msg_q_t;
    */
   extern uint8 osal_self( void );
 
+#if ( OSAL_TASK_PROFILER )
+  /*
+   * Get (and optionally reset) the profile of a task
+   */
+  extern uint8 osal_task_prof_get( uint8 task_id, osalTaskProf_t *pProf, uint8 reset );
+#endif
+
 
 /*** Helper Functions ***/
 
@@ -55,6 +55,10 @@ extern "C"
 
 #define	IsLeapYear(yr)	(!((yr) % 400) || (((yr) % 100) && !((yr) % 4)))
 
+// TRUE once osal_clock_us() value 'now' has reached 'deadline', both
+// within half a wrap (35 minutes) of each other
+#define OSAL_CLOCK_US_REACHED(now, deadline)  ((int32)((now) - (deadline)) >= 0)
+
 /*********************************************************************
  * CONSTANTS
  */
@@ -107,6 +111,12 @@ typedef struct
    */
   extern UTCTime osal_getClock( void );
 
+  /*
+   * Reads the monotonic microsecond clock (wraps every 71.5 minutes),
+   * for deadlines and intervals too short for OSAL timers.
+   */
+  extern uint32 osal_clock_us( void );
+
   /*
    * Converts UTCTime to UTCTimeStruct
    *
@@ -58,6 +58,26 @@ extern "C"
   #define OSALMEM_METRICS  FALSE
 #endif
 
+#if !defined ( OSALMEM_SLABS )
+  #define OSALMEM_SLABS  FALSE
+#endif
+
+// Allocation-site profiler: live/peak bytes and counts per osal_mem_alloc() call site.
+#if !defined ( OSALMEM_SITE_PROFILER )
+  #define OSALMEM_SITE_PROFILER  FALSE
+#endif
+
+#if ( OSALMEM_SITE_PROFILER )
+#if !defined ( OSALMEM_SITE_MAX )
+  #define OSALMEM_SITE_MAX  32  // Call sites tracked; the last entry collects the overflow.
+#endif
+#if !defined ( OSALMEM_SITE_BLKS )
+  #define OSALMEM_SITE_BLKS  64 // Live blocks whose site is remembered; see osal_heap_site_untracked().
+#endif
+  // Request size histogram buckets: <= 8, 16, 32, 64, 128, 256, 512 and > 512 bytes.
+  #define OSALMEM_SIZE_HIST_CNT  8
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -68,6 +88,27 @@ extern "C"
  * TYPEDEFS
  */
 
+// Usage counters of one size-class slab (OSALMEM_SLABS)
+typedef struct
+{
+  uint16 size;  // Block size of the class
+  uint8  cnt;   // Number of blocks in the class
+  uint8  used;  // Blocks currently allocated
+  uint8  max;   // Most blocks ever allocated at once
+  uint16 hit;   // Allocations served by the class
+  uint16 miss;  // Allocations that fit the class but fell through to the heap
+} osalMemSlabStat_t;
+
+// Counters of one allocation site (OSALMEM_SITE_PROFILER)
+typedef struct
+{
+  const char *fname;  // __FILE__ of the call site, NULL for untracked callers or overflow
+  uint16 lnum;        // __LINE__ of the call site
+  uint16 live;        // Bytes currently allocated from this site
+  uint16 peak;        // Most bytes ever allocated from this site at once
+  uint16 cnt;         // Number of allocations made from this site
+} osalMemSite_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -89,7 +130,7 @@ extern "C"
  /*
   * Allocate a block of memory.
   */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if defined ( DPRINTF_OSALHEAPTRACE ) || ( OSALMEM_SITE_PROFILER )
   void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum );
 #define osal_mem_alloc(_size ) osal_mem_alloc_dbg(_size, __FILE__, __LINE__)
 #else /* DPRINTF_OSALHEAPTRACE */
@@ -99,13 +140,41 @@ extern "C"
  /*
   * Free a block of memory.
   */
-#ifdef DPRINTF_OSALHEAPTRACE
+#if defined ( DPRINTF_OSALHEAPTRACE ) || ( OSALMEM_SITE_PROFILER )
   void osal_mem_free_dbg( void *ptr, const char *fname, unsigned lnum );
 #define osal_mem_free(_ptr ) osal_mem_free_dbg(_ptr, __FILE__, __LINE__)
 #else /* DPRINTF_OSALHEAPTRACE */
   void osal_mem_free( void *ptr );
 #endif /* DPRINTF_OSALHEAPTRACE */
 
+#if ( OSALMEM_SITE_PROFILER )
+ /*
+  * Allocate/free without call site, for code built without this header (e.g. libraries).
+  */
+  void *(osal_mem_alloc)( uint16 size );
+  void (osal_mem_free)( void *ptr );
+
+ /*
+  * Return the number of allocation sites being tracked.
+  */
+  uint8 osal_heap_site_cnt( void );
+
+ /*
+  * Return the counters of an allocation site.
+  */
+  uint8 osal_heap_site_get( uint8 idx, osalMemSite_t *pSite );
+
+ /*
+  * Return the number of requests that fell in a size histogram bucket.
+  */
+  uint16 osal_heap_size_hist( uint8 idx );
+
+ /*
+  * Return the number of allocations not charged to their site's live bytes for lack of room.
+  */
+  uint16 osal_heap_site_untracked( void );
+#endif
+
 #if ( OSALMEM_METRICS )
  /*
   * Return the maximum number of blocks ever allocated at once.
@@ -126,6 +195,23 @@ extern "C"
   * Return the current number of bytes allocated.
   */
   uint16 osal_heap_mem_used( void );
+
+ /*
+  * Return the size of the largest free run in the first-fit heap.
+  */
+  uint16 osal_heap_largest_free( void );
+
+ /*
+  * Return the first-fit heap fragmentation in percent.
+  */
+  uint8 osal_heap_fragmentation( void );
+#endif
+
+#if ( OSALMEM_SLABS )
+ /*
+  * Return the usage counters of a size-class slab.
+  */
+  uint8 osal_heap_slab_stats( uint8 idx, osalMemSlabStat_t *pStat );
 #endif
 
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
@@ -55,6 +55,18 @@ extern "C"
  * CONSTANTS
  */
 
+// Set to TRUE to compact NV pages in slices from the OSAL idle loop.
+#if !defined OSAL_NV_IDLE_COMPACT
+#define OSAL_NV_IDLE_COMPACT  FALSE
+#endif
+
+/* Counters that osal_nv_lease() keeps: the NWK key frame counter and one per APS and
+ * TC link key slot, ZDSECMGR_DEVICE_MAX and ZDSECMGR_TC_DEVICE_MAX, 3 and 1 by default.
+ */
+#if !defined OSAL_NV_LEASE_CNT
+#define OSAL_NV_LEASE_CNT     5
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -63,6 +75,34 @@ extern "C"
  * TYPEDEFS
  */
 
+// Wear and usage of one NV page, as reported by osal_nv_page_stat().
+typedef struct
+{
+  uint16 eraseCnt;  // Times the page was erased, saturating at 0xFFFE.
+  uint16 freeLen;   // Bytes left after the last item.
+  uint16 lostLen;   // Bytes of deleted or superseded items, reclaimed by compaction.
+  uint8 reserve;    // TRUE for the erased page kept as the target of compaction.
+} osalNvPageStat_t;
+
+// Cost of the page scans done by the last osal_nv_init(), as reported by osal_nv_boot_stat().
+typedef struct
+{
+  uint32 chkBytes;  // Item data bytes read back to verify checksums.
+  uint16 hdrCnt;    // Headers of items not deleted that were read.
+  uint8 sumScans;   // Page scans that could trust a page summary.
+  uint8 fullScans;  // Page scans that had to verify every item.
+} osalNvBootStat_t;
+
+// Use of the NV hot item cache since osal_nv_init(), as reported by osal_nv_hot_stat().
+typedef struct
+{
+  uint32 hits;      // Lookups answered by the cache.
+  uint32 misses;    // Lookups that had to search for the item.
+  uint16 evicts;    // Entries given up to another item.
+  uint8 size;       // Entries in the cache, OSAL_NV_MAX_HOT.
+  uint8 used;       // Entries holding an item.
+} osalNvHotStat_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -101,6 +141,49 @@ extern uint16 osal_nv_item_len( uint16 id );
  */
 extern uint8 osal_nv_delete( uint16 id, uint16 len );
 
+/*
+ * Stage the following NV writes in RAM until osal_nv_commit().
+ */
+extern uint8 osal_nv_begin( void );
+
+/*
+ * Write the staged NV items as one update that survives power loss, or none of them if a
+ * write of the transaction failed.
+ */
+extern uint8 osal_nv_commit( void );
+
+/*
+ * Record a new lease end of a counter in the counter journal.
+ */
+extern uint8 osal_nv_lease( uint16 id, uint32 end );
+
+/*
+ * Get the last lease end recorded for a counter.
+ */
+extern uint32 osal_nv_lease_end( uint16 id );
+
+#if OSAL_NV_IDLE_COMPACT
+/*
+ * Do a slice of NV page compaction while idle.
+ */
+extern uint8 osal_nv_compact( void );
+#endif
+
+/*
+ * Get the wear and usage of an NV page.
+ */
+extern uint8 osal_nv_page_stat( uint8 idx, osalNvPageStat_t *pStat );
+
+/*
+ * Get the cost of the last NV initialization.
+ */
+extern void osal_nv_boot_stat( osalNvBootStat_t *pStat );
+
+/*
+ * Get the use of the NV hot item cache.
+ */
+extern void osal_nv_hot_stat( osalNvHotStat_t *pStat );
+
 /*********************************************************************
 *********************************************************************/
 
@@ -58,6 +58,10 @@ extern "C"
  */
 #define OSAL_TIMERS_MAX_TIMEOUT 0xFFFF
 
+// Longest osal_start_long_timer() timeout, 0xFFFF periods of
+// OSAL_TIMERS_MAX_TIMEOUT plus one more short of a period (~49.7 days)
+#define OSAL_TIMERS_MAX_LONG_TIMEOUT 0xFFFEFFFFUL
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -85,6 +89,16 @@ extern "C"
    */
   extern uint8 osal_start_reload_timer( uint8 taskID, uint16 event_id, uint16 timeout_value );
 
+  /*
+   * Set a Timer with a 32-bit timeout
+   */
+  extern uint8 osal_start_long_timer( uint8 taskID, uint16 event_id, uint32 timeout_value );
+
+  /*
+   * Set a Timer to expire when the system clock reaches a deadline
+   */
+  extern uint8 osal_start_deadline_timer( uint8 taskID, uint16 event_id, uint32 deadline );
+
   /*
    * Stop a Timer
    */
@@ -95,6 +109,11 @@ extern "C"
    */
   extern uint16 osal_get_timeoutEx( uint8 task_id, uint16 event_id );
 
+  /*
+   * Get the time left of a Timer, including long timers.
+   */
+  extern uint32 osal_get_long_timeout( uint8 task_id, uint16 event_id );
+
   /*
    * Simulated Timer Interrupt Service Routine
    */
@@ -131,7 +131,7 @@ extern "C"
 
 
 // APS Layer NV item IDs
-#define ZCD_NV_BINDING_TABLE              0x0041
+#define ZCD_NV_BINDING_TABLE              0x0041     // Old single item table, moved to the blocks below
 #define ZCD_NV_GROUP_TABLE                0x0042
 #define ZCD_NV_APS_FRAME_RETRIES          0x0043
 #define ZCD_NV_APS_ACK_WAIT_DURATION      0x0044
@@ -173,7 +173,7 @@ extern "C"
 #define ZCD_NV_ZDO_DIRECT_CB              0x008F
 
 // ZCL NV item IDs
-#define ZCD_NV_SCENE_TABLE                0x0091
+#define ZCD_NV_SCENE_TABLE                0x0091     // Old single item table, moved to the records below
 
 // Non-standard NV item IDs
 #define ZCD_NV_SAPI_ENDPOINT              0x00A1
@@ -221,6 +221,16 @@ extern "C"
 // NV Items Reserved for applications (user applications)
 // 0x0401  0x0FFF
 
+// NV Items Reserved for ZCL Scene Table entries, one per scene slot
+// 0x1001 - 0x10FF
+#define ZCD_NV_SCENE_DATA_START           0x1001     // Scene record
+#define ZCD_NV_SCENE_DATA_END             0x10FF
+
+// NV Items Reserved for Binding Table entries, NV_BIND_BLOCK_RECS per item
+// 0x1101 - 0x11FF
+#define ZCD_NV_BINDING_DATA_START         0x1101     // Binding record block
+#define ZCD_NV_BINDING_DATA_END           0x11FF
+
 
 // ZCD_NV_STARTUP_OPTION values
 //   These are bit weighted - you can OR these together.
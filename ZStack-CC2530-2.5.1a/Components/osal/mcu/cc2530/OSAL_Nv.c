@@ -50,6 +50,7 @@
 #include "hal_adc.h"
 #include "hal_flash.h"
 #include "hal_types.h"
+#include "OSAL.h"
 #include "OSAL_Nv.h"
 #include "ZComDef.h"
 
@@ -68,6 +69,63 @@
 #define OSAL_NV_ZEROED_ID       0x0000
 // Reserve MSB of Id to signal a search for the "old" source copy (new write interrupted/failed.)
 #define OSAL_NV_SOURCE_ID       0x8000
+/* An item staged by osal_nv_commit() is first written as a "shadow" copy under its Id with the
+ * MSB set, which no search can mistake for the item itself. The checksummed write of the list of
+ * the staged Ids as item OSAL_NV_TXN_ID is the commit point; after it the shadows are copied over
+ * the items, again at osal_nv_init() if a reset intervened, and before it they are discarded.
+ */
+#define OSAL_NV_SHADOW_ID       0x8000
+#define OSAL_NV_TXN_ID          0x7FFE
+/* A summary item records the count and the sum of the header checksums of the items written
+ * to its page since the previous good summary, all of which were verified when it was written.
+ * As long as the headers still add up to it, osal_nv_init() takes those checksums as good
+ * instead of reading back all of the data. Summaries are written at the end of a compaction and
+ * by osal_nv_init() once it has verified OSAL_NV_SUMMARY_MIN bytes or more past the last one;
+ * they are neither looked up nor compacted.
+ */
+#define OSAL_NV_SUMMARY_ID      0x7FFD
+/* The counter journal item holds the leases of counters as records appended in place to its
+ * erased data, so it has no checksum. Its first record is the seal, written last when a journal
+ * is started, with the sequence number that tells the newest journal; an unsealed journal is
+ * discarded. A full journal is started again with the last lease of each counter.
+ */
+#define OSAL_NV_LEASE_ID        0x7FFC
+#define OSAL_NV_LEASE_SEAL      0x0000
+
+// Set to FALSE to stop writing page summaries; existing ones are still used.
+#if !defined OSAL_NV_PAGE_SUMMARY
+#define OSAL_NV_PAGE_SUMMARY    TRUE
+#endif
+#if !defined OSAL_NV_SUMMARY_MIN
+#define OSAL_NV_SUMMARY_MIN     128
+#endif
+
+// Maximum number of items staged by one transaction; a write to any other fails the transaction.
+#if !defined OSAL_NV_TXN_MAX
+#define OSAL_NV_TXN_MAX         4
+#endif
+
+// Records per counter journal, more than the OSAL_NV_LEASE_CNT counters kept.
+#if !defined OSAL_NV_LEASE_RECS
+#define OSAL_NV_LEASE_RECS      32
+#endif
+#if ( OSAL_NV_LEASE_RECS <= OSAL_NV_LEASE_CNT )
+#error "OSAL_NV_LEASE_RECS shall be more than OSAL_NV_LEASE_CNT."
+#endif
+#define OSAL_NV_LEASE_LEN      (OSAL_NV_LEASE_RECS * sizeof( osalNvLease_t ))
+
+#if OSAL_NV_IDLE_COMPACT
+/* osal_nv_compact() starts compacting when fewer than OSAL_NV_COMPACT_FREE bytes are left after
+ * the last item of the pages in use, picking the page that reclaims the most, if at least a
+ * quarter of that. Each call then moves about OSAL_NV_COMPACT_SLICE bytes of items.
+ */
+#if !defined OSAL_NV_COMPACT_FREE
+#define OSAL_NV_COMPACT_FREE   (OSAL_NV_PAGE_SIZE / 4)
+#endif
+#if !defined OSAL_NV_COMPACT_SLICE
+#define OSAL_NV_COMPACT_SLICE   128
+#endif
+#endif
 
 // In case pages 0-1 are ever used, define a null page value.
 #define OSAL_NV_PAGE_NULL       0
@@ -77,14 +135,31 @@
 
 #define OSAL_NV_WORD_SIZE       HAL_FLASH_WORD_SIZE
 
+/* Bytes moved per HalFlashRead()/HalFlashWrite() burst when comparing, copying or checksumming
+ * item data; a multiple of OSAL_NV_WORD_SIZE, sized for the stack.
+ */
+#if !defined OSAL_NV_BURST_SIZE
+#define OSAL_NV_BURST_SIZE     (OSAL_NV_WORD_SIZE * 4)
+#endif
+
 #define OSAL_NV_PAGE_HDR_OFFSET 0
 
-#define OSAL_NV_MAX_HOT         3
-static const uint16 hotIds[OSAL_NV_MAX_HOT] = {
-  ZCD_NV_NWKKEY,
-  ZCD_NV_NWK_ACTIVE_KEY_INFO,
-  ZCD_NV_NWK_ALTERN_KEY_INFO,
-};
+/* Number of items whose location is kept in the hot item cache. The cache learns which Ids
+ * are read and written most and lets them skip findItem(). 0 disables the cache.
+ */
+#if !defined OSAL_NV_MAX_HOT
+#define OSAL_NV_MAX_HOT         4
+#endif
+
+// A hit on an entry whose count is at this ceiling halves every count, so that old use fades.
+#define OSAL_NV_HOT_USE_MAX     0xFF
+
+/* Number of items kept in the RAM directory that lets findItem() skip the flash walk. Items
+ * beyond this count still work, they are just found by walking the pages. 0 disables the index.
+ */
+#if !defined OSAL_NV_INDEX_CNT
+#define OSAL_NV_INDEX_CNT       0
+#endif
 
 /*********************************************************************
  * MACROS
@@ -151,6 +226,49 @@ typedef struct
 #define OSAL_NV_PAGE_HDR_SIZE  8
 #define OSAL_NV_PAGE_HDR_HALF (OSAL_NV_PAGE_HDR_SIZE / 2)
 
+// Data of the OSAL_NV_SUMMARY_ID item.
+typedef struct
+{
+  uint16 cnt;   // Count of the items summarized.
+  uint16 sum;   // Sum of their header checksums.
+} osalNvSum_t;
+
+// A record of the counter journal, two Flash-WORDs; 'chk' shows one cut short by a reset.
+typedef struct
+{
+  uint16 id;    // Counter Id, or OSAL_NV_LEASE_SEAL.
+  uint16 chk;
+  uint32 end;   // Lease end, or the journal sequence number in the seal.
+} osalNvLease_t;
+
+#if OSAL_NV_INDEX_CNT
+typedef struct
+{
+  uint16 id;
+  uint16 off;   // Offset of the item data, as returned by findItem().
+  uint8  pg;
+} osalNvIdx_t;
+#endif
+
+#if OSAL_NV_MAX_HOT
+typedef struct
+{
+  uint16 id;
+  uint16 off;   // Offset of the item data, as returned by findItem().
+  uint8  pg;
+  uint8  use;   // Hits, aged by halving, or misses survived while the least used.
+} osalNvHot_t;
+#endif
+
+// An item staged by a transaction, followed by its 'len' data bytes.
+typedef struct osalNvTxnItem
+{
+  struct osalNvTxnItem *next;
+  uint16 id;
+  uint16 len;
+  uint8  dirty;
+} osalNvTxnItem_t;
+
 typedef enum
 {
   eNvXfer,
@@ -169,9 +287,10 @@ typedef enum
  * GLOBAL VARIABLES
  */
 
-#ifndef OAD_KEEP_NV_PAGES
+#if !defined OAD_KEEP_NV_PAGES && !defined HAL_MCU_HOST
 // When NV pages are to remain intact during OAD download,
 // the image itself should not include NV pages.
+// The host has no flash segment to reserve: hal_flash.c keeps the pages.
 #pragma location="ZIGNV_ADDRESS_SPACE"
 __no_init uint8 _nvBuf[OSAL_NV_PAGES_USED * OSAL_NV_PAGE_SIZE];
 #pragma required=_nvBuf
@@ -189,12 +308,61 @@ static uint16 pgLost[OSAL_NV_PAGES_USED];
 
 static uint8 pgRes;  // Page reserved for item compacting transfer.
 
+// Count of the erases of each page, also kept in the spare half-word of its header.
+static uint16 pgErase[OSAL_NV_PAGES_USED];
+
+#if OSAL_NV_IDLE_COMPACT
+// Page being compacted by osal_nv_compact(), OSAL_NV_PAGE_NULL if none.
+static uint8 bgPg = OSAL_NV_PAGE_NULL;
+// Offset of the next item header of 'bgPg' to transfer.
+static uint16 bgOff;
+#endif
+
 // Saving ~100 code bytes to move a uint8* parameter/return value from findItem() to a global.
 static uint8 findPg;
 
-// NV page and offsets for hot items.
-static uint8 hotPg[OSAL_NV_MAX_HOT];
-static uint16 hotOff[OSAL_NV_MAX_HOT];
+#if OSAL_NV_MAX_HOT
+// Location and use count of the hot items, an Id of zero marking a free entry.
+static osalNvHot_t hotTbl[OSAL_NV_MAX_HOT];
+#endif
+// Hit and miss counts of the hot item cache since osal_nv_init().
+static osalNvHotStat_t nvHot;
+
+// Items staged since osal_nv_begin().
+static osalNvTxnItem_t *nvTxnList;
+static uint8 nvTxnOpen;
+// A write of the open transaction failed, so its commit must write nothing.
+static uint8 nvTxnBroken;
+// A commit passed its commit point but failed to finish; osal_nv_init() must complete it.
+static uint8 nvTxnPending;
+// The osal_nv_init() page scans met a commit record or a shadow copy.
+static uint8 nvTxnSeen;
+
+// Cost of the last osal_nv_init() page scans.
+static osalNvBootStat_t nvBoot;
+
+// Last lease of each counter, a free entry has the erased Id.
+static osalNvLease_t leaseTbl[OSAL_NV_LEASE_CNT];
+// Page and data offset of the counter journal; OSAL_NV_PAGE_NULL if there is none.
+static uint8 leasePg;
+static uint16 leaseOff;
+// Where the journal was copied from by a compaction not yet cleaned up.
+static uint8 leaseSrcPg;
+static uint16 leaseSrcOff;
+// Data length of the journal and offset of its first free record.
+static uint16 leaseLen;
+static uint16 leaseNext;
+static uint32 leaseSeq;
+
+#if OSAL_NV_INDEX_CNT
+// Page and offset of the live items, sorted by Id.
+static osalNvIdx_t nvIdx[OSAL_NV_INDEX_CNT];
+static uint16 nvIdxCnt;
+// Some items did not fit in the index, so a miss must still walk the pages.
+static uint8 nvIdxFull;
+// The index is not built yet or lost entries to an aborted compaction.
+static uint8 nvIdxStale = TRUE;
+#endif
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -206,6 +374,17 @@ static void   setPageUse( uint8 pg, uint8 inUse );
 static uint16 initPage( uint8 pg, uint16 id, uint8 findDups );
 static void   erasePage( uint8 pg );
 static uint8  compactPage( uint8 srcPg, uint16 skipId );
+static uint8  compactClean( void );
+static uint8  compactItems( uint8 srcPg, uint16 *pOff, uint16 skipId, uint16 budget );
+static uint16 sumCheck( uint8 pg, osalNvSum_t *pSum );
+#if OSAL_NV_PAGE_SUMMARY
+static void   sumWrite( uint8 pg, uint16 min );
+#endif
+#if OSAL_NV_IDLE_COMPACT
+static void   compactFinish( void );
+#else
+#define       compactFinish()
+#endif
 
 static uint16 findItem( uint16 id );
 static uint8  initItem( uint8 flag, uint16 id, uint16 len, void *buf );
@@ -222,8 +401,38 @@ static void   writeBuf( uint8 pg, uint16 offset, uint16 len, uint8 *buf );
 static void   xferBuf( uint8 srcPg, uint16 srcOff, uint8 dstPg, uint16 dstOff, uint16 len );
 
 static uint8  writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag );
-static uint8  hotItem(uint16 id);
-static void   hotItemUpdate(uint8 pg, uint16 off, uint16 id);
+static uint16 hotFind( uint16 id );
+#if OSAL_NV_MAX_HOT
+static uint8  hotItem( uint16 id );
+#endif
+static void   hotItemAdmit( uint8 pg, uint16 off, uint16 id );
+static void   hotItemUpdate( uint8 pg, uint16 off, uint16 id );
+static void   hotItemRemove( uint16 id );
+static void   hotItemPurge( uint8 pg );
+
+static osalNvTxnItem_t *nvTxnFind( uint16 id );
+static osalNvTxnItem_t *nvTxnGet( uint16 id );
+static void   nvTxnDrop( uint16 id );
+static uint16 nvTxnShadow( uint16 id, uint8 zero );
+static uint8  nvTxnApply( uint16 id );
+static void   nvTxnEnd( void );
+static void   nvTxnRecover( void );
+
+static uint16 leaseChk( osalNvLease_t *pRec );
+static uint8  leaseSlot( uint16 id );
+static uint8  leaseWrite( uint8 pg, uint16 off, uint16 id, uint32 end );
+static void   leaseInit( void );
+static void   leaseFound( uint8 pg, uint16 off, osalNvHdr_t *pHdr );
+static uint8  leaseMove( uint8 srcPg, uint16 srcOff, osalNvHdr_t *pHdr );
+static uint8  leaseRoll( void );
+
+#if OSAL_NV_INDEX_CNT
+static void   nvIdxBuild( void );
+static uint16 nvIdxSearch( uint16 id );
+static void   nvIdxUpdate( uint8 pg, uint16 off, uint16 id );
+static void   nvIdxRemove( uint16 id );
+static void   nvIdxPurge( uint8 pg );
+#endif
 
 /*********************************************************************
  * @fn      initNV
@@ -242,11 +451,25 @@ static uint8 initNV( void )
   uint8 pg;
 
   pgRes = OSAL_NV_PAGE_NULL;
+  leasePg = OSAL_NV_PAGE_NULL;
+  leaseSrcPg = OSAL_NV_PAGE_NULL;
+  (void)osal_memset( &nvBoot, 0, sizeof( nvBoot ) );
+  (void)osal_memset( &nvHot, 0, sizeof( nvHot ) );
+#if OSAL_NV_MAX_HOT
+  (void)osal_memset( hotTbl, 0, sizeof( hotTbl ) );
+#endif
+  nvTxnSeen = FALSE;
+#if OSAL_NV_IDLE_COMPACT
+  bgPg = OSAL_NV_PAGE_NULL;  // A slice interrupted by a reset is recovered as any compaction.
+#endif
 
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
     HalFlashRead(pg, OSAL_NV_PAGE_HDR_OFFSET, (uint8 *)(&pgHdr), OSAL_NV_HDR_SIZE);
 
+    // The count is lost if a reset comes between an erase and its rewrite; restart it then.
+    pgErase[pg - OSAL_NV_PAGE_BEG] = (pgHdr.spare == OSAL_NV_ERASED_ID) ? 0 : pgHdr.spare;
+
     if ( pgHdr.active == OSAL_NV_ERASED_ID )
     {
       if ( pgRes == OSAL_NV_PAGE_NULL )
@@ -316,6 +539,9 @@ static uint8 initNV( void )
     }
   }
 
+  // Before a compacted page left over is erased below, so that its journal copy is let go.
+  leaseInit();
+
   if ( pgRes == OSAL_NV_PAGE_NULL )
   {
     uint8 idx, mostLost = 0;
@@ -341,6 +567,25 @@ static uint8 initNV( void )
     erasePage( pgRes );  // The last page erase had been interrupted by a power-cycle.
   }
 
+#if OSAL_NV_PAGE_SUMMARY
+  // Spare the next boot from verifying again what this one just did.
+  if ( OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+    {
+      if ( pg != pgRes )
+      {
+        sumWrite( pg, OSAL_NV_SUMMARY_MIN );
+      }
+    }
+  }
+#endif
+
+#if OSAL_NV_INDEX_CNT
+  nvIdxBuild();
+#endif
+  nvTxnRecover();
+
   return TRUE;
 }
 
@@ -391,8 +636,25 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
 {
   uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
   uint16 sz, lost = 0;
+  uint16 trust = OSAL_NV_PAGE_HDR_SIZE;
   osalNvHdr_t hdr;
 
+  if ( id == OSAL_NV_ITEM_NULL )
+  {
+    osalNvSum_t sum;
+
+    // The checksums of the items before 'trust' were verified when they were summarized.
+    trust = sumCheck( pg, &sum );
+    if ( trust != OSAL_NV_PAGE_HDR_SIZE )
+    {
+      nvBoot.sumScans++;
+    }
+    else
+    {
+      nvBoot.fullScans++;
+    }
+  }
+
   do
   {
     HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
@@ -415,7 +677,7 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
 
     offset += OSAL_NV_HDR_SIZE;
 
-    if ( hdr.id != OSAL_NV_ZEROED_ID )
+    if ( (hdr.id != OSAL_NV_ZEROED_ID) && (hdr.id != OSAL_NV_SUMMARY_ID) )
     {
       /* This trick allows function to do double duty for findItem() without
        * compromising its essential functionality at powerup initialization.
@@ -438,11 +700,26 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
       // When invoked from the osal_nv_init(), verify checksums and find & zero any duplicates.
       else
       {
-        if ( hdr.chk == calcChkF( pg, offset, hdr.len ) )
+        nvBoot.hdrCnt++;
+        if ( (hdr.id == OSAL_NV_TXN_ID) || (hdr.id & OSAL_NV_SHADOW_ID) )
+        {
+          nvTxnSeen = TRUE;
+        }
+        if ( offset >= trust )
+        {
+          nvBoot.chkBytes += sz;
+        }
+
+        if ( (offset < trust) || (hdr.id == OSAL_NV_LEASE_ID) ||
+             (hdr.chk == calcChkF( pg, offset, hdr.len )) )
         {
           if ( findDups )
           {
-            if ( hdr.stat == OSAL_NV_ERASED_ID )
+            /* A shadow Id would match its item as a source copy search, so skip it.
+             * The copies of the counter journal are sorted out by leaseInit().
+             */
+            if ( (hdr.stat == OSAL_NV_ERASED_ID) && ((hdr.id & OSAL_NV_SHADOW_ID) == 0) &&
+                 (hdr.id != OSAL_NV_LEASE_ID) )
             {
               /* The trick of setting the MSB of the item Id causes the logic
                * immediately above to return a valid page only if the header 'stat'
@@ -457,7 +734,7 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
             }
           }
           // Any "old" item immediately exits and triggers the N^2 exhaustive initialization.
-          else if ( hdr.stat != OSAL_NV_ERASED_ID )
+          else if ( (hdr.stat != OSAL_NV_ERASED_ID) && (hdr.id != OSAL_NV_LEASE_ID) )
           {
             return OSAL_NV_ERASED_ID;
           }
@@ -494,8 +771,40 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
  */
 static void erasePage( uint8 pg )
 {
+  uint8 tmp[OSAL_NV_WORD_SIZE];
+  uint16 cnt = pgErase[pg - OSAL_NV_PAGE_BEG];
+
   HalFlashErase(pg);
 
+  // Carry the erase count over in the spare half of the page header, the rest left erased.
+  if ( cnt < (OSAL_NV_ERASED_ID - 1) )
+  {
+    cnt++;
+  }
+  pgErase[pg - OSAL_NV_PAGE_BEG] = cnt;
+  tmp[0] = OSAL_NV_ERASED;
+  tmp[1] = OSAL_NV_ERASED;
+  tmp[2] = LO_UINT16( cnt );
+  tmp[3] = HI_UINT16( cnt );
+  writeWord( pg, OSAL_NV_PG_XFER, tmp );
+
+#if OSAL_NV_INDEX_CNT
+  nvIdxPurge(pg);
+#endif
+  hotItemPurge(pg);
+
+  // A journal copied onto an aborted compaction target is still at its source.
+  if ( leasePg == pg )
+  {
+    leasePg = leaseSrcPg;
+    leaseOff = leaseSrcOff;
+    leaseSrcPg = OSAL_NV_PAGE_NULL;
+  }
+  else if ( leaseSrcPg == pg )
+  {
+    leaseSrcPg = OSAL_NV_PAGE_NULL;
+  }
+
   pgOff[pg - OSAL_NV_PAGE_BEG] = OSAL_NV_PAGE_HDR_SIZE;
   pgLost[pg - OSAL_NV_PAGE_BEG] = 0;
 }
@@ -529,22 +838,92 @@ static void erasePage( uint8 pg )
  */
 static uint8 compactPage( uint8 srcPg, uint16 skipId )
 {
-  uint16 srcOff;
+  uint16 srcOff = OSAL_NV_PAGE_HDR_SIZE;
   uint8 rtrn;
 
+  if ( !compactClean() )
+  {
+    return FALSE;
+  }
+
+  rtrn = compactItems( srcPg, &srcOff, skipId, OSAL_NV_PAGE_SIZE );
+
+  if (rtrn == FALSE)
+  {
+    erasePage(pgRes);
+  }
+  else if (skipId == OSAL_NV_ITEM_NULL)
+  {
+    COMPACT_PAGE_CLEANUP(srcPg);
+  }
+  // else invoking function must cleanup.
+
+  return rtrn;
+}
+
+/*********************************************************************
+ * @fn      compactClean
+ *
+ * @brief   Verify that the reserve page is erased before compacting onto it,
+ *          except for the erase count kept in the spare half of its header.
+ *
+ * @param   none
+ *
+ * @return  TRUE if the reserve page is clean; otherwise it is erased again
+ *          and FALSE is returned.
+ */
+static uint8 compactClean( void )
+{
+  uint16 offset;
+
   // To minimize code size, only check for a clean page here where it's absolutely required.
-  for (srcOff = 0; srcOff < OSAL_NV_PAGE_SIZE; srcOff++)
+  for (offset = 0; offset < OSAL_NV_PAGE_SIZE; offset += OSAL_NV_BURST_SIZE)
   {
-    HalFlashRead(pgRes, srcOff, &rtrn, 1);
-    if (rtrn != OSAL_NV_ERASED)
+    uint8 idx, tmp[OSAL_NV_BURST_SIZE];
+
+    HalFlashRead(pgRes, offset, tmp, OSAL_NV_BURST_SIZE);
+
+    // The spare word of the header may be in a later burst than the header's first word.
+    if ((offset <= (OSAL_NV_PAGE_HDR_OFFSET + OSAL_NV_PG_SPARE)) &&
+        ((OSAL_NV_PAGE_HDR_OFFSET + OSAL_NV_PG_SPARE) < (offset + OSAL_NV_BURST_SIZE)))
     {
-      erasePage(pgRes);
-      return FALSE;
+      idx = OSAL_NV_PAGE_HDR_OFFSET + OSAL_NV_PG_SPARE - offset;
+      tmp[idx] = tmp[idx+1] = OSAL_NV_ERASED;
+    }
+
+    for (idx = 0; idx < OSAL_NV_BURST_SIZE; idx++)
+    {
+      if (tmp[idx] != OSAL_NV_ERASED)
+      {
+        erasePage(pgRes);
+        return FALSE;
+      }
     }
   }
 
-  srcOff = OSAL_NV_PAGE_HDR_SIZE;
-  rtrn = TRUE;
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      compactItems
+ *
+ * @brief   Transfer the valid items of a page onto the reserve page, starting
+ *          at '*pOff' and stopping once about 'budget' bytes have been moved,
+ *          so that a compaction can be done in slices.
+ *
+ * @param   srcPg - Valid NV page being compacted.
+ * @param   pOff - In: offset of the next item header to transfer.
+ *                 Out: where to resume, OSAL_NV_PAGE_SIZE when the page is done.
+ * @param   skipId - Item Id to not compact.
+ * @param   budget - Byte count after which to stop.
+ *
+ * @return  TRUE if the items were transferred successfully, FALSE otherwise.
+ */
+static uint8 compactItems( uint8 srcPg, uint16 *pOff, uint16 skipId, uint16 budget )
+{
+  uint16 srcOff = *pOff;
+  uint16 used = 0;
+  uint8 rtrn = TRUE;
 
   while ( srcOff < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE ) )
   {
@@ -555,6 +934,7 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
 
     if ( hdr.id == OSAL_NV_ERASED_ID )
     {
+      srcOff = OSAL_NV_PAGE_SIZE;
       break;
     }
 
@@ -563,6 +943,7 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
 
     if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - srcOff) )
     {
+      srcOff = OSAL_NV_PAGE_SIZE;
       break;
     }
 
@@ -573,10 +954,21 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
     }
 
     srcOff += OSAL_NV_HDR_SIZE;
+    used += OSAL_NV_HDR_SIZE;
 
-    if ( (hdr.id != OSAL_NV_ZEROED_ID) && (hdr.id != skipId) )
+    if ( (hdr.id != OSAL_NV_ZEROED_ID) && (hdr.id != skipId) && (hdr.id != OSAL_NV_SUMMARY_ID) )
     {
-      if ( hdr.chk == calcChkF( srcPg, srcOff, hdr.len ) )
+      if ( hdr.id == OSAL_NV_LEASE_ID )
+      {
+        if ( !leaseMove( srcPg, srcOff, &hdr ) )
+        {
+          rtrn = FALSE;
+          break;
+        }
+
+        used += sz;
+      }
+      else if ( hdr.chk == calcChkF( srcPg, srcOff, hdr.len ) )
       {
         /* Prevent excessive re-writes to item header caused by numerous, rapid, & successive
          * OSAL_Nv interruptions caused by resets.
@@ -601,6 +993,9 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
             else
             {
               hotItemUpdate(pgRes, dstOff, hdr.id);
+#if OSAL_NV_INDEX_CNT
+              nvIdxUpdate(pgRes, dstOff, hdr.id);
+#endif
             }
           }
           else
@@ -614,25 +1009,163 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
           rtrn = FALSE;
           break;
         }
+
+        used += sz;
       }
     }
 
     srcOff += sz;
+
+    if ( used >= budget )
+    {
+      break;
+    }
   }
 
-  if (rtrn == FALSE)
+  if ( srcOff >= (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
   {
-    erasePage(pgRes);
+    srcOff = OSAL_NV_PAGE_SIZE;
   }
-  else if (skipId == OSAL_NV_ITEM_NULL)
+  *pOff = srcOff;
+
+#if OSAL_NV_PAGE_SUMMARY
+  if ( rtrn && (srcOff == OSAL_NV_PAGE_SIZE) )
   {
-    COMPACT_PAGE_CLEANUP(srcPg);
+    sumWrite( pgRes, 0 );  // The items were all verified as they were transferred.
   }
-  // else invoking function must cleanup.
+#endif
 
   return rtrn;
 }
 
+/*********************************************************************
+ * @fn      sumCheck
+ *
+ * @brief   Walk the item headers of a page, checking each summary item met
+ *          against the items since the previous good one.
+ *
+ * @param   pg - Valid NV page.
+ * @param   pSum - Filled in with the count and the checksum sum of the items
+ *                 after the last good summary.
+ *
+ * @return  The offset up to which the item checksums can be taken as good;
+ *          OSAL_NV_PAGE_HDR_SIZE if there is no good summary.
+ */
+static uint16 sumCheck( uint8 pg, osalNvSum_t *pSum )
+{
+  uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+  uint16 trust = OSAL_NV_PAGE_HDR_SIZE;
+
+  pSum->cnt = 0;
+  pSum->sum = 0;
+
+  while ( offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+  {
+    osalNvHdr_t hdr;
+    uint16 sz;
+
+    HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+    sz = OSAL_NV_DATA_SIZE( hdr.len );
+    if ( (hdr.id == OSAL_NV_ERASED_ID) ||
+         (sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset)) )
+    {
+      break;
+    }
+    offset += OSAL_NV_HDR_SIZE;
+
+    if ( (hdr.id == OSAL_NV_SUMMARY_ID) && (hdr.len == sizeof( osalNvSum_t )) &&
+         (hdr.chk == calcChkF( pg, offset, hdr.len )) )
+    {
+      osalNvSum_t sum;
+
+      HalFlashRead(pg, offset, (uint8 *)(&sum), sizeof( osalNvSum_t ));
+
+      if ( (sum.cnt == pSum->cnt) && (sum.sum == pSum->sum) )
+      {
+        trust = offset;
+        pSum->cnt = 0;
+        pSum->sum = 0;
+      }
+    }
+    // A summary that does not add up counts as an item, for the next good one to cover.
+    else
+    {
+      pSum->cnt++;
+      pSum->sum += hdr.chk;
+    }
+
+    offset += sz;
+  }
+
+  return trust;
+}
+
+#if OSAL_NV_PAGE_SUMMARY
+/*********************************************************************
+ * @fn      sumWrite
+ *
+ * @brief   Append a summary of the items written since the last good summary
+ *          of a page, which the caller must have verified. If the write fails,
+ *          the summary just won't add up.
+ *
+ * @param   pg - Valid NV page.
+ * @param   min - Byte count of items past the last good summary below which
+ *                no summary is worth writing.
+ *
+ * @return  none
+ */
+static void sumWrite( uint8 pg, uint16 min )
+{
+  uint8 idx = pg - OSAL_NV_PAGE_BEG;
+  osalNvSum_t sum;
+
+  if ( OSAL_NV_ITEM_SIZE( sizeof( osalNvSum_t ) ) > (OSAL_NV_PAGE_SIZE - pgOff[idx]) )
+  {
+    return;
+  }
+
+  if ( ((pgOff[idx] - sumCheck( pg, &sum )) >= min) && (sum.cnt != 0) )
+  {
+    if ( writeItem( pg, OSAL_NV_SUMMARY_ID, sizeof( osalNvSum_t ), &sum, TRUE ) )
+    {
+      pgLost[idx] += OSAL_NV_ITEM_SIZE( sizeof( osalNvSum_t ) );
+    }
+  }
+}
+#endif
+
+#if OSAL_NV_IDLE_COMPACT
+/*********************************************************************
+ * @fn      compactFinish
+ *
+ * @brief   Complete the compaction started by osal_nv_compact(), if any, since
+ *          the foreground operations expect no page to be half compacted.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void compactFinish( void )
+{
+  if ( bgPg != OSAL_NV_PAGE_NULL )
+  {
+    uint8 pg = bgPg;
+
+    bgPg = OSAL_NV_PAGE_NULL;
+
+    if ( compactItems( pg, &bgOff, OSAL_NV_ITEM_NULL, OSAL_NV_PAGE_SIZE ) )
+    {
+      COMPACT_PAGE_CLEANUP( pg );
+    }
+    else
+    {
+      erasePage( pgRes );
+    }
+  }
+}
+#endif
+
 /*********************************************************************
  * @fn      findItem
  *
@@ -652,6 +1185,31 @@ static uint16 findItem( uint16 id )
   uint16 off;
   uint8 pg;
 
+#if OSAL_NV_INDEX_CNT
+  // The index only holds live items; a search for the "old" source copy always walks the pages.
+  if ( (id & OSAL_NV_SOURCE_ID) == 0 )
+  {
+    uint16 idx;
+
+    if ( nvIdxStale )
+    {
+      nvIdxBuild();
+    }
+
+    idx = nvIdxSearch( id );
+    if ( (idx < nvIdxCnt) && (nvIdx[idx].id == id) )
+    {
+      findPg = nvIdx[idx].pg;
+      return nvIdx[idx].off;
+    }
+    else if ( !nvIdxFull )
+    {
+      findPg = OSAL_NV_PAGE_NULL;
+      return OSAL_NV_ITEM_NULL;
+    }
+  }
+#endif
+
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
     if ( (off = initPage( pg, id, FALSE )) != OSAL_NV_ITEM_NULL )
@@ -695,24 +1253,40 @@ static uint8 initItem( uint8 flag, uint16 id, uint16 len, void *buf )
 {
   uint16 sz = OSAL_NV_ITEM_SIZE( len );
   uint8 rtrn = OSAL_NV_PAGE_NULL;
-  uint8 cnt = OSAL_NV_PAGES_USED;
-  uint8 pg = pgRes+1;  // Set to 1 after the reserve page to even wear across all available pages.
+  uint8 cnt, pg, fit;
 
-  do {
-    if (pg >= OSAL_NV_PAGE_BEG+OSAL_NV_PAGES_USED)
-    {
-      pg = OSAL_NV_PAGE_BEG;
-    }
-    if ( pg != pgRes )
-    {
-      uint8 idx = pg - OSAL_NV_PAGE_BEG;
-      if ( sz <= (OSAL_NV_PAGE_SIZE - pgOff[idx] + pgLost[idx]) )
+#if OSAL_NV_PAGE_SUMMARY
+  sz += OSAL_NV_ITEM_SIZE( sizeof( osalNvSum_t ) );  // Keep room for osal_nv_init() to summarize.
+#endif
+  compactFinish();
+
+  // Prefer a page with room left, and only compact when no page has.
+  for ( fit = 0; fit < 2; fit++ )
+  {
+    cnt = OSAL_NV_PAGES_USED;
+    pg = pgRes+1;  // Set to 1 after the reserve page to even wear across all available pages.
+
+    do {
+      if (pg >= OSAL_NV_PAGE_BEG+OSAL_NV_PAGES_USED)
       {
-        break;
+        pg = OSAL_NV_PAGE_BEG;
+      }
+      if ( pg != pgRes )
+      {
+        uint8 idx = pg - OSAL_NV_PAGE_BEG;
+        if ( sz <= (OSAL_NV_PAGE_SIZE - pgOff[idx] + (fit ? pgLost[idx] : 0)) )
+        {
+          break;
+        }
       }
+      pg++;
+    } while (--cnt);
+
+    if (cnt)
+    {
+      break;
     }
-    pg++;
-  } while (--cnt);
+  }
 
   if (cnt)
   {
@@ -877,16 +1451,18 @@ static uint16 calcChkF( uint8 pg, uint16 offset, uint16 len )
 {
   uint16 chk = 0;
 
-  len = (len + (OSAL_NV_WORD_SIZE-1)) / OSAL_NV_WORD_SIZE;
+  len = OSAL_NV_DATA_SIZE( len );
 
-  while ( len-- )
+  while ( len )
   {
-    uint8 cnt, tmp[OSAL_NV_WORD_SIZE];
+    uint8 cnt, tmp[OSAL_NV_BURST_SIZE];
+    uint8 num = (len < OSAL_NV_BURST_SIZE) ? (uint8)len : OSAL_NV_BURST_SIZE;
 
-    HalFlashRead(pg, offset, tmp, OSAL_NV_WORD_SIZE);
-    offset += OSAL_NV_WORD_SIZE;
+    HalFlashRead(pg, offset, tmp, num);
+    offset += num;
+    len -= num;
 
-    for ( cnt = 0; cnt < OSAL_NV_WORD_SIZE; cnt++ )
+    for ( cnt = 0; cnt < num; cnt++ )
     {
       chk += tmp[cnt];
     }
@@ -1014,52 +1590,51 @@ static void writeBuf( uint8 dstPg, uint16 dstOff, uint16 len, uint8 *buf )
  * @fn      xferBuf
  *
  * @brief   Xfers an NV buffer from one location to another, enforcing OSAL_NV_WORD_SIZE writes.
+ *          The aligned middle is moved in OSAL_NV_BURST_SIZE bursts, each one read and
+ *          one multi-word (DMA on target) write, in the same order as word by word.
  *
  * @return  none
  */
 static void xferBuf( uint8 srcPg, uint16 srcOff, uint8 dstPg, uint16 dstOff, uint16 len )
 {
   uint8 rem = dstOff % OSAL_NV_WORD_SIZE;
-  uint8 tmp[OSAL_NV_WORD_SIZE];
+  uint8 tmp[OSAL_NV_BURST_SIZE];
+  uint8 num;
 
   if ( rem )
   {
-    dstOff -= rem;
-    HalFlashRead(dstPg, dstOff, tmp, OSAL_NV_WORD_SIZE);
-
-    while ( (rem < OSAL_NV_WORD_SIZE) && len )
+    num = OSAL_NV_WORD_SIZE - rem;
+    if ( num > len )
     {
-      HalFlashRead(srcPg, srcOff, tmp+rem, 1);
-      srcOff++;
-      rem++;
-      len--;
+      num = (uint8)len;
     }
 
+    dstOff -= rem;
+    HalFlashRead(dstPg, dstOff, tmp, OSAL_NV_WORD_SIZE);
+    HalFlashRead(srcPg, srcOff, tmp+rem, num);
+    srcOff += num;
+    len -= num;
+
     writeWord( dstPg, dstOff, tmp );
     dstOff += OSAL_NV_WORD_SIZE;
   }
 
-  rem = len % OSAL_NV_WORD_SIZE;
-  len /= OSAL_NV_WORD_SIZE;
-
-  while ( len-- )
+  while ( len >= OSAL_NV_WORD_SIZE )
   {
-    HalFlashRead(srcPg, srcOff, tmp, OSAL_NV_WORD_SIZE);
-    srcOff += OSAL_NV_WORD_SIZE;
-    writeWord( dstPg, dstOff, tmp );
-    dstOff += OSAL_NV_WORD_SIZE;
+    num = (len < OSAL_NV_BURST_SIZE) ? (uint8)(len - (len % OSAL_NV_WORD_SIZE)) :
+                                        OSAL_NV_BURST_SIZE;
+
+    HalFlashRead(srcPg, srcOff, tmp, num);
+    writeWordM( dstPg, dstOff, tmp, (num / OSAL_NV_WORD_SIZE) );
+    srcOff += num;
+    dstOff += num;
+    len -= num;
   }
 
-  if ( rem )
+  if ( len )
   {
-    uint8 idx = 0;
     HalFlashRead(dstPg, dstOff, tmp, OSAL_NV_WORD_SIZE);
-    while ( rem-- )
-    {
-      HalFlashRead(srcPg, srcOff, tmp+idx, 1);
-      srcOff++;
-      idx++;
-    }
+    HalFlashRead(srcPg, srcOff, tmp, len);
     writeWord( dstPg, dstOff, tmp );
   }
 }
@@ -1106,6 +1681,9 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
         if ( hdr.chk == setChk( pg, offset, hdr.chk ) )
         {
           hotItemUpdate(pg, offset, hdr.id);
+#if OSAL_NV_INDEX_CNT
+          nvIdxUpdate(pg, offset, hdr.id);
+#endif
           rtrn = TRUE;
         }
       }
@@ -1134,51 +1712,1024 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
 }
 
 /*********************************************************************
- * @fn      hotItem
+ * @fn      hotFind
  *
- * @brief   Look for the parameter 'id' in the hot items array.
+ * @brief   Find an item through the hot item cache, falling back to findItem()
+ *          on a miss and then offering the item to the cache.
  *
- * @param   id - A valid NV item Id.
+ * @param   id - Valid NV item Id.
  *
- * @return  A valid index into the hot items if the item is hot; OSAL_NV_MAX_HOT if not.
+ * @return  Offset of the item data, if found; otherwise OSAL_NV_ITEM_NULL.
+ *          The page containing the item is left in 'findPg'.
  */
-static uint8 hotItem(uint16 id)
+static uint16 hotFind( uint16 id )
 {
-  uint8 hotIdx;
+  uint16 off;
+#if OSAL_NV_MAX_HOT
+  uint8 hotIdx = hotItem( id );
 
-  for (hotIdx = 0; hotIdx < OSAL_NV_MAX_HOT; hotIdx++)
+  if ( hotIdx < OSAL_NV_MAX_HOT )
   {
-    if (hotIds[hotIdx] == id)
+    nvHot.hits++;
+    if ( hotTbl[hotIdx].use == OSAL_NV_HOT_USE_MAX )
     {
-      break;
-    }
+      uint8 idx;
+
+      for ( idx = 0; idx < OSAL_NV_MAX_HOT; idx++ )
+      {
+        hotTbl[idx].use >>= 1;
+      }
+    }
+    hotTbl[hotIdx].use++;
+
+    findPg = hotTbl[hotIdx].pg;
+    return hotTbl[hotIdx].off;
+  }
+#endif
+
+  nvHot.misses++;
+  if ( (off = findItem( id )) != OSAL_NV_ITEM_NULL )
+  {
+    hotItemAdmit( findPg, off, id );
+  }
+
+  return off;
+}
+
+#if OSAL_NV_MAX_HOT
+/*********************************************************************
+ * @fn      hotItem
+ *
+ * @brief   Look for the parameter 'id' in the hot item cache.
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  A valid index into the hot items if the item is hot; OSAL_NV_MAX_HOT if not.
+ */
+static uint8 hotItem( uint16 id )
+{
+  uint8 hotIdx;
+
+  for ( hotIdx = 0; hotIdx < OSAL_NV_MAX_HOT; hotIdx++ )
+  {
+    if ( hotTbl[hotIdx].id == id )
+    {
+      break;
+    }
   }
 
   return hotIdx;
 }
+#endif
+
+/*********************************************************************
+ * @fn      hotItemAdmit
+ *
+ * @brief   Offer an item that missed the cache a place in it. The least used entry
+ *          gives way only once its count has run down to zero, each miss taking one
+ *          off it, so that items read once in a while do not push out the busy ones.
+ *
+ * @param   pg - The NV page of the item.
+ * @param   off - The NV page offset of the item data.
+ * @param   id - A valid NV item Id.
+ *
+ * @return  none
+ */
+static void hotItemAdmit( uint8 pg, uint16 off, uint16 id )
+{
+#if OSAL_NV_MAX_HOT
+  uint8 hotIdx, minIdx = 0;
+
+  for ( hotIdx = 0; hotIdx < OSAL_NV_MAX_HOT; hotIdx++ )
+  {
+    if ( hotTbl[hotIdx].id == 0 )
+    {
+      minIdx = hotIdx;
+      break;
+    }
+    else if ( hotTbl[hotIdx].use < hotTbl[minIdx].use )
+    {
+      minIdx = hotIdx;
+    }
+  }
+
+  if ( hotTbl[minIdx].use == 0 )
+  {
+    if ( hotTbl[minIdx].id != 0 )
+    {
+      nvHot.evicts++;
+    }
+    hotTbl[minIdx].id = id;
+    hotTbl[minIdx].pg = pg;
+    hotTbl[minIdx].off = off;
+    hotTbl[minIdx].use = 1;
+  }
+  else
+  {
+    hotTbl[minIdx].use--;
+  }
+#else
+  (void)pg;
+  (void)off;
+  (void)id;
+#endif
+}
+
+/*********************************************************************
+ * @fn      hotItemUpdate
+ *
+ * @brief   If the parameter 'id' is a hot item, update the corresponding hot item data.
+ *
+ * @param   pg - The new NV page corresponding to the hot item.
+ * @param   off - The new NV page offset corresponding to the hot item.
+ * @param   id - A valid NV item Id.
+ *
+ * @return  none
+ */
+static void hotItemUpdate( uint8 pg, uint16 off, uint16 id )
+{
+#if OSAL_NV_MAX_HOT
+  uint8 hotIdx = hotItem( id );
+
+  if ( hotIdx < OSAL_NV_MAX_HOT )
+  {
+    hotTbl[hotIdx].pg = pg;
+    hotTbl[hotIdx].off = off;
+  }
+#else
+  (void)pg;
+  (void)off;
+  (void)id;
+#endif
+}
+
+/*********************************************************************
+ * @fn      hotItemRemove
+ *
+ * @brief   Drop a deleted item from the hot item cache.
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  none
+ */
+static void hotItemRemove( uint16 id )
+{
+#if OSAL_NV_MAX_HOT
+  uint8 hotIdx = hotItem( id );
+
+  if ( hotIdx < OSAL_NV_MAX_HOT )
+  {
+    hotTbl[hotIdx].id = 0;
+    hotTbl[hotIdx].use = 0;
+  }
+#else
+  (void)id;
+#endif
+}
+
+/*********************************************************************
+ * @fn      hotItemPurge
+ *
+ * @brief   Called when a page is erased. Items move off a page before it is erased,
+ *          except when an aborted compaction erases its target; the items are then
+ *          still at their source and are found again at the next miss.
+ *
+ * @param   pg - The NV page erased.
+ *
+ * @return  none
+ */
+static void hotItemPurge( uint8 pg )
+{
+#if OSAL_NV_MAX_HOT
+  uint8 hotIdx;
+
+  for ( hotIdx = 0; hotIdx < OSAL_NV_MAX_HOT; hotIdx++ )
+  {
+    if ( hotTbl[hotIdx].pg == pg )
+    {
+      hotTbl[hotIdx].id = 0;
+      hotTbl[hotIdx].use = 0;
+    }
+  }
+#else
+  (void)pg;
+#endif
+}
+
+#if OSAL_NV_INDEX_CNT
+/*********************************************************************
+ * @fn      nvIdxBuild
+ *
+ * @brief   Rebuild the RAM index by walking the item headers of every page. Normally
+ *          each Id has one live copy; when an interrupted write left two, the copy
+ *          with a good checksum wins, and the newer copy if both are good.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void nvIdxBuild( void )
+{
+  uint8 pg;
+
+  nvIdxCnt = 0;
+  nvIdxFull = FALSE;
+  nvIdxStale = FALSE;
+
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+
+    while ( offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+    {
+      osalNvHdr_t hdr;
+      uint16 sz;
+
+      HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+      if ( hdr.id == OSAL_NV_ERASED_ID )
+      {
+        break;
+      }
+
+      sz = OSAL_NV_DATA_SIZE( hdr.len );
+      if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset) )
+      {
+        break;
+      }
+      offset += OSAL_NV_HDR_SIZE;
+
+      if ( (hdr.id != OSAL_NV_ZEROED_ID) && (hdr.id != OSAL_NV_SUMMARY_ID) &&
+           (hdr.id != OSAL_NV_LEASE_ID) )
+      {
+        uint16 idx = nvIdxSearch( hdr.id );
+        uint8 keep = TRUE;
+
+        if ( (idx < nvIdxCnt) && (nvIdx[idx].id == hdr.id) )
+        {
+          osalNvHdr_t old;
+
+          HalFlashRead(nvIdx[idx].pg, nvIdx[idx].off - OSAL_NV_HDR_SIZE,
+                                                   (uint8 *)(&old), OSAL_NV_HDR_SIZE);
+
+          if ( hdr.chk != calcChkF( pg, offset, hdr.len ) )
+          {
+            keep = FALSE;
+          }
+          else if ( old.chk == calcChkF( nvIdx[idx].pg, nvIdx[idx].off, old.len ) )
+          {
+            keep = ((hdr.stat == OSAL_NV_ERASED_ID) && (old.stat != OSAL_NV_ERASED_ID));
+          }
+        }
+
+        if ( keep )
+        {
+          nvIdxUpdate( pg, offset, hdr.id );
+        }
+      }
+
+      offset += sz;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      nvIdxSearch
+ *
+ * @brief   Binary search of the RAM index.
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  Index of the entry for 'id' if there is one; otherwise the index
+ *          where it would be inserted.
+ */
+static uint16 nvIdxSearch( uint16 id )
+{
+  uint16 lo = 0, hi = nvIdxCnt;
+
+  while ( lo < hi )
+  {
+    uint16 mid = (lo + hi) / 2;
+
+    if ( nvIdx[mid].id < id )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/*********************************************************************
+ * @fn      nvIdxUpdate
+ *
+ * @brief   Record the new location of an item, adding it to the index if needed.
+ *
+ * @param   pg - The NV page of the item.
+ * @param   off - The NV page offset of the item data.
+ * @param   id - A valid NV item Id.
+ *
+ * @return  none
+ */
+static void nvIdxUpdate( uint8 pg, uint16 off, uint16 id )
+{
+  uint16 idx;
+
+  if ( id & OSAL_NV_SHADOW_ID )
+  {
+    return;  // Shadow copies are only ever searched for by nvTxnShadow().
+  }
+  else if ( id == OSAL_NV_SUMMARY_ID )
+  {
+    return;  // Page summaries are only ever read by sumCheck().
+  }
+
+  idx = nvIdxSearch( id );
+  if ( (idx >= nvIdxCnt) || (nvIdx[idx].id != id) )
+  {
+    uint16 cnt;
+
+    if ( nvIdxCnt >= OSAL_NV_INDEX_CNT )
+    {
+      nvIdxFull = TRUE;
+      return;
+    }
+
+    for ( cnt = nvIdxCnt; cnt > idx; cnt-- )
+    {
+      nvIdx[cnt] = nvIdx[cnt-1];
+    }
+    nvIdxCnt++;
+    nvIdx[idx].id = id;
+  }
+
+  nvIdx[idx].pg = pg;
+  nvIdx[idx].off = off;
+}
+
+/*********************************************************************
+ * @fn      nvIdxRemove
+ *
+ * @brief   Remove a deleted item from the index.
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  none
+ */
+static void nvIdxRemove( uint16 id )
+{
+  uint16 idx = nvIdxSearch( id );
+
+  if ( (idx < nvIdxCnt) && (nvIdx[idx].id == id) )
+  {
+    nvIdxCnt--;
+    for ( ; idx < nvIdxCnt; idx++ )
+    {
+      nvIdx[idx] = nvIdx[idx+1];
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      nvIdxPurge
+ *
+ * @brief   Called when a page is erased. Only a compaction that is aborted erases
+ *          a page still holding live items; their old copies remain on the source
+ *          page, so the index is rebuilt from flash at the next lookup.
+ *
+ * @param   pg - The NV page erased.
+ *
+ * @return  none
+ */
+static void nvIdxPurge( uint8 pg )
+{
+  uint16 idx;
+
+  for ( idx = 0; idx < nvIdxCnt; idx++ )
+  {
+    if ( nvIdx[idx].pg == pg )
+    {
+      nvIdxStale = TRUE;
+      break;
+    }
+  }
+}
+#endif
+
+/*********************************************************************
+ * @fn      nvTxnFind
+ *
+ * @brief   Look for an item staged by the open transaction.
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  The staged item, NULL if the item is not staged.
+ */
+static osalNvTxnItem_t *nvTxnFind( uint16 id )
+{
+  osalNvTxnItem_t *pItem = nvTxnList;
+
+  while ( (pItem != NULL) && (pItem->id != id) )
+  {
+    pItem = pItem->next;
+  }
+
+  return pItem;
+}
+
+/*********************************************************************
+ * @fn      nvTxnGet
+ *
+ * @brief   Find a staged item or stage it with a RAM copy of its NV data.
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  The staged item, NULL if the item does not exist, the
+ *          transaction is full or the heap is exhausted.
+ */
+static osalNvTxnItem_t *nvTxnGet( uint16 id )
+{
+  osalNvTxnItem_t *pItem = nvTxnFind( id );
+
+  if ( (pItem == NULL) && (id < OSAL_NV_TXN_ID) )
+  {
+    uint16 len;
+    uint8 cnt = 0;
+
+    for ( pItem = nvTxnList; pItem != NULL; pItem = pItem->next )
+    {
+      cnt++;
+    }
+
+    if ( (cnt < OSAL_NV_TXN_MAX) && ((len = osal_nv_item_len( id )) != 0) &&
+        ((pItem = osal_mem_alloc( sizeof( osalNvTxnItem_t ) + len )) != NULL) )
+    {
+      (void)osal_nv_read( id, 0, len, pItem + 1 );
+      pItem->id = id;
+      pItem->len = len;
+      pItem->dirty = FALSE;
+      pItem->next = nvTxnList;
+      nvTxnList = pItem;
+    }
+  }
+
+  return pItem;
+}
+
+/*********************************************************************
+ * @fn      nvTxnDrop
+ *
+ * @brief   Discard the staged copy of an item, or of all items if
+ *          'id' is OSAL_NV_ITEM_NULL.
+ *
+ * @param   id - A valid NV item Id or OSAL_NV_ITEM_NULL.
+ *
+ * @return  none
+ */
+static void nvTxnDrop( uint16 id )
+{
+  osalNvTxnItem_t **ppItem = &nvTxnList;
+
+  while ( *ppItem != NULL )
+  {
+    osalNvTxnItem_t *pItem = *ppItem;
+
+    if ( (id == OSAL_NV_ITEM_NULL) || (pItem->id == id) )
+    {
+      *ppItem = pItem->next;
+      osal_mem_free( pItem );
+    }
+    else
+    {
+      ppItem = &(pItem->next);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      nvTxnShadow
+ *
+ * @brief   Walk the pages for the shadow copy of an item.
+ *
+ * @param   id - A valid NV item Id, or OSAL_NV_ITEM_NULL for any shadow.
+ * @param   zero - TRUE to zero out every matching shadow copy instead.
+ *
+ * @return  Offset of the shadow data with 'findPg' set to its page if
+ *          found and not zeroed; otherwise OSAL_NV_ITEM_NULL.
+ */
+static uint16 nvTxnShadow( uint16 id, uint8 zero )
+{
+  uint8 pg;
+
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+
+    while ( offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+    {
+      osalNvHdr_t hdr;
+      uint16 sz;
+
+      HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+      if ( hdr.id == OSAL_NV_ERASED_ID )
+      {
+        break;
+      }
+
+      sz = OSAL_NV_DATA_SIZE( hdr.len );
+      if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset) )
+      {
+        break;
+      }
+      offset += OSAL_NV_HDR_SIZE;
+
+      if ( (hdr.id & OSAL_NV_SHADOW_ID) &&
+          ((id == OSAL_NV_ITEM_NULL) || (hdr.id == (id | OSAL_NV_SHADOW_ID))) )
+      {
+        if ( zero )
+        {
+          setItem( pg, offset, eNvZero );
+        }
+        else
+        {
+          findPg = pg;
+          return offset;
+        }
+      }
+
+      offset += sz;
+    }
+  }
+
+  return OSAL_NV_ITEM_NULL;
+}
+
+/*********************************************************************
+ * @fn      nvTxnApply
+ *
+ * @brief   Copy the shadow of a committed item over the item, with the
+ *          same transfer and zeroing sequence as osal_nv_write().
+ *
+ * @param   id - A valid NV item Id.
+ *
+ * @return  SUCCESS if the item holds the shadow data (or there is no
+ *          shadow left to apply); NV_OPER_FAILED otherwise.
+ */
+static uint8 nvTxnApply( uint16 id )
+{
+  osalNvHdr_t hdr;
+  uint16 srcOff, dstOff;
+  uint8 srcPg, dstPg, comPg = OSAL_NV_PAGE_NULL;
+  uint8 rtrn = NV_OPER_FAILED;
+
+  compactFinish();  // Before locating the item, since finishing moves items.
+
+  if ( nvTxnShadow( id, FALSE ) == OSAL_NV_ITEM_NULL )
+  {
+    return SUCCESS;  // Already applied before a reset.
+  }
+
+  if ( (srcOff = findItem( id )) == OSAL_NV_ITEM_NULL )
+  {
+    return NV_OPER_FAILED;
+  }
+  srcPg = findPg;
+
+  HalFlashRead(srcPg, (srcOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+  dstPg = initItem( FALSE, id, hdr.len, &comPg );
+
+  if ( dstPg != OSAL_NV_PAGE_NULL )
+  {
+    uint16 shOff;
+
+    dstOff = pgOff[dstPg-OSAL_NV_PAGE_BEG] - OSAL_NV_DATA_SIZE( hdr.len );
+
+    if ( hdr.stat == OSAL_NV_ERASED_ID )
+    {
+      setItem( srcPg, srcOff, eNvXfer );
+    }
+
+    // Compaction by initItem() may have moved the shadow.
+    if ( (shOff = nvTxnShadow( id, FALSE )) != OSAL_NV_ITEM_NULL )
+    {
+      HalFlashRead(findPg, (shOff - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+      xferBuf( findPg, shOff, dstPg, dstOff, hdr.len );
+
+      if ( (hdr.chk == calcChkF( dstPg, dstOff, hdr.len )) &&
+           (hdr.chk == setChk( dstPg, dstOff, hdr.chk )) )
+      {
+        hotItemUpdate(dstPg, dstOff, id);
+#if OSAL_NV_INDEX_CNT
+        nvIdxUpdate(dstPg, dstOff, id);
+#endif
+        rtrn = SUCCESS;
+      }
+    }
+  }
+
+  if ( comPg != OSAL_NV_PAGE_NULL )
+  {
+    if ( (srcPg == comPg) && (rtrn == NV_OPER_FAILED) )
+    {
+      erasePage( pgRes );
+    }
+    else
+    {
+      COMPACT_PAGE_CLEANUP( comPg );
+    }
+  }
+
+  if ( (srcPg != comPg) && (rtrn == SUCCESS) )
+  {
+    setItem( srcPg, srcOff, eNvZero );
+  }
+
+  return rtrn;
+}
+
+/*********************************************************************
+ * @fn      nvTxnEnd
+ *
+ * @brief   Zero out the commit record, including any left by a failed
+ *          write, so that it cannot be replayed.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void nvTxnEnd( void )
+{
+  uint16 off;
+  uint8 cnt = OSAL_NV_PAGES_USED;
+
+  while ( cnt-- && ((off = findItem( OSAL_NV_TXN_ID )) != OSAL_NV_ITEM_NULL) )
+  {
+    setItem( findPg, off, eNvZero );
+#if OSAL_NV_INDEX_CNT
+    nvIdxRemove( OSAL_NV_TXN_ID );
+#endif
+  }
+}
+
+/*********************************************************************
+ * @fn      nvTxnRecover
+ *
+ * @brief   Finish a commit interrupted by a reset: roll it forward if
+ *          its commit record is good, then discard all shadow copies.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void nvTxnRecover( void )
+{
+  osalNvHdr_t hdr;
+  uint16 ids[OSAL_NV_TXN_MAX];
+  uint16 off;
+
+  nvTxnPending = FALSE;
+
+  if ( !nvTxnSeen )
+  {
+    return;  // Spare the page walks below on the usual boot.
+  }
+
+  if ( (off = findItem( OSAL_NV_TXN_ID )) != OSAL_NV_ITEM_NULL )
+  {
+    HalFlashRead(findPg, (off - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+    if ( (hdr.len <= sizeof( ids )) && (hdr.chk == calcChkF( findPg, off, hdr.len )) )
+    {
+      uint8 idx;
+
+      HalFlashRead(findPg, off, (uint8 *)ids, hdr.len);
+
+      for ( idx = 0; idx < (hdr.len / sizeof( uint16 )); idx++ )
+      {
+        (void)nvTxnApply( ids[idx] );
+      }
+    }
+
+    nvTxnEnd();
+  }
+
+  (void)nvTxnShadow( OSAL_NV_ITEM_NULL, TRUE );
+}
+
+/*********************************************************************
+ * @fn      leaseChk
+ *
+ * @brief   Calculate the check half-word of a counter journal record.
+ *
+ * @param   pRec - The record.
+ *
+ * @return  The check value, never that of an erased record.
+ */
+static uint16 leaseChk( osalNvLease_t *pRec )
+{
+  return (uint16)~(pRec->id + (uint16)pRec->end + (uint16)(pRec->end >> 16) + 1);
+}
+
+/*********************************************************************
+ * @fn      leaseSlot
+ *
+ * @brief   Find the lease table entry of a counter.
+ *
+ * @param   id - Counter Id.
+ *
+ * @return  Index of the entry of the counter, else of a free entry,
+ *          else OSAL_NV_LEASE_CNT.
+ */
+static uint8 leaseSlot( uint16 id )
+{
+  uint8 idx, free = OSAL_NV_LEASE_CNT;
+
+  for ( idx = 0; idx < OSAL_NV_LEASE_CNT; idx++ )
+  {
+    if ( leaseTbl[idx].id == id )
+    {
+      return idx;
+    }
+    else if ( (leaseTbl[idx].id == OSAL_NV_ERASED_ID) && (free == OSAL_NV_LEASE_CNT) )
+    {
+      free = idx;
+    }
+  }
+
+  return free;
+}
+
+/*********************************************************************
+ * @fn      leaseWrite
+ *
+ * @brief   Write a record of the counter journal into its erased place.
+ *
+ * @param   pg - Valid NV page.
+ * @param   off - Offset of the record.
+ * @param   id - Counter Id, or OSAL_NV_LEASE_SEAL.
+ * @param   end - Lease end, or the journal sequence number.
+ *
+ * @return  TRUE if the record read back is good, FALSE otherwise.
+ */
+static uint8 leaseWrite( uint8 pg, uint16 off, uint16 id, uint32 end )
+{
+  osalNvLease_t rec, tmp;
+
+  rec.id = id;
+  rec.end = end;
+  rec.chk = leaseChk( &rec );
+
+  writeWordM( pg, off, (uint8 *)&rec, (sizeof( rec ) / OSAL_NV_WORD_SIZE) );
+  HalFlashRead( pg, off, (uint8 *)&tmp, sizeof( tmp ) );
+
+  return ( osal_memcmp( &rec, &tmp, sizeof( rec ) ) );
+}
+
+/*********************************************************************
+ * @fn      leaseInit
+ *
+ * @brief   Find the counter journal after the pages are initialized, let
+ *          any other one go, and load the last lease of each counter.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void leaseInit( void )
+{
+  osalNvLease_t rec;
+  uint16 off;
+  uint8 pg;
+
+  leasePg = OSAL_NV_PAGE_NULL;
+  leaseSrcPg = OSAL_NV_PAGE_NULL;
+  (void)osal_memset( leaseTbl, 0xFF, sizeof( leaseTbl ) );
+
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    off = OSAL_NV_PAGE_HDR_SIZE;
+
+    while ( (pg != pgRes) && (off < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE)) )
+    {
+      osalNvHdr_t hdr;
+      uint16 sz;
+
+      HalFlashRead(pg, off, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+      if ( hdr.id == OSAL_NV_ERASED_ID )
+      {
+        break;
+      }
+
+      sz = OSAL_NV_DATA_SIZE( hdr.len );
+      if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - off) )
+      {
+        break;
+      }
+      off += OSAL_NV_HDR_SIZE;
+
+      if ( hdr.id == OSAL_NV_LEASE_ID )
+      {
+        leaseFound( pg, off, &hdr );
+      }
+
+      off += sz;
+    }
+  }
+
+  if ( leasePg != OSAL_NV_PAGE_NULL )
+  {
+    // The last record of a counter is its lease; a bad one was cut short by a reset.
+    for ( off = sizeof( rec ); off <= (leaseLen - sizeof( rec )); off += sizeof( rec ) )
+    {
+      HalFlashRead( leasePg, leaseOff + off, (uint8 *)&rec, sizeof( rec ) );
+
+      if ( (rec.id == OSAL_NV_ERASED_ID) && (rec.chk == OSAL_NV_ERASED_ID) &&
+           (rec.end == 0xFFFFFFFF) )
+      {
+        break;
+      }
+      else if ( (rec.id != OSAL_NV_LEASE_SEAL) && (rec.chk == leaseChk( &rec )) )
+      {
+        uint8 idx = leaseSlot( rec.id );
+
+        if ( idx < OSAL_NV_LEASE_CNT )
+        {
+          leaseTbl[idx].id = rec.id;
+          leaseTbl[idx].end = rec.end;
+        }
+      }
+    }
+
+    leaseNext = off;
+  }
+}
+
+/*********************************************************************
+ * @fn      leaseFound
+ *
+ * @brief   Keep the newest sealed counter journal met by leaseInit(), and
+ *          zero the others. Of two copies left by a compaction, the one not
+ *          marked as transferred is kept.
+ *
+ * @param   pg - Valid NV page.
+ * @param   off - Offset of the journal data.
+ * @param   pHdr - Header of the journal.
+ *
+ * @return  none
+ */
+static void leaseFound( uint8 pg, uint16 off, osalNvHdr_t *pHdr )
+{
+  osalNvLease_t seal;
+
+  HalFlashRead( pg, off, (uint8 *)&seal, sizeof( seal ) );
+
+  if ( (pHdr->len < (2 * sizeof( seal ))) || (seal.id != OSAL_NV_LEASE_SEAL) ||
+       (seal.chk != leaseChk( &seal )) )
+  {
+    setItem( pg, off, eNvZero );  // Cut short by a reset, the previous journal still holds.
+  }
+  else if ( (leasePg == OSAL_NV_PAGE_NULL) || (seal.end > leaseSeq) ||
+           ((seal.end == leaseSeq) && (pHdr->stat == OSAL_NV_ERASED_ID)) )
+  {
+    if ( leasePg != OSAL_NV_PAGE_NULL )
+    {
+      setItem( leasePg, leaseOff, eNvZero );
+    }
+
+    leasePg = pg;
+    leaseOff = off;
+    leaseLen = pHdr->len - (pHdr->len % sizeof( seal ));
+    leaseSeq = seal.end;
+  }
+  else
+  {
+    setItem( pg, off, eNvZero );
+  }
+}
+
+/*********************************************************************
+ * @fn      leaseMove
+ *
+ * @brief   Transfer a counter journal to the reserve page during a page
+ *          compaction. Its records are copied as they are; the copy of the
+ *          journal in use takes the following records.
+ *
+ * @param   srcPg - Valid NV page.
+ * @param   srcOff - Offset of the journal data.
+ * @param   pHdr - Header of the journal.
+ *
+ * @return  TRUE if the header of the copy was written, FALSE otherwise.
+ */
+static uint8 leaseMove( uint8 srcPg, uint16 srcOff, osalNvHdr_t *pHdr )
+{
+  uint16 dstOff = pgOff[pgRes-OSAL_NV_PAGE_BEG] + OSAL_NV_HDR_SIZE;
+  uint16 len = pHdr->len;
+
+  if ( pHdr->stat == OSAL_NV_ERASED_ID )
+  {
+    setItem( srcPg, srcOff, eNvXfer );
+  }
+
+  if ( !writeItem( pgRes, OSAL_NV_LEASE_ID, pHdr->len, NULL, FALSE ) )
+  {
+    return FALSE;
+  }
+
+  if ( (srcPg == leasePg) && (srcOff == leaseOff) )
+  {
+    len = leaseNext;  // The free records are left erased, to be written only once.
+    leaseSrcPg = srcPg;
+    leaseSrcOff = srcOff;
+    leasePg = pgRes;
+    leaseOff = dstOff;
+  }
+
+  xferBuf( srcPg, srcOff, pgRes, dstOff, len );
+
+  return TRUE;
+}
 
 /*********************************************************************
- * @fn      hotItemUpdate
+ * @fn      leaseRoll
  *
- * @brief   If the parameter 'id' is a hot item, update the corresponding hot item data.
+ * @brief   Start a new counter journal with the last lease of each counter,
+ *          then zero the old one.
  *
- * @param   pg - The new NV page corresponding to the hot item.
- * @param   off - The new NV page offset corresponding to the hot item.
- * @param   id - A valid NV item Id.
+ * @param   none
  *
- * @return  none
+ * @return  TRUE if the new journal was written and sealed, FALSE otherwise.
  */
-static void hotItemUpdate(uint8 pg, uint16 off, uint16 id)
+static uint8 leaseRoll( void )
 {
-  uint8 hotIdx = hotItem(id);
+  uint16 dstOff = 0, off = sizeof( osalNvLease_t );
+  uint8 comPg = OSAL_NV_PAGE_NULL;
+  uint8 dstPg, idx, rtrn = FALSE;
+
+  dstPg = initItem( FALSE, OSAL_NV_LEASE_ID, OSAL_NV_LEASE_LEN, &comPg );
+
+  if ( dstPg != OSAL_NV_PAGE_NULL )
+  {
+    dstOff = pgOff[dstPg-OSAL_NV_PAGE_BEG] - OSAL_NV_DATA_SIZE( OSAL_NV_LEASE_LEN );
+    rtrn = TRUE;
+
+    for ( idx = 0; idx < OSAL_NV_LEASE_CNT; idx++ )
+    {
+      if ( leaseTbl[idx].id != OSAL_NV_ERASED_ID )
+      {
+        if ( !leaseWrite( dstPg, dstOff + off, leaseTbl[idx].id, leaseTbl[idx].end ) )
+        {
+          rtrn = FALSE;
+        }
+        off += sizeof( osalNvLease_t );
+      }
+    }
+
+    // The seal goes last; until it is written osal_nv_init() keeps to the old journal.
+    if ( rtrn )
+    {
+      rtrn = leaseWrite( dstPg, dstOff, OSAL_NV_LEASE_SEAL, (leaseSeq + 1) );
+    }
+  }
+
+  if ( comPg != OSAL_NV_PAGE_NULL )
+  {
+    // The compaction skipped the old journal, so it must be aborted if the new one failed.
+    if ( (leasePg == comPg) && !rtrn )
+    {
+      erasePage( pgRes );
+      dstPg = OSAL_NV_PAGE_NULL;
+    }
+    else
+    {
+      COMPACT_PAGE_CLEANUP( comPg );
+    }
+  }
 
-  if (hotIdx < OSAL_NV_MAX_HOT)
+  if ( rtrn )
   {
+    if ( leasePg != OSAL_NV_PAGE_NULL )
     {
-      hotPg[hotIdx] = pg;
-      hotOff[hotIdx] = off;
+      setItem( leasePg, leaseOff, eNvZero );
     }
+
+    leasePg = dstPg;
+    leaseOff = dstOff;
+    leaseLen = OSAL_NV_LEASE_LEN;
+    leaseNext = off;
+    leaseSeq++;
   }
+  else if ( dstPg != OSAL_NV_PAGE_NULL )
+  {
+    setItem( dstPg, dstOff, eNvZero );
+  }
+
+  return rtrn;
 }
 
 /*********************************************************************
@@ -1220,11 +2771,8 @@ uint8 osal_nv_item_init( uint16 id, uint16 len, void *buf )
   {
     return NV_OPER_FAILED;
   }
-  else if ((offset = findItem(id)) != OSAL_NV_ITEM_NULL)
+  else if ((offset = hotFind(id)) != OSAL_NV_ITEM_NULL)
   {
-    // Re-populate the NV hot item data if the corresponding items are already established.
-    hotItemUpdate(findPg, offset, id);
-
     return SUCCESS;
   }
   else if ( initItem( TRUE, id, len, buf ) != OSAL_NV_PAGE_NULL )
@@ -1250,14 +2798,8 @@ uint16 osal_nv_item_len( uint16 id )
 {
   osalNvHdr_t hdr;
   uint16 offset;
-  uint8 hotIdx;
 
-  if ((hotIdx = hotItem(id)) < OSAL_NV_MAX_HOT)
-  {
-    findPg = hotPg[hotIdx];
-    offset = hotOff[hotIdx];
-  }
-  else if ((offset = findItem(id)) == OSAL_NV_ITEM_NULL)
+  if ((offset = hotFind(id)) == OSAL_NV_ITEM_NULL)
   {
     return 0;
   }
@@ -1279,11 +2821,40 @@ uint16 osal_nv_item_len( uint16 id )
  *
  * @return  SUCCESS if successful, NV_ITEM_UNINIT if item did not
  *          exist in NV and offset is non-zero, NV_OPER_FAILED if failure.
+ *          Within a transaction, NV_OPER_FAILED if the item could not be
+ *          staged, which also fails osal_nv_commit().
  */
 uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
 {
   uint8 rtrn = SUCCESS;
 
+  if ( nvTxnOpen && (len != 0) )
+  {
+    osalNvTxnItem_t *pItem = nvTxnGet( id );
+
+    /* An item that cannot be staged (the transaction is full, the heap is exhausted or the
+     * item does not exist) is not written straight through, which would leave it changed
+     * whatever the commit does: the whole transaction fails instead.
+     */
+    if ( (pItem == NULL) || (pItem->len < (ndx + len)) )
+    {
+      nvTxnBroken = TRUE;
+      return NV_OPER_FAILED;
+    }
+    else
+    {
+      uint8 *pData = (uint8 *)(pItem + 1) + ndx;
+
+      if ( !osal_memcmp( pData, buf, len ) )
+      {
+        (void)osal_memcpy( pData, buf, len );
+        pItem->dirty = TRUE;
+      }
+
+      return SUCCESS;
+    }
+  }
+
   if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
   {
     return NV_OPER_FAILED;
@@ -1295,7 +2866,9 @@ uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
     uint16 cnt, chk;
     uint8 *ptr, srcPg;
 
-    origOff = srcOff = findItem( id );
+    compactFinish();  // Before locating the item, since finishing moves items.
+
+    origOff = srcOff = hotFind( id );
     srcPg = findPg;
     if ( srcOff == OSAL_NV_ITEM_NULL )
     {
@@ -1312,19 +2885,25 @@ uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
     ptr = buf;
     cnt = len;
     chk = 0;
-    while ( cnt-- )
+    while ( cnt )
     {
-      uint8 tmp;
-      HalFlashRead(srcPg, srcOff, &tmp, 1);
-      if ( tmp != *ptr )
+      uint8 idx, tmp[OSAL_NV_BURST_SIZE];
+      uint8 num = (cnt < OSAL_NV_BURST_SIZE) ? (uint8)cnt : OSAL_NV_BURST_SIZE;
+
+      HalFlashRead(srcPg, srcOff, tmp, num);
+      for ( idx = 0; idx < num; idx++ )
       {
-        chk = 1;  // Mark that at least one byte is different.
-        // Calculate expected checksum after transferring old data and writing new data.
-        hdr.chk -= tmp;
-        hdr.chk += *ptr;
+        if ( tmp[idx] != *ptr )
+        {
+          chk = 1;  // Mark that at least one byte is different.
+          // Calculate expected checksum after transferring old data and writing new data.
+          hdr.chk -= tmp[idx];
+          hdr.chk += *ptr;
+        }
+        ptr++;
       }
-      srcOff++;
-      ptr++;
+      srcOff += num;
+      cnt -= num;
     }
 
     if ( chk != 0 )  // If the buffer to write is different in one or more bytes.
@@ -1368,6 +2947,9 @@ uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
           else
           {
             hotItemUpdate(dstPg, dstOff, hdr.id);
+#if OSAL_NV_INDEX_CNT
+            nvIdxUpdate(dstPg, dstOff, hdr.id);
+#endif
           }
         }
         else
@@ -1426,15 +3008,19 @@ uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
 uint8 osal_nv_read( uint16 id, uint16 ndx, uint16 len, void *buf )
 {
   uint16 offset;
-  uint8 hotIdx;
 
-  if ((hotIdx = hotItem(id)) < OSAL_NV_MAX_HOT)
+  if ( nvTxnOpen )
   {
-    HalFlashRead(hotPg[hotIdx], hotOff[hotIdx]+ndx, buf, len);
-    return SUCCESS;
+    osalNvTxnItem_t *pItem = nvTxnFind( id );
+
+    if ( pItem != NULL )
+    {
+      (void)osal_memcpy( buf, (uint8 *)(pItem + 1) + ndx, len );
+      return SUCCESS;
+    }
   }
 
-  if ((offset = findItem(id)) == OSAL_NV_ITEM_NULL)
+  if ((offset = hotFind(id)) == OSAL_NV_ITEM_NULL)
   {
     return NV_OPER_FAILED;
   }
@@ -1464,6 +3050,13 @@ uint8 osal_nv_delete( uint16 id, uint16 len )
   uint16 length;
   uint16 offset;
 
+  // Deletion is not staged; any staged writes to the item are dropped.
+  nvTxnDrop( id );
+  /* An item zeroed while its copy on the page being compacted lives on would come back if a
+   * reset made initNV() compact that page again.
+   */
+  compactFinish();
+
   offset = findItem( id );
   if ( offset == OSAL_NV_ITEM_NULL )
   {
@@ -1480,9 +3073,19 @@ uint8 osal_nv_delete( uint16 id, uint16 len )
 
   // Set item header ID to zero to 'delete' the item
   setItem( findPg, offset, eNvZero );
+  hotItemRemove( id );
 
   // Verify that item has been removed
+#if OSAL_NV_INDEX_CNT
+  // The index forgets the item, so ask the flash for an old copy left by an interrupted write.
+  nvIdxRemove( id );
+  if ( (offset = findItem( id | OSAL_NV_SOURCE_ID )) != OSAL_NV_ITEM_NULL )
+  {
+    nvIdxUpdate( findPg, offset, id );
+  }
+#else
   offset = findItem( id );
+#endif
   if ( offset != OSAL_NV_ITEM_NULL )
   {
     // Still there
@@ -1495,5 +3098,368 @@ uint8 osal_nv_delete( uint16 id, uint16 len )
   }
 }
 
+/*********************************************************************
+ * @fn      osal_nv_begin
+ *
+ * @brief   Open a transaction: until osal_nv_commit(), osal_nv_write()
+ *          only updates a RAM copy of each item it touches, and
+ *          osal_nv_read() returns that copy. Up to OSAL_NV_TXN_MAX items
+ *          that already exist are staged, as the heap allows; a write to
+ *          any other fails, and so does the commit, which then writes
+ *          nothing.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if the transaction was opened;
+ *          NV_OPER_FAILED if one is already open or a failed commit is
+ *          waiting for osal_nv_init() to complete it.
+ */
+uint8 osal_nv_begin( void )
+{
+  if ( nvTxnOpen || nvTxnPending )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  nvTxnOpen = TRUE;
+  nvTxnBroken = FALSE;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_commit
+ *
+ * @brief   Close the transaction and write each changed item once. When
+ *          more than one item changed, either all of them or none of them
+ *          take their new values, even across a reset: the new values are
+ *          written as shadow copies, then the commit record, then copied
+ *          over the items. If a write of the transaction failed, none of
+ *          them is.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if all changed items were written;
+ *          NV_OPER_FAILED otherwise, or if no transaction was open.
+ */
+uint8 osal_nv_commit( void )
+{
+  osalNvTxnItem_t *pItem;
+  uint16 ids[OSAL_NV_TXN_MAX];
+  uint8 cnt = 0;
+  uint8 rtrn = SUCCESS;
+
+  if ( !nvTxnOpen )
+  {
+    return NV_OPER_FAILED;
+  }
+  nvTxnOpen = FALSE;
+
+  if ( nvTxnBroken )
+  {
+    rtrn = NV_OPER_FAILED;  // Nothing is written.
+  }
+  else
+  {
+    for ( pItem = nvTxnList; pItem != NULL; pItem = pItem->next )
+    {
+      if ( pItem->dirty )
+      {
+        ids[cnt++] = pItem->id;
+      }
+    }
+  }
+
+  if ( cnt == 1 )
+  {
+    // A single item write is already atomic.
+    pItem = nvTxnFind( ids[0] );
+    rtrn = osal_nv_write( pItem->id, 0, pItem->len, pItem + 1 );
+  }
+  else if ( cnt != 0 )
+  {
+    if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+    {
+      rtrn = NV_OPER_FAILED;
+    }
+
+    for ( pItem = nvTxnList; (pItem != NULL) && (rtrn == SUCCESS); pItem = pItem->next )
+    {
+      if ( pItem->dirty &&
+          (initItem( TRUE, (pItem->id | OSAL_NV_SHADOW_ID), pItem->len, pItem + 1 ) ==
+                                                                            OSAL_NV_PAGE_NULL) )
+      {
+        rtrn = NV_OPER_FAILED;
+      }
+    }
+
+    // The commit point.
+    if ( (rtrn == SUCCESS) &&
+         (initItem( TRUE, OSAL_NV_TXN_ID, (cnt * sizeof( uint16 )), ids ) != OSAL_NV_PAGE_NULL) )
+    {
+      uint8 idx;
+
+      for ( idx = 0; idx < cnt; idx++ )
+      {
+        if ( nvTxnApply( ids[idx] ) != SUCCESS )
+        {
+          rtrn = NV_OPER_FAILED;
+        }
+      }
+
+      if ( rtrn == SUCCESS )
+      {
+        nvTxnEnd();
+        (void)nvTxnShadow( OSAL_NV_ITEM_NULL, TRUE );
+      }
+      else
+      {
+        // Leave the record and shadows for osal_nv_init() to roll forward.
+        nvTxnPending = TRUE;
+      }
+    }
+    else
+    {
+      rtrn = NV_OPER_FAILED;
+      nvTxnEnd();
+      (void)nvTxnShadow( OSAL_NV_ITEM_NULL, TRUE );
+    }
+  }
+
+  nvTxnDrop( OSAL_NV_ITEM_NULL );
+
+  return rtrn;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_lease
+ *
+ * @brief   Record the end of a new lease of a counter in the counter
+ *          journal. A lease is one record appended in place, so a counter
+ *          that is reserved in blocks is kept without rewriting an item
+ *          for each block; the journal is only started again when full.
+ *          The last lease recorded before a reset is the one
+ *          osal_nv_lease_end() gives after it, even if lower.
+ *
+ * @param   id - Counter Id, chosen by the caller - neither 0x0000 nor 0xFFFF.
+ * @param   end - End of the lease.
+ *
+ * @return  SUCCESS if the lease was recorded;
+ *          INVALIDPARAMETER if the Id is bad or no more counters fit;
+ *          NV_OPER_FAILED otherwise - the previous lease still holds.
+ */
+uint8 osal_nv_lease( uint16 id, uint32 end )
+{
+  osalNvLease_t old;
+  uint8 idx = leaseSlot( id );
+
+  if ( (idx == OSAL_NV_LEASE_CNT) || (id == OSAL_NV_LEASE_SEAL) || (id == OSAL_NV_ERASED_ID) )
+  {
+    return INVALIDPARAMETER;
+  }
+  else if ( (leaseTbl[idx].id == id) && (leaseTbl[idx].end == end) )
+  {
+    return SUCCESS;
+  }
+  else if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  compactFinish();  // So that the journal is not appended to on an unfinished compaction target.
+
+  old = leaseTbl[idx];
+  leaseTbl[idx].id = id;
+  leaseTbl[idx].end = end;
+
+  if ( (leasePg != OSAL_NV_PAGE_NULL) && (leaseNext <= (leaseLen - sizeof( osalNvLease_t ))) )
+  {
+    uint16 off = leaseNext;
+
+    leaseNext += sizeof( osalNvLease_t );
+    if ( leaseWrite( leasePg, leaseOff + off, id, end ) )
+    {
+      return SUCCESS;
+    }
+  }
+
+  // There is no journal yet, it is full, or the record did not take.
+  if ( !leaseRoll() )
+  {
+    leaseTbl[idx] = old;
+    return NV_OPER_FAILED;
+  }
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_lease_end
+ *
+ * @brief   Get the end of the last lease recorded for a counter.
+ *
+ * @param   id - Counter Id.
+ *
+ * @return  The lease end, 0 if the counter has none.
+ */
+uint32 osal_nv_lease_end( uint16 id )
+{
+  uint8 idx = leaseSlot( id );
+
+  if ( (idx < OSAL_NV_LEASE_CNT) && (leaseTbl[idx].id == id) )
+  {
+    return leaseTbl[idx].end;
+  }
+
+  return 0;
+}
+
+#if OSAL_NV_IDLE_COMPACT
+/*********************************************************************
+ * @fn      osal_nv_compact
+ *
+ * @brief   Called from the OSAL idle loop. Once the free space after the last
+ *          items runs low, compact the page with the most lost bytes onto the
+ *          reserve page, about OSAL_NV_COMPACT_SLICE bytes of items per call,
+ *          so that an osal_nv_write() seldom has to compact a whole page.
+ *          A reset between slices is recovered by osal_nv_init() as any
+ *          interrupted compaction.
+ *
+ * @param   none
+ *
+ * @return  TRUE if there is more to do; FALSE otherwise.
+ */
+uint8 osal_nv_compact( void )
+{
+  if ( bgPg == OSAL_NV_PAGE_NULL )
+  {
+    osalNvPgHdr_t pgHdr;
+    uint16 free = 0;
+    uint8 idx, pg = OSAL_NV_PAGE_NULL;
+
+    for ( idx = 0; idx < OSAL_NV_PAGES_USED; idx++ )
+    {
+      if ( (idx + OSAL_NV_PAGE_BEG) != pgRes )
+      {
+        free += (OSAL_NV_PAGE_SIZE - pgOff[idx]);
+
+        if ( (pgLost[idx] >= (OSAL_NV_COMPACT_FREE / 4)) &&
+            ((pg == OSAL_NV_PAGE_NULL) || (pgLost[idx] > pgLost[pg - OSAL_NV_PAGE_BEG])) )
+        {
+          pg = idx + OSAL_NV_PAGE_BEG;
+        }
+      }
+    }
+
+    if ( (free >= OSAL_NV_COMPACT_FREE) || (pg == OSAL_NV_PAGE_NULL) ||
+         !OSAL_NV_CHECK_BUS_VOLTAGE || !compactClean() )
+    {
+      return FALSE;
+    }
+
+    // Mark the page as being in process of compaction, as initItem() does.
+    HalFlashRead(pg, OSAL_NV_PAGE_HDR_OFFSET, (uint8 *)(&pgHdr), OSAL_NV_PAGE_HDR_SIZE);
+    if ( pgHdr.xfer == OSAL_NV_ERASED_ID )
+    {
+      free = OSAL_NV_ZEROED_ID;
+      writeWordH( pg, OSAL_NV_PG_XFER, (uint8*)(&free) );
+    }
+
+    bgPg = pg;
+    bgOff = OSAL_NV_PAGE_HDR_SIZE;
+  }
+  else if ( !OSAL_NV_CHECK_BUS_VOLTAGE )
+  {
+    return FALSE;  // Left for compactFinish() or a later call.
+  }
+  else if ( !compactItems( bgPg, &bgOff, OSAL_NV_ITEM_NULL, OSAL_NV_COMPACT_SLICE ) )
+  {
+    bgPg = OSAL_NV_PAGE_NULL;
+    erasePage( pgRes );
+    return FALSE;
+  }
+  else if ( bgOff == OSAL_NV_PAGE_SIZE )
+  {
+    uint8 pg = bgPg;
+
+    bgPg = OSAL_NV_PAGE_NULL;
+    COMPACT_PAGE_CLEANUP( pg );
+  }
+
+  return TRUE;
+}
+#endif
+
+/*********************************************************************
+ * @fn      osal_nv_page_stat
+ *
+ * @brief   Report the wear and usage of an NV page. The erase count is kept
+ *          in the spare half-word of the page header, so it survives resets.
+ *
+ * @param   idx - Index of the page, from 0 up to the number of NV pages.
+ * @param   pStat - Filled in with the page statistics.
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if 'idx' is out of range.
+ */
+uint8 osal_nv_page_stat( uint8 idx, osalNvPageStat_t *pStat )
+{
+  if ( idx >= OSAL_NV_PAGES_USED )
+  {
+    return INVALIDPARAMETER;
+  }
+
+  pStat->eraseCnt = pgErase[idx];
+  pStat->freeLen = OSAL_NV_PAGE_SIZE - pgOff[idx];
+  pStat->lostLen = pgLost[idx];
+  pStat->reserve = ((idx + OSAL_NV_PAGE_BEG) == pgRes);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_boot_stat
+ *
+ * @brief   Report how much of NV the last osal_nv_init() had to read back,
+ *          which is most of its run time.
+ *
+ * @param   pStat - Filled in with the boot statistics.
+ *
+ * @return  none
+ */
+void osal_nv_boot_stat( osalNvBootStat_t *pStat )
+{
+  *pStat = nvBoot;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_hot_stat
+ *
+ * @brief   Report how well the hot item cache serves the item lookups, to help
+ *          choose OSAL_NV_MAX_HOT for an application.
+ *
+ * @param   pStat - Filled in with the cache statistics.
+ *
+ * @return  none
+ */
+void osal_nv_hot_stat( osalNvHotStat_t *pStat )
+{
+  *pStat = nvHot;
+  pStat->size = OSAL_NV_MAX_HOT;
+  pStat->used = 0;
+#if OSAL_NV_MAX_HOT
+  {
+    uint8 hotIdx;
+
+    for ( hotIdx = 0; hotIdx < OSAL_NV_MAX_HOT; hotIdx++ )
+    {
+      if ( hotTbl[hotIdx].id != 0 )
+      {
+        pStat->used++;
+      }
+    }
+  }
+#endif
+}
+
 /*********************************************************************
  */
@@ -58,10 +58,39 @@
   #include "stub_aps.h"
 #endif
 
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// The endpoint index is split by the high nibble of the endpoint into blocks of 16 entries,
+// only allocated once an endpoint in their range is registered.
+#define AF_EP_BLK_SHIFT  4
+#define AF_EP_BLK_SIZE   (1 << AF_EP_BLK_SHIFT)
+#define AF_EP_BLK_CNT    (256 / AF_EP_BLK_SIZE)
+
+// Start value of the walk position of afGroupNextEP()
+#define AF_GROUP_ITER_START  0xFFFF
+
 /*********************************************************************
  * MACROS
  */
 
+#define AF_EP_BLK( ep )  ((uint8)(ep) >> AF_EP_BLK_SHIFT)
+#define AF_EP_OFF( ep )  ((uint8)(ep) & (AF_EP_BLK_SIZE - 1))
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+#if !defined ( APS_NO_GROUPS )
+// One group table entry in the group index
+typedef struct
+{
+  uint16 groupID;
+  uint8  endpoint;
+} afGroupIdx_t;
+#endif
+
 /*********************************************************************
  * @fn      afSend
  *
@@ -94,17 +123,55 @@
 
 epList_t *epList;
 
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Registered endpoints by number, epList being kept for walks in registration order.
+static epList_t **afEpIndex[AF_EP_BLK_CNT];
+
+#if !defined ( APS_NO_GROUPS )
+// The group table sorted by group ID, entries of a group being kept in
+// group table order. Rebuilt on the first group frame after a change.
+static afGroupIdx_t afGroupIdx[APS_MAX_GROUPS];
+static uint8 afGroupIdxCnt = 0;
+static uint8 afGroupIdxOk = FALSE;    // FALSE if the group table did not fit
+static uint8 afGroupIdxStale = TRUE;  // Set by afAddGroup() and the other wrappers
+// The first and last group table entries when the index was built
+static apsGroupItem_t *afGroupIdxHead = NULL;
+static apsGroupItem_t *afGroupIdxTail = NULL;
+#endif
+
+static afGroupStat_t afGroupStats;
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
 
 static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
                 zAddrType_t *SrcAddress, uint16 SrcPanId, NLDE_Signal_t *sig,
-                uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp );
+                uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp, uint8 **ppShared );
+
+static void afDeliverMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
+                zAddrType_t *SrcAddress, uint16 SrcPanId, NLDE_Signal_t *sig,
+                uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp, uint8 **ppShared );
 
 static epList_t *afFindEndPointDescList( uint8 EndPoint );
 
-static pDescCB afGetDescCB( endPointDesc_t *epDesc );
+static uint16 afGetProfileID( epList_t *pItem, endPointDesc_t *epDesc );
+
+static void afIndexEndPoint( uint8 EndPoint );
+
+#if !defined ( APS_NO_GROUPS )
+static uint8 afGroupIndex( void );
+static uint8 afGroupNextEP( uint16 groupID, uint16 *pIter );
+#endif
+
+static uint8 afDataReqSetup( APSDE_DataReq_t *req, endPointDesc_t *srcEP, uint16 cID,
+                             uint16 len, uint8 *buf, uint8 options, uint8 radius );
+
+static afStatus_t afDataReqSend( const APSDE_DataReq_t *tmpl, afAddrType_t *dstAddr,
+                                 uint8 options, uint8 maxLen, uint8 *transID );
 
 /*********************************************************************
  * PUBLIC FUNCTIONS
@@ -132,12 +199,27 @@ void afInit( void )
  * @param   descFn - pointer to descriptor callback function
  *
  * NOTE:  The memory that epDesc is pointing to must exist after this call.
+ *        descFn is asked for the Profile ID only once, by this call.
  *
  * @return  Pointer to epList_t on success, NULL otherwise.
  */
 epList_t *afRegisterExtended( endPointDesc_t *epDesc, pDescCB descFn )
 {
-  epList_t *ep = osal_mem_alloc(sizeof(epList_t));
+  epList_t **pBlk = afEpIndex[AF_EP_BLK(epDesc->endPoint)];
+  epList_t *ep;
+
+  if (pBlk == NULL)
+  {
+    pBlk = osal_mem_alloc(AF_EP_BLK_SIZE * sizeof(epList_t *));
+    if (pBlk == NULL)
+    {
+      return NULL;
+    }
+    (void)osal_memset(pBlk, 0, AF_EP_BLK_SIZE * sizeof(epList_t *));
+    afEpIndex[AF_EP_BLK(epDesc->endPoint)] = pBlk;
+  }
+
+  ep = osal_mem_alloc(sizeof(epList_t));
 
   if (ep != NULL)
   {
@@ -148,6 +230,25 @@ epList_t *afRegisterExtended( endPointDesc_t *epDesc, pDescCB descFn )
     ep->apsfCfg.frameDelay = APSF_DEFAULT_INTERFRAME_DELAY;
     ep->apsfCfg.windowSize = APSF_DEFAULT_WINDOW_SIZE;
     ep->flags = eEP_AllowMatch;  // Default to allow Match Descriptor.
+    ep->profileID = 0xFFFF;      // Invalid Profile ID
+
+    // Ask for the profile now rather than for every frame sent or received.
+    if (descFn != NULL)
+    {
+      uint16 *pID = (uint16 *)(descFn(AF_DESCRIPTOR_PROFILE_ID, epDesc->endPoint));
+      if (pID != NULL)
+      {
+        ep->profileID = *pID;
+        osal_mem_free(pID);
+      }
+    }
+
+    // The latest registration of an endpoint number is the one found, as in epList.
+    pBlk[AF_EP_OFF(epDesc->endPoint)] = ep;
+  }
+  else
+  {
+    afIndexEndPoint(epDesc->endPoint);  // Drop the block if it was only allocated above.
   }
 
   return ep;
@@ -201,18 +302,21 @@ afStatus_t afDelete( uint8 EndPoint )
     {
       epList = epCurrent->nextDesc;
       osal_mem_free(epCurrent);
+      afIndexEndPoint(EndPoint);
 
       return (afStatus_SUCCESS);
     }
     else
     {
       // search the list
-      for (epCurrent = epPrevious->nextDesc; epCurrent != NULL; epPrevious = epCurrent)
+      for (epCurrent = epPrevious->nextDesc; epCurrent != NULL;
+           epPrevious = epCurrent, epCurrent = epCurrent->nextDesc)
       {
         if (epCurrent->epDesc->endPoint == EndPoint)
         {
           epPrevious->nextDesc = epCurrent->nextDesc;
           osal_mem_free(epCurrent);
+          afIndexEndPoint(EndPoint);
 
           // delete the entry and free the memory
           return (afStatus_SUCCESS);
@@ -302,21 +406,28 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
   epList_t *pList = epList;
 #if !defined ( APS_NO_GROUPS )
   uint8 grpEp = APS_GROUPS_EP_NOT_FOUND;
+  uint16 grpIter = AF_GROUP_ITER_START;
 #endif
+  endPointDesc_t *epPending = NULL;  // Matching endpoint not delivered to yet
+  uint8 *pShared = NULL;      // ASDU shared by all endpoints of a group/broadcast delivery
 
   if ( ((aff->FrmCtrl & APS_DELIVERYMODE_MASK) == APS_FC_DM_GROUP) )
   {
 #if !defined ( APS_NO_GROUPS )
     // Find the first endpoint for this group
-    grpEp = aps_FindGroupForEndpoint( aff->GroupID, APS_GROUPS_FIND_FIRST );
+    grpEp = afGroupNextEP( aff->GroupID, &grpIter );
     if ( grpEp == APS_GROUPS_EP_NOT_FOUND )
+    {
+      afGroupStats.misses++;
       return;   // No endpoint found
+    }
+    afGroupStats.hits++;
 
-    epDesc = afFindEndPointDesc( grpEp );
-    if ( epDesc == NULL )
+    pList = afFindEndPointDescList( grpEp );
+    if ( pList == NULL )
       return;   // Endpoint descriptor not found
 
-    pList = afFindEndPointDescList( epDesc->endPoint );
+    epDesc = pList->epDesc;
 #else
     return; // Not supported
 #endif
@@ -329,63 +440,41 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
       epDesc = pList->epDesc;
     }
   }
-  else if ( (epDesc = afFindEndPointDesc( aff->DstEndPoint )) )
+  else if ( (pList = afFindEndPointDescList( aff->DstEndPoint )) )
   {
-    pList = afFindEndPointDescList( epDesc->endPoint );
+    epDesc = pList->epDesc;
   }
 
   while ( epDesc )
   {
-    uint16 epProfileID = 0xFFFF;  // Invalid Profile ID
-
-    if ( pList->pfnDescCB )
-    {
-      uint16 *pID = (uint16 *)(pList->pfnDescCB(
-                                 AF_DESCRIPTOR_PROFILE_ID, epDesc->endPoint ));
-      if ( pID )
-      {
-        epProfileID = *pID;
-        osal_mem_free( pID );
-      }
-    }
-    else if ( epDesc->simpleDesc )
-    {
-      epProfileID = epDesc->simpleDesc->AppProfId;
-    }
-
-    if ( (aff->ProfileID == epProfileID) ||
+    if ( (aff->ProfileID == afGetProfileID( pList, epDesc )) ||
          ((epDesc->endPoint == ZDO_EP) && (aff->ProfileID == ZDO_PROFILE_ID)) )
     {
+      // Deliver one endpoint behind, so that the ASDU is only shared, at the cost
+      // of the extra allocation, once a second endpoint is known to match.
+      if ( epPending != NULL )
       {
-        // Save original endpoint
-        uint8 endpoint = aff->DstEndPoint;
-
-        // overwrite with descriptor's endpoint
-        aff->DstEndPoint = epDesc->endPoint;
-
-        afBuildMSGIncoming( aff, epDesc, SrcAddress, SrcPanId, sig,
-                           nwkSeqNum, SecurityUse, timestamp );
-
-        // Restore with original endpoint
-        aff->DstEndPoint = endpoint;
+        afDeliverMSGIncoming( aff, epPending, SrcAddress, SrcPanId, sig,
+                              nwkSeqNum, SecurityUse, timestamp, &pShared );
       }
+      epPending = epDesc;
     }
 
     if ( ((aff->FrmCtrl & APS_DELIVERYMODE_MASK) == APS_FC_DM_GROUP) )
     {
 #if !defined ( APS_NO_GROUPS )
       // Find the next endpoint for this group
-      grpEp = aps_FindGroupForEndpoint( aff->GroupID, grpEp );
+      grpEp = afGroupNextEP( aff->GroupID, &grpIter );
       if ( grpEp == APS_GROUPS_EP_NOT_FOUND )
-        return;   // No endpoint found
+        break;    // No endpoint found
 
-      epDesc = afFindEndPointDesc( grpEp );
-      if ( epDesc == NULL )
-        return;   // Endpoint descriptor not found
+      pList = afFindEndPointDescList( grpEp );
+      if ( pList == NULL )
+        break;    // Endpoint descriptor not found
 
-      pList = afFindEndPointDescList( epDesc->endPoint );
+      epDesc = pList->epDesc;
 #else
-      return;
+      break;
 #endif
     }
     else if ( aff->DstEndPoint == AF_BROADCAST_ENDPOINT )
@@ -399,6 +488,48 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
     else
       epDesc = NULL;
   }
+
+  if ( epPending != NULL )
+  {
+    // The only endpoint gets its own copy; the last of several shares the ASDU.
+    afDeliverMSGIncoming( aff, epPending, SrcAddress, SrcPanId, sig,
+                          nwkSeqNum, SecurityUse, timestamp,
+                          (pShared != NULL) ? &pShared : NULL );
+  }
+
+  if ( pShared != NULL )
+  {
+    // Drop the reference taken when the ASDU was copied, the last
+    // endpoint to deallocate its message frees it.
+    osal_ref_release( pShared );
+  }
+}
+
+/*********************************************************************
+ * @fn          afDeliverMSGIncoming
+ *
+ * @brief       Build the message for one endpoint, with the frame
+ *              addressed to that endpoint.
+ *
+ * @param       ppShared - as for afBuildMSGIncoming()
+ *
+ * @return      none
+ */
+static void afDeliverMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
+                 zAddrType_t *SrcAddress, uint16 SrcPanId, NLDE_Signal_t *sig,
+                 uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp, uint8 **ppShared )
+{
+  // Save original endpoint
+  uint8 endpoint = aff->DstEndPoint;
+
+  // overwrite with descriptor's endpoint
+  aff->DstEndPoint = epDesc->endPoint;
+
+  afBuildMSGIncoming( aff, epDesc, SrcAddress, SrcPanId, sig,
+                     nwkSeqNum, SecurityUse, timestamp, ppShared );
+
+  // Restore with original endpoint
+  aff->DstEndPoint = endpoint;
 }
 
 /*********************************************************************
@@ -406,18 +537,41 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
  *
  * @brief       Build the message for the app
  *
- * @param
+ * @param       ppShared - NULL to copy the ASDU into the message, otherwise
+ *                         the ASDU is copied once into a shared read-only
+ *                         buffer (*ppShared, allocated on first use) that
+ *                         the message references.
  *
  * @return      pointer to next in data buffer
  */
 static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
                  zAddrType_t *SrcAddress, uint16 SrcPanId, NLDE_Signal_t *sig,
-                 uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp )
+                 uint8 nwkSeqNum, uint8 SecurityUse, uint32 timestamp, uint8 **ppShared )
 {
   afIncomingMSGPacket_t *MSGpkt;
   const uint8 len = sizeof( afIncomingMSGPacket_t ) + aff->asduLength;
   uint8 *asdu = aff->asdu;
-  MSGpkt = (afIncomingMSGPacket_t *)osal_msg_allocate( len );
+
+  if ( (ppShared != NULL) && aff->asduLength )
+  {
+    if ( *ppShared == NULL )
+    {
+      *ppShared = osal_ref_alloc( aff->asduLength );
+      if ( *ppShared == NULL )
+      {
+        return;
+      }
+      osal_memcpy( *ppShared, asdu, aff->asduLength );
+    }
+
+    MSGpkt = (afIncomingMSGPacket_t *)osal_msg_allocate_ref( sizeof( afIncomingMSGPacket_t ),
+                                                             *ppShared );
+  }
+  else
+  {
+    ppShared = NULL;
+    MSGpkt = (afIncomingMSGPacket_t *)osal_msg_allocate( len );
+  }
 
   if ( MSGpkt == NULL )
   {
@@ -442,7 +596,11 @@ static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
   MSGpkt->cmd.TransSeqNumber = 0;
   MSGpkt->cmd.DataLength = aff->asduLength;
 
-  if ( MSGpkt->cmd.DataLength )
+  if ( ppShared != NULL )
+  {
+    MSGpkt->cmd.Data = *ppShared;
+  }
+  else if ( MSGpkt->cmd.DataLength )
   {
     MSGpkt->cmd.Data = (uint8 *)(MSGpkt + 1);
     osal_memcpy( MSGpkt->cmd.Data, asdu, MSGpkt->cmd.DataLength );
@@ -497,10 +655,8 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
                            uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
                            uint8 options, uint8 radius )
 {
-  pDescCB pfnDescCB;
-  ZStatus_t stat;
   APSDE_DataReq_t req;
-  afDataReqMTU_t mtu;
+  uint8 maxLen;
 
   // Verify source end point
   if ( srcEP == NULL )
@@ -508,6 +664,241 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
     return afStatus_INVALID_PARAMETER;
   }
 
+  maxLen = afDataReqSetup( &req, srcEP, cID, len, buf, options, radius );
+
+  return afDataReqSend( &req, dstAddr, options, maxLen, transID );
+}
+
+/*********************************************************************
+ * @fn      AF_DataRequestSG
+ *
+ * @brief   Send an ASDU given as a list of segments, such as a header
+ *          and a payload. The APS takes a contiguous ASDU, so segments
+ *          that do not follow each other in memory are gathered into one
+ *          buffer; a caller that builds its header right in front of its
+ *          payload is sent without any copy by the AF.
+ *
+ * input parameters
+ *
+ * @param  *dstAddr - Full ZB destination address: Nwk Addr + End Point.
+ * @param  *srcEP - Origination (i.e. respond to or ack to) End Point Descr.
+ * @param   cID - A valid cluster ID as specified by the Profile.
+ * @param  *pSeg - The segments of the ASDU, in order.
+ * @param   segCnt - Number of segments in pSeg.
+ * @param  *transID - A pointer to a byte which can be modified and which will
+ *                    be used as the transaction sequence number of the msg.
+ * @param   options - Valid bit mask of Tx options.
+ * @param   radius - Normally set to AF_DEFAULT_RADIUS.
+ *
+ * output parameters
+ *
+ * @param  *transID - Incremented by one if the return value is success.
+ *
+ * @return  afStatus_t - See previous definition of afStatus_... types.
+ */
+afStatus_t AF_DataRequestSG( afAddrType_t *dstAddr, endPointDesc_t *srcEP, uint16 cID,
+                             afDataSeg_t *pSeg, uint8 segCnt, uint8 *transID,
+                             uint8 options, uint8 radius )
+{
+  afStatus_t stat;
+  uint8 *buf;
+  uint16 len = 0;
+  uint8 adjacent = TRUE;
+  uint8 idx;
+
+  if ( segCnt == 0 )
+  {
+    return afStatus_INVALID_PARAMETER;
+  }
+
+  for ( idx = 0; idx < segCnt; idx++ )
+  {
+    // An empty segment, such as a command without a payload, is adjacent anywhere.
+    if ( (idx != 0) && (pSeg[idx].len != 0) && (pSeg[idx].pData != (pSeg[0].pData + len)) )
+    {
+      adjacent = FALSE;
+    }
+    len += pSeg[idx].len;
+  }
+
+  if ( adjacent )
+  {
+    return AF_DataRequest( dstAddr, srcEP, cID, len, pSeg[0].pData,
+                           transID, options, radius );
+  }
+
+  buf = osal_mem_alloc( len );
+  if ( buf == NULL )
+  {
+    return afStatus_MEM_FAIL;
+  }
+
+  for ( len = 0, idx = 0; idx < segCnt; idx++ )
+  {
+    (void)osal_memcpy( buf + len, pSeg[idx].pData, pSeg[idx].len );
+    len += pSeg[idx].len;
+  }
+
+  stat = AF_DataRequest( dstAddr, srcEP, cID, len, buf, transID, options, radius );
+  osal_mem_free( buf );
+
+  return stat;
+}
+
+/*********************************************************************
+ * @fn      AF_DataRequestList
+ *
+ * @brief   Send the same ASDU to a list of destinations. The source
+ *          endpoint, profile, Tx options and MTU are worked out once for
+ *          the whole list, then every destination is handed to the APS
+ *          in turn. A destination that fails does not stop the others.
+ *
+ * input parameters
+ *
+ * @param  *dstList - Full ZB destination addresses: Nwk Addr + End Point.
+ * @param   dstCnt - Number of destinations in dstList.
+ * @param  *srcEP - Origination (i.e. respond to or ack to) End Point Descr.
+ * @param   cID - A valid cluster ID as specified by the Profile.
+ * @param   len - Number of bytes of data pointed to by next param.
+ * @param  *buf - A pointer to the data bytes to send.
+ * @param  *transID - A pointer to a byte which can be modified and which will
+ *                    be used as the transaction sequence number of the msgs.
+ * @param   options - Valid bit mask of Tx options.
+ * @param   radius - Normally set to AF_DEFAULT_RADIUS.
+ *
+ * output parameters
+ *
+ * @param  *transID - Incremented by one for each destination sent to, so that
+ *                    every destination gets its own AF_DATA_CONFIRM_CMD.
+ * @param  *pStat - If not NULL, filled with the status of each destination.
+ *
+ * @return  afStatus_SUCCESS if every destination was sent to, otherwise the
+ *          status of the first one that failed.
+ */
+afStatus_t AF_DataRequestList( afAddrType_t *dstList, uint8 dstCnt, endPointDesc_t *srcEP,
+                               uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
+                               uint8 options, uint8 radius, afStatus_t *pStat )
+{
+  APSDE_DataReq_t req;
+  afStatus_t rtrn = afStatus_SUCCESS;
+  uint8 maxLen;
+  uint8 idx;
+
+  // Verify source end point
+  if ( srcEP == NULL )
+  {
+    return afStatus_INVALID_PARAMETER;
+  }
+
+  maxLen = afDataReqSetup( &req, srcEP, cID, len, buf, options, radius );
+
+  for ( idx = 0; idx < dstCnt; idx++ )
+  {
+    afStatus_t stat = afDataReqSend( &req, &dstList[idx], options, maxLen, transID );
+
+    if ( pStat != NULL )
+    {
+      pStat[idx] = stat;
+    }
+
+    if ( (stat != afStatus_SUCCESS) && (rtrn == afStatus_SUCCESS) )
+    {
+      rtrn = stat;
+    }
+  }
+
+  return rtrn;
+}
+
+/*********************************************************************
+ * @fn      afDataReqSetup
+ *
+ * @brief   Fill in the parts of an APSDE_DataReq() that do not depend on
+ *          the destination.
+ *
+ * @param  *req - The request to fill in.
+ * @param  *srcEP - Origination (i.e. respond to or ack to) End Point Descr.
+ * @param   cID - A valid cluster ID as specified by the Profile.
+ * @param   len - Number of bytes of data pointed to by next param.
+ * @param  *buf - A pointer to the data bytes to send.
+ * @param   options - Valid bit mask of Tx options.
+ * @param   radius - Normally set to AF_DEFAULT_RADIUS.
+ *
+ * @return  The largest ASDU that can be sent without fragmentation.
+ */
+static uint8 afDataReqSetup( APSDE_DataReq_t *req, endPointDesc_t *srcEP, uint16 cID,
+                             uint16 len, uint8 *buf, uint8 options, uint8 radius )
+{
+  afDataReqMTU_t mtu;
+
+  req->profileID = afGetProfileID( afFindEndPointDescList( srcEP->endPoint ), srcEP );
+  if ( req->profileID == 0xFFFF )
+  {
+    req->profileID = ZDO_PROFILE_ID;
+  }
+
+  req->txOptions = 0;
+
+  if ( options & AF_SKIP_ROUTING )
+  {
+    req->txOptions |=  APS_TX_OPTIONS_SKIP_ROUTING;
+  }
+
+  if ( options & AF_EN_SECURITY )
+  {
+    req->txOptions |= APS_TX_OPTIONS_SECURITY_ENABLE;
+    mtu.aps.secure = TRUE;
+  }
+  else
+  {
+    mtu.aps.secure = FALSE;
+  }
+
+  if ( options & AF_PREPROCESS )
+  {
+    req->txOptions |=  APS_TX_OPTIONS_PREPROCESS;
+  }
+
+  mtu.kvp = FALSE;
+
+  req->srcEP         = srcEP->endPoint;
+  req->clusterID     = cID;
+  req->asduLen       = len;
+  req->asdu          = buf;
+  req->discoverRoute = AF_DataRequestDiscoverRoute;//(uint8)((options & AF_DISCV_ROUTE) ? 1 : 0);
+  req->radiusCounter = radius;
+
+  return afDataReqMTU( &mtu );
+}
+
+/*********************************************************************
+ * @fn      afDataReqSend
+ *
+ * @brief   Address a copy of a request filled in by afDataReqSetup()
+ *          to one destination and hand it to the APS. APSDE_DataReq()
+ *          and apsfSendFragmented() may change the request they are
+ *          given, so the template is left as it was for the next
+ *          destination.
+ *
+ * @param  *tmpl - The request filled in by afDataReqSetup().
+ * @param  *dstAddr - Full ZB destination address: Nwk Addr + End Point.
+ * @param   options - Valid bit mask of Tx options.
+ * @param   maxLen - The largest ASDU that can be sent without fragmentation.
+ * @param  *transID - A pointer to a byte which can be modified and which will
+ *                    be used as the transaction sequence number of the msg.
+ *
+ * output parameters
+ *
+ * @param  *transID - Incremented by one if the return value is success.
+ *
+ * @return  afStatus_t - See previous definition of afStatus_... types.
+ */
+static afStatus_t afDataReqSend( const APSDE_DataReq_t *tmpl, afAddrType_t *dstAddr,
+                                 uint8 options, uint8 maxLen, uint8 *transID )
+{
+  APSDE_DataReq_t req;
+  ZStatus_t stat;
+
 #if !defined( REFLECTOR )
   if ( dstAddr->addrMode == afAddrNotPresent )
   {
@@ -558,6 +949,9 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
     return afStatus_INVALID_PARAMETER;
   }
 
+  // Work on a copy, as the APS may change the request it is given
+  req = *tmpl;
+
   // Set destination address
   req.dstAddr.addrMode = dstAddr->addrMode;
   if ( dstAddr->addrMode == afAddr64Bit )
@@ -565,68 +959,25 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
   else
     req.dstAddr.addr.shortAddr = dstAddr->addr.shortAddr;
 
-  req.profileID = ZDO_PROFILE_ID;
-
-  if ( (pfnDescCB = afGetDescCB( srcEP )) )
-  {
-    uint16 *pID = (uint16 *)(pfnDescCB(
-                                 AF_DESCRIPTOR_PROFILE_ID, srcEP->endPoint ));
-    if ( pID )
-    {
-      req.profileID = *pID;
-      osal_mem_free( pID );
-    }
-  }
-  else if ( srcEP->simpleDesc )
-  {
-    req.profileID = srcEP->simpleDesc->AppProfId;
-  }
-
-  req.txOptions = 0;
-
-  if ( ( options & AF_ACK_REQUEST              ) &&
+  if ( ( options & AF_ACK_REQUEST               ) &&
        ( req.dstAddr.addrMode != AddrBroadcast ) &&
        ( req.dstAddr.addrMode != AddrGroup     )    )
   {
     req.txOptions |=  APS_TX_OPTIONS_ACK;
   }
-
-  if ( options & AF_SKIP_ROUTING )
-  {
-    req.txOptions |=  APS_TX_OPTIONS_SKIP_ROUTING;
-  }
-
-  if ( options & AF_EN_SECURITY )
-  {
-    req.txOptions |= APS_TX_OPTIONS_SECURITY_ENABLE;
-    mtu.aps.secure = TRUE;
-  }
   else
   {
-    mtu.aps.secure = FALSE;
-  }
-
-  if ( options & AF_PREPROCESS )
-  {
-    req.txOptions |=  APS_TX_OPTIONS_PREPROCESS;
+    req.txOptions &= (APS_TX_OPTIONS_ACK ^ 0xFFFF);
   }
 
-  mtu.kvp = FALSE;
-
-  req.transID       = *transID;
-  req.srcEP         = srcEP->endPoint;
-  req.dstEP         = dstAddr->endPoint;
-  req.clusterID     = cID;
-  req.asduLen       = len;
-  req.asdu          = buf;
-  req.discoverRoute = AF_DataRequestDiscoverRoute;//(uint8)((options & AF_DISCV_ROUTE) ? 1 : 0);
-  req.radiusCounter = radius;
+  req.transID        = *transID;
+  req.dstEP          = dstAddr->endPoint;
 #if defined ( INTER_PAN )
-  req.dstPanId      = dstAddr->panId;
+  req.dstPanId       = dstAddr->panId;
 
   if ( StubAPS_InterPan( dstAddr->panId, dstAddr->endPoint ) )
   {
-    if ( len > INTERP_DataReqMTU() )
+    if ( req.asduLen > INTERP_DataReqMTU() )
     {
       stat = afStatus_INVALID_PARAMETER;
     }
@@ -638,7 +989,7 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
   else
 #endif // INTER_PAN
   {
-    if (len > afDataReqMTU( &mtu ) )
+    if ( req.asduLen > maxLen )
     {
       if (apsfSendFragmented)
       {
@@ -667,7 +1018,7 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
   if ( (req.dstAddr.addrMode == Addr16Bit) &&
        (req.dstAddr.addr.shortAddr == NLME_GetShortAddr()) )
   {
-    afDataConfirm( srcEP->endPoint, *transID, stat );
+    afDataConfirm( req.srcEP, *transID, stat );
   }
 
   if ( stat == afStatus_SUCCESS )
@@ -748,17 +1099,52 @@ afStatus_t AF_DataRequestSrcRtg( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
  */
 static epList_t *afFindEndPointDescList( uint8 EndPoint )
 {
+  epList_t **pBlk = afEpIndex[AF_EP_BLK(EndPoint)];
+
+  return ( (pBlk != NULL) ? pBlk[AF_EP_OFF(EndPoint)] : NULL );
+}
+
+/*********************************************************************
+ * @fn      afIndexEndPoint
+ *
+ * @brief   Point the index entry of an endpoint number back at its
+ *          latest registration after one was deleted, and free the
+ *          index block once none of its endpoints are registered.
+ *
+ * @param   EndPoint - Application Endpoint number
+ *
+ * @return  none
+ */
+static void afIndexEndPoint( uint8 EndPoint )
+{
+  epList_t **pBlk = afEpIndex[AF_EP_BLK(EndPoint)];
   epList_t *epSearch;
+  uint8 idx;
 
-  for (epSearch = epList; epSearch != NULL; epSearch = epSearch->nextDesc)
+  if ( pBlk == NULL )
   {
-    if (epSearch->epDesc->endPoint == EndPoint)
+    return;
+  }
+
+  for ( epSearch = epList; epSearch != NULL; epSearch = epSearch->nextDesc )
+  {
+    if ( epSearch->epDesc->endPoint == EndPoint )
     {
       break;
     }
   }
+  pBlk[AF_EP_OFF(EndPoint)] = epSearch;
+
+  for ( idx = 0; idx < AF_EP_BLK_SIZE; idx++ )
+  {
+    if ( pBlk[idx] != NULL )
+    {
+      return;
+    }
+  }
 
-  return epSearch;
+  osal_mem_free( pBlk );
+  afEpIndex[AF_EP_BLK(EndPoint)] = NULL;
 }
 
 /*********************************************************************
@@ -819,34 +1205,218 @@ uint8 afFindSimpleDesc( SimpleDescriptionFormat_t **ppDesc, uint8 EP )
 }
 
 /*********************************************************************
- * @fn      afGetDescCB
+ * @fn      afGetProfileID
  *
- * @brief   Get the Descriptor callback function.
+ * @brief   Get the Profile ID of an endpoint, as cached at registration
+ *          for an endpoint with a descriptor callback.
  *
+ * @param   pItem - the endpoint list entry, NULL if not registered
  * @param   epDesc - pointer to the endpoint descriptor
  *
- * @return  function pointer or NULL
+ * @return  Profile ID, or 0xFFFF if the endpoint has none
  */
-static pDescCB afGetDescCB( endPointDesc_t *epDesc )
+static uint16 afGetProfileID( epList_t *pItem, endPointDesc_t *epDesc )
 {
-  epList_t *epSearch;
+  if ( (pItem != NULL) && (pItem->epDesc == epDesc) && (pItem->pfnDescCB != NULL) )
+  {
+    return ( pItem->profileID );
+  }
+  else if ( epDesc->simpleDesc )
+  {
+    return ( epDesc->simpleDesc->AppProfId );
+  }
+  else
+  {
+    return ( 0xFFFF );  // Invalid Profile ID
+  }
+}
 
-  // Start at the beginning
-  epSearch = epList;
+#if !defined ( APS_NO_GROUPS )
+/*********************************************************************
+ * @fn      afGroupIndex
+ *
+ * @brief   Rebuild the group index if the group table has changed.
+ *
+ *          afAddGroup(), afRemoveGroup() and afRemoveAllGroup() mark the
+ *          index out of date. Otherwise only the head and tail of the group
+ *          table are checked, which also catches an aps_AddGroup() made
+ *          without the AF being told, as it appends at the tail.
+ *
+ * @param   none
+ *
+ * @return  TRUE if the index can be used, FALSE if the group table
+ *          has more entries than it holds
+ */
+static uint8 afGroupIndex( void )
+{
+  apsGroupItem_t *pItem;
+  uint8 cnt = 0;
+  uint8 x;
 
-  // Look through the list until the end
-  while ( epSearch )
+  if ( !afGroupIdxStale && (afGroupIdxHead == apsGroupTable) &&
+       ((afGroupIdxTail == NULL) || (afGroupIdxTail->next == NULL)) )
+  {
+    return ( afGroupIdxOk );
+  }
+
+  afGroupIdxStale = FALSE;
+  afGroupIdxHead = apsGroupTable;
+  afGroupIdxTail = NULL;
+  afGroupIdxOk = TRUE;
+  afGroupStats.rebuilds++;
+
+  for ( pItem = apsGroupTable; pItem != NULL; pItem = pItem->next )
   {
-    // Is there a match?
-    if ( epSearch->epDesc == epDesc )
+    afGroupIdxTail = pItem;
+
+    if ( cnt == APS_MAX_GROUPS )
     {
-      return ( epSearch->pfnDescCB );
+      afGroupIdxOk = FALSE;  // Walk on to the tail all the same
+      continue;
     }
-    else
-      epSearch = epSearch->nextDesc;  // Next entry
+
+    // Insert after the entries of the same group, keeping table order
+    for ( x = cnt; (x > 0) && (afGroupIdx[x-1].groupID > pItem->group.ID); x-- )
+    {
+      afGroupIdx[x] = afGroupIdx[x-1];
+    }
+    afGroupIdx[x].groupID = pItem->group.ID;
+    afGroupIdx[x].endpoint = pItem->endpoint;
+    cnt++;
+  }
+
+  afGroupIdxCnt = cnt;
+
+  return ( afGroupIdxOk );
+}
+
+/*********************************************************************
+ * @fn      afGroupNextEP
+ *
+ * @brief   Walk the endpoints of a group, in group table order.
+ *
+ * @param   groupID - group ID
+ * @param   pIter - walk position, set to AF_GROUP_ITER_START for the
+ *                  first endpoint
+ *
+ * @return  next endpoint in the group, APS_GROUPS_EP_NOT_FOUND if no more
+ */
+static uint8 afGroupNextEP( uint16 groupID, uint16 *pIter )
+{
+  uint8 lo;
+  uint8 hi;
+  uint8 mid;
+
+  if ( !afGroupIndex() )
+  {
+    // Search the group table itself
+    lo = aps_FindGroupForEndpoint( groupID, (*pIter == AF_GROUP_ITER_START) ?
+                                            APS_GROUPS_FIND_FIRST : (uint8)*pIter );
+    *pIter = lo;
+    return ( lo );
+  }
+
+  if ( *pIter == AF_GROUP_ITER_START )
+  {
+    lo = 0;
+    hi = afGroupIdxCnt;
+    while ( lo < hi )
+    {
+      mid = (lo + hi) >> 1;
+
+      if ( afGroupIdx[mid].groupID < groupID )
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+  }
+  else
+  {
+    lo = (uint8)*pIter;
+  }
+
+  if ( (lo < afGroupIdxCnt) && (afGroupIdx[lo].groupID == groupID) )
+  {
+    *pIter = lo + 1;
+    return ( afGroupIdx[lo].endpoint );
   }
 
-  return ( (pDescCB)NULL );
+  return ( APS_GROUPS_EP_NOT_FOUND );
+}
+#endif
+
+/*********************************************************************
+ * @fn      afAddGroup
+ *
+ * @brief   Add a group for an endpoint, see aps_AddGroup().
+ *
+ * @param   endpoint - endpoint
+ * @param   group - group ID and name
+ *
+ * @return  ZSuccess, or the aps_AddGroup() error
+ */
+ZStatus_t afAddGroup( uint8 endpoint, aps_Group_t *group )
+{
+#if !defined ( APS_NO_GROUPS )
+  afGroupIdxStale = TRUE;
+#endif
+
+  return ( aps_AddGroup( endpoint, group ) );
+}
+
+/*********************************************************************
+ * @fn      afRemoveGroup
+ *
+ * @brief   Remove a group of an endpoint, see aps_RemoveGroup().
+ *
+ * @param   endpoint - endpoint
+ * @param   groupID - group ID
+ *
+ * @return  TRUE if removed, FALSE if not found
+ */
+uint8 afRemoveGroup( uint8 endpoint, uint16 groupID )
+{
+#if !defined ( APS_NO_GROUPS )
+  afGroupIdxStale = TRUE;
+#endif
+
+  return ( aps_RemoveGroup( endpoint, groupID ) );
+}
+
+/*********************************************************************
+ * @fn      afRemoveAllGroup
+ *
+ * @brief   Remove all the groups of an endpoint, see aps_RemoveAllGroup().
+ *
+ * @param   endpoint - endpoint
+ *
+ * @return  none
+ */
+void afRemoveAllGroup( uint8 endpoint )
+{
+#if !defined ( APS_NO_GROUPS )
+  afGroupIdxStale = TRUE;
+#endif
+
+  aps_RemoveAllGroup( endpoint );
+}
+
+/*********************************************************************
+ * @fn      afGroupStat
+ *
+ * @brief   Copy out the group delivery counters.
+ *
+ * @param   pStat - where to put the counters
+ *
+ * @return  none
+ */
+void afGroupStat( afGroupStat_t *pStat )
+{
+  *pStat = afGroupStats;
 }
 
 /*********************************************************************
@@ -51,6 +51,7 @@ extern "C"
 #include "ZComDef.h"
 #include "nwk.h"
 #include "APSMEDE.h"
+#include "aps_groups.h"
 
 /*********************************************************************
  * CONSTANTS
@@ -310,6 +311,7 @@ typedef struct _epList_t {
   pDescCB  pfnDescCB;     // Don't use if this function pointer is NULL.
   afAPSF_Config_t apsfCfg;
   eEP_Flags flags;
+  uint16 profileID;       // From pfnDescCB at registration, only valid if pfnDescCB is set.
 } epList_t;
 
 /*********************************************************************
@@ -330,6 +332,21 @@ typedef struct
   APSDE_DataReqMTU_t aps;
 } afDataReqMTU_t;
 
+// One piece of an ASDU passed to AF_DataRequestSG().
+typedef struct
+{
+  uint8  *pData;
+  uint16 len;
+} afDataSeg_t;
+
+// Group delivery counters, see afGroupStat().
+typedef struct
+{
+  uint32 hits;      // Group frames delivered to at least one local endpoint
+  uint32 misses;    // Group frames for a group no local endpoint is in
+  uint16 rebuilds;  // Group index rebuilds after group table changes
+} afGroupStat_t;
+
 /*********************************************************************
  * Globals
  */
@@ -382,6 +399,39 @@ extern epList_t *epList;
                              uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
                              uint8 options, uint8 radius );
 
+ /*
+  * AF_DataRequestSG - Send an ASDU given as a list of segments, copied
+  *                    together only if they are not already adjacent.
+  */
+  afStatus_t AF_DataRequestSG( afAddrType_t *dstAddr, endPointDesc_t *srcEP, uint16 cID,
+                               afDataSeg_t *pSeg, uint8 segCnt, uint8 *transID,
+                               uint8 options, uint8 radius );
+
+ /*
+  * AF_DataRequestList - Send the same ASDU to a list of destinations,
+  *                      each getting its own transaction ID and confirm.
+  */
+  afStatus_t AF_DataRequestList( afAddrType_t *dstList, uint8 dstCnt, endPointDesc_t *srcEP,
+                                 uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
+                                 uint8 options, uint8 radius, afStatus_t *pStat );
+
+
+ /*
+  * afAddGroup, afRemoveGroup, afRemoveAllGroup - aps_AddGroup(),
+  *   aps_RemoveGroup() and aps_RemoveAllGroup() for the group table entries
+  *   of an endpoint, marking the AF group index out of date. Group delivery
+  *   only checks the head and tail of the group table per frame, so any other
+  *   change of the group table must be made through these.
+  */
+  extern ZStatus_t afAddGroup( uint8 endpoint, aps_Group_t *group );
+  extern uint8 afRemoveGroup( uint8 endpoint, uint16 groupID );
+  extern void afRemoveAllGroup( uint8 endpoint );
+
+ /*
+  * afGroupStat - Copy out the group delivery counters.
+  */
+  extern void afGroupStat( afGroupStat_t *pStat );
+
 
 /*********************************************************************
  * @fn      AF_DataRequestSrcRtg
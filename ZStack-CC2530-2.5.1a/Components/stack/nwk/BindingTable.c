@@ -50,6 +50,14 @@
 /*********************************************************************
  * MACROS
  */
+#define BIND_DIRTY_SET( x )  ( BindingTableDirty[(x) >> 3] |= BV( (x) & 0x07 ) )
+#define BIND_DIRTY_CLR( x )  ( BindingTableDirty[(x) >> 3] &= ~BV( (x) & 0x07 ) )
+#define BIND_DIRTY_TST( x )  ( BindingTableDirty[(x) >> 3] & BV( (x) & 0x07 ) )
+
+// An element of BindingIndex[] is (record * gMAX_BINDING_CLUSTER_IDS + slot)
+#define BIND_IDX_REC( e )      ( (e) / gMAX_BINDING_CLUSTER_IDS )
+#define BIND_IDX_EP( e )       ( BindingTable[BIND_IDX_REC( e )].srcEP )
+#define BIND_IDX_CLUSTER( e )  ( BindingTable[BIND_IDX_REC( e )].clusterIdList[(e) % gMAX_BINDING_CLUSTER_IDS] )
 
 /*********************************************************************
  * CONSTANTS
@@ -58,6 +66,12 @@
 #define NV_BIND_REC_SIZE (gBIND_REC_SIZE)
 #define NV_BIND_ITEM_SIZE  (gBIND_REC_SIZE * gNWK_MAX_BINDING_ENTRIES)
 
+// Records per NV item of the table - a changed record only rewrites its block
+#if !defined NV_BIND_BLOCK_RECS
+  #define NV_BIND_BLOCK_RECS  8
+#endif
+#define NV_BIND_BLOCK_CNT  ((gNWK_MAX_BINDING_ENTRIES + NV_BIND_BLOCK_RECS - 1) / NV_BIND_BLOCK_RECS)
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -86,12 +100,29 @@ uint16 bindingAddrMgsHelperFind( zAddrType_t *addr );
 uint8 bindingAddrMgsHelperConvert( uint16 idx, zAddrType_t *addr );
 void bindAddrMgrLocalLoad( void );
 uint16 bindAddrIndexGet( zAddrType_t* addr );
+static uint16 bindBlockLen( uint16 blk );
+static uint8 bindIdxLess( uint16 a, uint16 b );
+static uint16 bindIdxFirst( uint8 ep, uint16 clusterID );
+static uint8 bindIdxMatch( uint16 pos, uint8 ep, uint16 clusterID );
+static void bindIdxAdd( uint16 rec );
+static void bindIdxDrop( uint16 rec );
 
 /*********************************************************************
  * LOCAL VARIABLES
  */
 static uint8 bindAddrMgrLocalLoaded = FALSE;
 
+// Elements used in BindingIndex[]
+static uint16 bindIdxCnt = 0;
+
+// Last bindFind() lookup, so that a walk with an increasing skipping
+// count carries on from the previous match
+static uint8 bindCurValid = FALSE;
+static uint8 bindCurEP;
+static uint16 bindCurCluster;
+static uint8 bindCurSkip;
+static uint16 bindCurPos;
+
 /*********************************************************************
  * Function Pointers
  */
@@ -138,6 +169,9 @@ void BindAddrMgrCB( uint8 update, AddrMgrEntry_t *entryNew,
 void InitBindingTable( void )
 {
   osal_memset( BindingTable, 0xFF, gBIND_REC_SIZE * gNWK_MAX_BINDING_ENTRIES );
+  osal_memset( BindingTableDirty, 0, (gNWK_MAX_BINDING_ENTRIES + 7) / 8 );
+  bindIdxCnt = 0;
+  bindCurValid = FALSE;
 
   pbindAddEntry = bindAddEntry;
   pbindNumOfEntries = bindNumOfEntries;
@@ -338,6 +372,8 @@ BindingEntry_t *bindAddEntry( byte srcEpInt,
         osal_memcpy( entry->clusterIdList,
                      clusterIds,
                      numClusterIds * sizeof(uint16) );
+
+        bindMarkDirty( entry );
       }
     }
   }
@@ -356,10 +392,234 @@ BindingEntry_t *bindAddEntry( byte srcEpInt,
  */
 byte bindRemoveEntry( BindingEntry_t *pBind )
 {
+  uint8 used = ( pBind->srcEP != NV_BIND_EMPTY );
+
   osal_memset( pBind, 0xFF, gBIND_REC_SIZE );
+  if ( used )
+  {
+    bindMarkDirty( pBind );
+  }
   return ( TRUE );
 }
 
+/*********************************************************************
+ * @fn      bindMarkDirty
+ *
+ * @brief   Mark a binding table entry as changed, so that the next
+ *          BindWriteNV() saves it, and re-index it for bindFind().
+ *          Code that changes an entry without the functions of this
+ *          file must call this after the change.
+ *
+ * @param   pBind - pointer to the changed binding table entry
+ *
+ * @return  none
+ */
+void bindMarkDirty( BindingEntry_t *pBind )
+{
+  uint16 x = (uint16)(pBind - BindingTable);
+
+  if ( x < gNWK_MAX_BINDING_ENTRIES )
+  {
+    BIND_DIRTY_SET( x );
+
+    bindIdxDrop( x );
+    bindIdxAdd( x );
+  }
+}
+
+/*********************************************************************
+ * @fn      bindIdxLess
+ *
+ * @brief   Order of BindingIndex[] - source endpoint, then cluster ID,
+ *          then position in the binding table.
+ *
+ * @param   a - index element
+ * @param   b - index element
+ *
+ * @return  TRUE if a comes before b
+ */
+static uint8 bindIdxLess( uint16 a, uint16 b )
+{
+  if ( BIND_IDX_EP( a ) != BIND_IDX_EP( b ) )
+  {
+    return ( BIND_IDX_EP( a ) < BIND_IDX_EP( b ) );
+  }
+
+  if ( BIND_IDX_CLUSTER( a ) != BIND_IDX_CLUSTER( b ) )
+  {
+    return ( BIND_IDX_CLUSTER( a ) < BIND_IDX_CLUSTER( b ) );
+  }
+
+  return ( a < b );
+}
+
+/*********************************************************************
+ * @fn      bindIdxFirst
+ *
+ * @brief   Binary search BindingIndex[] for the first element that is
+ *          not before the endpoint and cluster ID.
+ *
+ * @param   ep - source endpoint
+ * @param   clusterID - cluster ID
+ *
+ * @return  position in BindingIndex[], bindIdxCnt if past the end
+ */
+static uint16 bindIdxFirst( uint8 ep, uint16 clusterID )
+{
+  uint16 lo = 0;
+  uint16 hi = bindIdxCnt;
+  uint16 mid;
+  uint16 e;
+
+  while ( lo < hi )
+  {
+    mid = (lo + hi) >> 1;
+    e = BindingIndex[mid];
+
+    if ( (BIND_IDX_EP( e ) < ep) ||
+         ((BIND_IDX_EP( e ) == ep) && (BIND_IDX_CLUSTER( e ) < clusterID)) )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return ( lo );
+}
+
+/*********************************************************************
+ * @fn      bindIdxMatch
+ *
+ * @brief   Is the element at a position of BindingIndex[] for the
+ *          endpoint and cluster ID?
+ *
+ * @param   pos - position in BindingIndex[]
+ * @param   ep - source endpoint
+ * @param   clusterID - cluster ID
+ *
+ * @return  TRUE if it matches, FALSE if not or past the end
+ */
+static uint8 bindIdxMatch( uint16 pos, uint8 ep, uint16 clusterID )
+{
+  uint16 e;
+
+  if ( pos >= bindIdxCnt )
+  {
+    return ( FALSE );
+  }
+
+  e = BindingIndex[pos];
+
+  return ( (BIND_IDX_EP( e ) == ep) && (BIND_IDX_CLUSTER( e ) == clusterID) );
+}
+
+/*********************************************************************
+ * @fn      bindIdxAdd
+ *
+ * @brief   Insert the cluster IDs of a binding table entry into
+ *          BindingIndex[]. A cluster ID listed twice is indexed once.
+ *
+ * @param   rec - binding table entry number
+ *
+ * @return  none
+ */
+static void bindIdxAdd( uint16 rec )
+{
+  BindingEntry_t *pBind = &BindingTable[rec];
+  uint8 num;
+  uint8 s;
+  uint8 t;
+  uint16 e;
+  uint16 lo;
+  uint16 hi;
+  uint16 mid;
+
+  bindCurValid = FALSE;
+
+  if ( pBind->srcEP == NV_BIND_EMPTY )
+  {
+    return;
+  }
+
+  num = pBind->numClusterIds;
+  if ( num > gMAX_BINDING_CLUSTER_IDS )
+  {
+    num = gMAX_BINDING_CLUSTER_IDS;
+  }
+
+  for ( s = 0; s < num; s++ )
+  {
+    for ( t = 0; t < s; t++ )
+    {
+      if ( pBind->clusterIdList[t] == pBind->clusterIdList[s] )
+      {
+        break;
+      }
+    }
+
+    if ( t < s )
+    {
+      continue;
+    }
+
+    e = (rec * gMAX_BINDING_CLUSTER_IDS) + s;
+
+    lo = 0;
+    hi = bindIdxCnt;
+    while ( lo < hi )
+    {
+      mid = (lo + hi) >> 1;
+
+      if ( bindIdxLess( BindingIndex[mid], e ) )
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+
+    for ( hi = bindIdxCnt; hi > lo; hi-- )
+    {
+      BindingIndex[hi] = BindingIndex[hi - 1];
+    }
+    BindingIndex[lo] = e;
+    bindIdxCnt++;
+  }
+}
+
+/*********************************************************************
+ * @fn      bindIdxDrop
+ *
+ * @brief   Remove the elements of a binding table entry from
+ *          BindingIndex[], keeping the order of the others.
+ *
+ * @param   rec - binding table entry number
+ *
+ * @return  none
+ */
+static void bindIdxDrop( uint16 rec )
+{
+  uint16 x;
+  uint16 n;
+
+  bindCurValid = FALSE;
+
+  for ( x = 0, n = 0; x < bindIdxCnt; x++ )
+  {
+    if ( BIND_IDX_REC( BindingIndex[x] ) != rec )
+    {
+      BindingIndex[n++] = BindingIndex[x];
+    }
+  }
+
+  bindIdxCnt = n;
+}
+
 /*********************************************************************
  * @fn      bindIsClusterIDinList()
  *
@@ -427,6 +687,8 @@ byte bindRemoveClusterIdFromList( BindingEntry_t *entry, uint16 clusterId )
           }
         }
       }
+
+      bindMarkDirty( entry );
     }
   }
 
@@ -457,6 +719,7 @@ byte bindAddClusterIdToList( BindingEntry_t *entry, uint16 clusterId )
     // Add the new one
     entry->clusterIdList[entry->numClusterIds] = clusterId;
     entry->numClusterIds++;
+    bindMarkDirty( entry );
     return ( TRUE );
   }
   return ( FALSE );
@@ -656,20 +919,12 @@ byte bindNumBoundTo( zAddrType_t *devAddr, byte devEpInt, byte srcMode )
  */
 uint16 bindNumReflections( uint8 ep, uint16 clusterID )
 {
-  uint16 x;
-  BindingEntry_t *pBind;
+  uint16 pos;
   uint16 cnt = 0;
-  uint8 bindEP;
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  for ( pos = bindIdxFirst( ep, clusterID ); bindIdxMatch( pos, ep, clusterID ); pos++ )
   {
-    pBind = &BindingTable[x];
-    bindEP = pBind->srcEP;
-
-    if ( (bindEP == ep) && (bindIsClusterIDinList( pBind, clusterID )) )
-    {
-      cnt++;
-    }
+    cnt++;
   }
 
   return ( cnt );
@@ -689,51 +944,124 @@ uint16 bindNumReflections( uint8 ep, uint16 clusterID )
  */
 BindingEntry_t *bindFind( uint8 ep, uint16 clusterID, uint8 skipping )
 {
-  BindingEntry_t *pBind;
-  byte skipped = 0;
-  uint16 x;
+  uint16 pos;
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  // Matches are adjacent in BindingIndex[], in binding table order. The
+  // next skipping count of the last lookup is the next element.
+  if ( bindCurValid && (skipping != 0) && (skipping == (uint8)(bindCurSkip + 1))
+      && (ep == bindCurEP) && (clusterID == bindCurCluster) )
   {
-    pBind = &BindingTable[x];
+    pos = bindCurPos + 1;
+  }
+  else
+  {
+    pos = bindIdxFirst( ep, clusterID ) + skipping;
+  }
 
-    if ( ( pBind->srcEP == ep) && bindIsClusterIDinList( pBind, clusterID ))
-    {
-      if ( skipped < skipping )
-      {
-        skipped++;
-      }
-      else
-      {
-        return ( pBind );
-      }
-    }
+  bindCurValid = TRUE;
+  bindCurEP = ep;
+  bindCurCluster = clusterID;
+  bindCurSkip = skipping;
+  bindCurPos = pos;
+
+  if ( bindIdxMatch( pos, ep, clusterID ) )
+  {
+    return ( &BindingTable[BIND_IDX_REC( BindingIndex[pos] )] );
+  }
+
+  return ( (BindingEntry_t *)NULL );
+}
+
+/*********************************************************************
+ * @fn          bindFindNext
+ *
+ * @brief       Walks the binding entries for a source endpoint and
+ *              cluster ID, in binding table order. The binding table
+ *              must not change during the walk.
+ *
+ * @param       ep - source endpoint
+ * @param       clusterID - matching clusterID
+ * @param       pIter - walk position, set to BIND_ITER_START for the
+ *                      first entry
+ *
+ * @return      pointer to the next binding table entry, NULL if no more
+ */
+BindingEntry_t *bindFindNext( uint8 ep, uint16 clusterID, uint16 *pIter )
+{
+  uint16 pos;
+
+  if ( *pIter == BIND_ITER_START )
+  {
+    pos = bindIdxFirst( ep, clusterID );
+  }
+  else
+  {
+    pos = *pIter;
+  }
+
+  if ( bindIdxMatch( pos, ep, clusterID ) )
+  {
+    *pIter = pos + 1;
+    return ( &BindingTable[BIND_IDX_REC( BindingIndex[pos] )] );
   }
 
   return ( (BindingEntry_t *)NULL );
 }
 
+/*********************************************************************
+ * @fn          bindBlockLen
+ *
+ * @brief       Length of an NV block of the binding table - the last
+ *              block can hold fewer records.
+ *
+ * @param       blk - block number
+ *
+ * @return      length in bytes
+ */
+static uint16 bindBlockLen( uint16 blk )
+{
+  uint16 recs = gNWK_MAX_BINDING_ENTRIES - (blk * NV_BIND_BLOCK_RECS);
+
+  if ( recs > NV_BIND_BLOCK_RECS )
+  {
+    recs = NV_BIND_BLOCK_RECS;
+  }
+
+  return ( recs * NV_BIND_REC_SIZE );
+}
+
 /*********************************************************************
  * @fn          BindInitNV
  *
- * @brief       Initialize the Binding NV Item
+ * @brief       Initialize the Binding NV Items
  *
  * @param       none
  *
- * @return      ZSUCCESS if successful, NV_ITEM_UNINIT if item did not
+ * @return      ZSUCCESS if successful, NV_ITEM_UNINIT if an item did not
  *              exist in NV, NV_OPER_FAILED if failure.
  */
 byte BindInitNV( void )
 {
-  byte ret;
+  byte ret = ZSUCCESS;
+  byte stat;
+  uint16 blk;
 
-  // Initialize the device list
-  ret = osal_nv_item_init( ZCD_NV_BINDING_TABLE,
-                  (uint16)(gBIND_REC_SIZE + NV_BIND_ITEM_SIZE), NULL );
+  // A new block is left erased, which reads as empty records
+  for ( blk = 0; blk < NV_BIND_BLOCK_CNT; blk++ )
+  {
+    stat = osal_nv_item_init( (ZCD_NV_BINDING_DATA_START + blk), bindBlockLen( blk ), NULL );
+
+    if ( ret != NV_OPER_FAILED && stat != ZSUCCESS )
+    {
+      ret = stat;
+    }
+  }
 
-  if ( ret != ZSUCCESS )
+  // New blocks do not make the table new while the old single item is
+  // still there to be moved into them by BindRestoreFromNV().
+  if ( ret == NV_ITEM_UNINIT && osal_nv_item_len( ZCD_NV_BINDING_TABLE ) != 0 )
   {
-    BindSetDefaultNV();
+    ret = ZSUCCESS;
   }
 
   return ( ret );
@@ -750,13 +1078,22 @@ byte BindInitNV( void )
  */
 void BindSetDefaultNV( void )
 {
-  nvBindingHdr_t hdr;
+  uint16 len;
+  uint16 blk;
 
-  // Initialize the header
-  hdr.numRecs = 0;
+  // Re-create each block erased rather than writing every record
+  for ( blk = 0; blk < NV_BIND_BLOCK_CNT; blk++ )
+  {
+    len = bindBlockLen( blk );
+    osal_nv_delete( (ZCD_NV_BINDING_DATA_START + blk), len );
+    osal_nv_item_init( (ZCD_NV_BINDING_DATA_START + blk), len, NULL );
+  }
 
-  // Save off the header
-  osal_nv_write( ZCD_NV_BINDING_TABLE, 0, sizeof( nvBindingHdr_t ), &hdr );
+  len = osal_nv_item_len( ZCD_NV_BINDING_TABLE );
+  if ( len != 0 )
+  {
+    osal_nv_delete( ZCD_NV_BINDING_TABLE, len );
+  }
 }
 
 /*********************************************************************
@@ -772,27 +1109,53 @@ uint16 BindRestoreFromNV( void )
 {
   nvBindingHdr_t hdr;
   uint16 numAdded = 0;
+  uint16 len;
+  uint16 x;
 
-  if ( osal_nv_read( ZCD_NV_BINDING_TABLE, 0, sizeof(nvBindingHdr_t), &hdr ) == ZSuccess )
+  for ( x = 0; x < NV_BIND_BLOCK_CNT; x++ )
   {
-    if (hdr.numRecs > 0)
+    osal_nv_read( (ZCD_NV_BINDING_DATA_START + x), 0, bindBlockLen( x ),
+                  &BindingTable[x * NV_BIND_BLOCK_RECS] );
+  }
+
+  // A table saved as a single NV item is moved into the blocks. The item is
+  // only deleted once the blocks are written, so it is the latest copy.
+  len = osal_nv_item_len( ZCD_NV_BINDING_TABLE );
+  if ( len != 0 )
+  {
+    if ( osal_nv_read( ZCD_NV_BINDING_TABLE, 0, sizeof(nvBindingHdr_t), &hdr ) == ZSuccess )
     {
-      // Read the whole table at once
-      if ( osal_nv_read( ZCD_NV_BINDING_TABLE,
-                         (uint16)(sizeof(nvBindingHdr_t)),
-                         (NV_BIND_REC_SIZE * gNWK_MAX_BINDING_ENTRIES), BindingTable ) == ZSUCCESS )
+      if ( (hdr.numRecs > 0) &&
+           (osal_nv_read( ZCD_NV_BINDING_TABLE,
+                          (uint16)(sizeof(nvBindingHdr_t)),
+                          (NV_BIND_REC_SIZE * gNWK_MAX_BINDING_ENTRIES), BindingTable ) == ZSUCCESS) )
       {
-        numAdded = gNWK_MAX_BINDING_ENTRIES;
+        osal_memset( BindingTableDirty, 0xFF, (gNWK_MAX_BINDING_ENTRIES + 7) / 8 );
+        BindWriteNV();
       }
     }
+
+    osal_nv_delete( ZCD_NV_BINDING_TABLE, len );
+  }
+
+  bindIdxCnt = 0;
+
+  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  {
+    if ( BindingTable[x].srcEP != NV_BIND_EMPTY )
+    {
+      numAdded = gNWK_MAX_BINDING_ENTRIES;
+      bindIdxAdd( x );
+    }
   }
+
   return ( numAdded );
 }
 
 /*********************************************************************
  * @fn          BindWriteNV
  *
- * @brief       Save the Binding Table in NV
+ * @brief       Save the changed records of the Binding Table in NV
  *
  * @param       none
  *
@@ -800,32 +1163,44 @@ uint16 BindRestoreFromNV( void )
  */
 void BindWriteNV( void )
 {
-  BindingEntry_t *pBind;
-  BindingEntry_t bind;
-  nvBindingHdr_t hdr;
+  uint16 blk;
   uint16 x;
+  uint16 first;
+  uint16 last;
+  uint16 end;
 
-  hdr.numRecs = 0;
-
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  for ( blk = 0; blk < NV_BIND_BLOCK_CNT; blk++ )
   {
-    pBind = &BindingTable[x];
+    x = blk * NV_BIND_BLOCK_RECS;
+    end = x + (bindBlockLen( blk ) / NV_BIND_REC_SIZE);
+    first = end;
+    last = x;
 
-    osal_memcpy( &bind, pBind, gBIND_REC_SIZE );
+    for ( ; x < end; x++ )
+    {
+      if ( BIND_DIRTY_TST( x ) )
+      {
+        BIND_DIRTY_CLR( x );
 
-    // Save the record to NV
-    osal_nv_write( ZCD_NV_BINDING_TABLE,
-                   (uint16)((sizeof(nvBindingHdr_t)) + (x * NV_BIND_REC_SIZE)),
-                   NV_BIND_REC_SIZE, &bind );
+        if ( first == end )
+        {
+          first = x;
+        }
+        last = x;
+      }
+    }
 
-    if ( pBind->srcEP != NV_BIND_EMPTY )
+    if ( first == end )
     {
-      hdr.numRecs++;
+      continue;
     }
-  }
 
-  // Save off the header
-  osal_nv_write( ZCD_NV_BINDING_TABLE, 0, sizeof(nvBindingHdr_t), &hdr );
+
+    // Save the changed records with one write, so the block is rewritten once
+    osal_nv_write( (ZCD_NV_BINDING_DATA_START + blk),
+                   (uint16)((first - (blk * NV_BIND_BLOCK_RECS)) * NV_BIND_REC_SIZE),
+                   (uint16)((last - first + 1) * NV_BIND_REC_SIZE), &BindingTable[first] );
+  }
 }
 
 /*********************************************************************
@@ -859,6 +1234,7 @@ void bindUpdateAddr( uint16 oldAddr, uint16 newAddr )
     if ( pBind->dstIdx == oldIdx )
     {
       pBind->dstIdx = newIdx;
+      bindMarkDirty( pBind );
     }
   }
 }
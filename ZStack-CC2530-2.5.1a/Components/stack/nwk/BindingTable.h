@@ -65,6 +65,9 @@ extern "C" {
 #define DSTGROUPMODE_ADDR     0
 #define DSTGROUPMODE_GROUP    1
 
+// Start value of the walk position of bindFindNext()
+#define BIND_ITER_START       0
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -101,6 +104,13 @@ typedef struct
 // number of records - use gNWK_MAX_BINDING_ENTRIES.
 extern BindingEntry_t BindingTable[];
 
+// Entries changed since the last BindWriteNV(), one bit per entry (nwk_globals.c)
+extern uint8 BindingTableDirty[];
+
+// Binding table entry cluster IDs ordered by source endpoint and cluster ID,
+// for bindFind() (nwk_globals.c)
+extern uint16 BindingIndex[];
+
 /*********************************************************************
  * FUNCTIONS
  */
@@ -115,6 +125,11 @@ extern void InitBindingTable( void );
  */
 extern byte bindRemoveEntry( BindingEntry_t *pBind );
 
+/*
+ * Marks a binding table entry to be saved by the next BindWriteNV().
+ */
+extern void bindMarkDirty( BindingEntry_t *pBind );
+
 /*
  * Is the clusterID in the clusterID list?
  */
@@ -168,6 +183,11 @@ extern uint16 bindNumReflections( uint8 ep, uint16 clusterID );
  */
 extern BindingEntry_t *bindFind( uint8 ep, uint16 clusterID, uint8 skipping );
 
+/*
+ * Walks the binding entries for the source endpoint and clusterID.
+ */
+extern BindingEntry_t *bindFindNext( uint8 ep, uint16 clusterID, uint16 *pIter );
+
 /*
  * Processes the Hand Binding Timeout.
  */
@@ -189,7 +209,7 @@ extern void BindSetDefaultNV( void );
 extern uint16 BindRestoreFromNV( void );
 
 /*
- * Write Binding Table out to NV
+ * Write the changed Binding Table entries out to NV
  */
 extern void BindWriteNV( void );
 
@@ -241,6 +241,12 @@ CONST uint16 gNWK_MAX_BINDING_ENTRIES = NWK_MAX_BINDING_ENTRIES;
 
   // Binding Table
   BindingEntry_t BindingTable[NWK_MAX_BINDING_ENTRIES];
+
+  // Binding Table entries not yet saved in NV, one bit per entry
+  uint8 BindingTableDirty[(NWK_MAX_BINDING_ENTRIES + 7) / 8];
+
+  // Binding Table cluster IDs by source endpoint and cluster ID
+  uint16 BindingIndex[NWK_MAX_BINDING_ENTRIES * MAX_BINDING_CLUSTER_IDS];
 #endif
 
 // Maximum number allowed in the groups table.
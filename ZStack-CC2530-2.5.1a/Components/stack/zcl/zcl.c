@@ -88,6 +88,9 @@
 /*********************************************************************
  * CONSTANTS
  */
+// Largest ZCL header: frame control, manufacturer code, sequence number and command ID.
+// The foundation commands leave this much room in front of their payload for the header.
+#define ZCL_HDR_ROOM                  5
 
 /*********************************************************************
  * TYPEDEFS
@@ -169,6 +172,10 @@ static afIncomingMSGPacket_t *rawAFMsg = NULL;
 void zclProcessMessageMSG( afIncomingMSGPacket_t *pkt );  // Not static for ZNP build.
 static uint8 *zclBuildHdr( zclFrameHdr_t *hdr, uint8 *pData );
 static uint8 zclCalcHdrSize( zclFrameHdr_t *hdr );
+static ZStatus_t zclSendCommand( uint8 srcEP, afAddrType_t *destAddr,
+                                 uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
+                                 uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
+                                 uint16 cmdFormatLen, uint8 *cmdFormat, uint8 hdrRoom );
 static zclLibPlugin_t *zclFindPlugin( uint16 clusterID, uint16 profileID );
 static zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint );
 static zclOptionRec_t *zclFindClusterOption( uint8 endpoint, uint16 clusterID );
@@ -672,14 +679,44 @@ ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *destAddr,
                            uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
                            uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
                            uint16 cmdFormatLen, uint8 *cmdFormat )
+{
+  return ( zclSendCommand( srcEP, destAddr, clusterID, cmd, specific, direction,
+                           disableDefaultRsp, manuCode, seqNum, cmdFormatLen, cmdFormat, 0 ) );
+}
+
+/*********************************************************************
+ * @fn      zclSendCommand
+ *
+ * @brief   Send a command, building its ZCL header in the 'hdrRoom' bytes
+ *          in front of 'cmdFormat' when the caller left enough room there,
+ *          so that the frame goes to AF as a single piece and is only
+ *          copied by the APS. Otherwise the AF gathers header and command.
+ *
+ * @param   srcEp - source endpoint
+ * @param   destAddr - destination address
+ * @param   clusterID - cluster ID
+ * @param   cmd - command ID
+ * @param   specific - whether the command is Cluster Specific
+ * @param   direction - client/server direction of the command
+ * @param   disableDefaultRsp - disable Default Response command
+ * @param   manuCode - manufacturer code for proprietary extensions to a profile
+ * @param   seqNumber - identification number for the transaction
+ * @param   cmdFormatLen - length of the command to be sent
+ * @param   cmdFormat - command to be sent
+ * @param   hdrRoom - bytes free in front of 'cmdFormat', up to ZCL_HDR_ROOM
+ *
+ * @return  ZSuccess if OK
+ */
+static ZStatus_t zclSendCommand( uint8 srcEP, afAddrType_t *destAddr,
+                                 uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
+                                 uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
+                                 uint16 cmdFormatLen, uint8 *cmdFormat, uint8 hdrRoom )
 {
   endPointDesc_t *epDesc;
   zclFrameHdr_t hdr;
-  uint8 *msgBuf;
-  uint16 msgLen;
-  uint8 *pBuf;
+  uint8 hdrBuf[ZCL_HDR_ROOM];
+  afDataSeg_t seg[2];
   uint8 options;
-  ZStatus_t status;
 
   epDesc = afFindEndPointDesc( srcEP );
   if ( epDesc == NULL )
@@ -750,30 +787,23 @@ ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *destAddr,
   // Fill in the command
   hdr.commandID = cmd;
 
-  // calculate the needed buffer size
-  msgLen = zclCalcHdrSize( &hdr );
-  msgLen += cmdFormatLen;
-
-  // Allocate the buffer needed
-  msgBuf = osal_mem_alloc( msgLen );
-  if ( msgBuf != NULL )
+  // Fill in the ZCL Header, right in front of the command frame if there is room
+  seg[0].len = zclCalcHdrSize( &hdr );
+  if ( hdrRoom >= seg[0].len )
   {
-    // Fill in the ZCL Header
-    pBuf = zclBuildHdr( &hdr, msgBuf );
-
-    // Fill in the command frame
-    osal_memcpy( pBuf, cmdFormat, cmdFormatLen );
-
-    status = AF_DataRequest( destAddr, epDesc, clusterID, msgLen, msgBuf,
-                             &zcl_TransID, options, AF_DEFAULT_RADIUS );
-    osal_mem_free ( msgBuf );
+    seg[0].pData = cmdFormat - seg[0].len;
   }
   else
   {
-    status = ZMemError;
+    seg[0].pData = hdrBuf;
   }
+  (void)zclBuildHdr( &hdr, seg[0].pData );
 
-  return ( status );
+  seg[1].pData = cmdFormat;
+  seg[1].len = cmdFormatLen;
+
+  return ( AF_DataRequestSG( destAddr, epDesc, clusterID, seg, 2,
+                             &zcl_TransID, options, AF_DEFAULT_RADIUS ) );
 }
 
 #ifdef ZCL_READ
@@ -802,21 +832,22 @@ ZStatus_t zcl_SendRead( uint8 srcEP, afAddrType_t *dstAddr,
 
   dataLen = readCmd->numAttr * 2; // Attribute ID
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     uint8 i;
 
     // Load the buffer - serially
-    pBuf = buf;
+    pBuf = buf + ZCL_HDR_ROOM;
     for (i = 0; i < readCmd->numAttr; i++)
     {
       *pBuf++ = LO_UINT16( readCmd->attrID[i] );
       *pBuf++ = HI_UINT16( readCmd->attrID[i] );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -872,11 +903,11 @@ ZStatus_t zcl_SendReadRsp( uint8 srcEP, afAddrType_t *dstAddr,
     }
   }
 
-  buf = osal_mem_alloc( len );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + len );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < readRspCmd->numAttr; i++ )
     {
       zclReadRspStatus_t *statusRec = &(readRspCmd->attrList[i]);
@@ -905,8 +936,9 @@ ZStatus_t zcl_SendReadRsp( uint8 srcEP, afAddrType_t *dstAddr,
       }
     } // for loop
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, len, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_RSP, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, len,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -951,11 +983,11 @@ ZStatus_t zcl_SendWriteRequest( uint8 srcEP, afAddrType_t *dstAddr, uint16 clust
     dataLen += zclGetAttrDataLength( statusRec->dataType, statusRec->attrData );
   }
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < writeCmd->numAttr; i++ )
     {
       zclWriteRec_t *statusRec = &(writeCmd->attrList[i]);
@@ -967,8 +999,9 @@ ZStatus_t zcl_SendWriteRequest( uint8 srcEP, afAddrType_t *dstAddr, uint16 clust
       pBuf = zclSerializeData( statusRec->dataType, statusRec->attrData, pBuf );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, cmd, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, cmd, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1002,11 +1035,11 @@ ZStatus_t zcl_SendWriteRsp( uint8 srcEP, afAddrType_t *dstAddr,
 
   dataLen = writeRspCmd->numAttr * ( 1 + 2 ); // status + attribute id
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < writeRspCmd->numAttr; i++ )
     {
       *pBuf++ = writeRspCmd->attrList[i].status;
@@ -1021,8 +1054,9 @@ ZStatus_t zcl_SendWriteRsp( uint8 srcEP, afAddrType_t *dstAddr,
       dataLen = 1;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_WRITE_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_WRITE_RSP, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1079,11 +1113,11 @@ ZStatus_t zcl_SendConfigReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
     }
   }
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < cfgReportCmd->numAttr; i++ )
     {
       zclCfgReportRec_t *reportRec = &(cfgReportCmd->attrList[i]);
@@ -1112,8 +1146,9 @@ ZStatus_t zcl_SendConfigReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
       }
     } // for loop
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_CONFIG_REPORT, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_CONFIG_REPORT, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1148,11 +1183,11 @@ ZStatus_t zcl_SendConfigReportRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
   // Atrribute list (Status, Direction and Attribute ID)
   dataLen = cfgReportRspCmd->numAttr * ( 1 + 1 + 2 );
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < cfgReportRspCmd->numAttr; i++ )
     {
       *pBuf++ = cfgReportRspCmd->attrList[i].status;
@@ -1168,9 +1203,10 @@ ZStatus_t zcl_SendConfigReportRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
       dataLen = 1;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID,
-                              ZCL_CMD_CONFIG_REPORT_RSP, FALSE, direction,
-                              disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID,
+                             ZCL_CMD_CONFIG_REPORT_RSP, FALSE, direction,
+                             disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1204,11 +1240,11 @@ ZStatus_t zcl_SendReadReportCfgCmd( uint8 srcEP, afAddrType_t *dstAddr,
 
   dataLen = readReportCfgCmd->numAttr * ( 1 + 2 ); // Direction + Atrribute ID
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < readReportCfgCmd->numAttr; i++ )
     {
       *pBuf++ = readReportCfgCmd->attrList[i].direction;
@@ -1216,8 +1252,9 @@ ZStatus_t zcl_SendReadReportCfgCmd( uint8 srcEP, afAddrType_t *dstAddr,
       *pBuf++ = HI_UINT16( readReportCfgCmd->attrList[i].attrID );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_REPORT_CFG, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_REPORT_CFG, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1275,11 +1312,11 @@ ZStatus_t zcl_SendReadReportCfgRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
     }
   }
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < readReportCfgRspCmd->numAttr; i++ )
     {
       zclReportCfgRspRec_t *reportRspRec = &(readReportCfgRspCmd->attrList[i]);
@@ -1313,9 +1350,10 @@ ZStatus_t zcl_SendReadReportCfgRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
       }
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID,
-                              ZCL_CMD_READ_REPORT_CFG_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID,
+                             ZCL_CMD_READ_REPORT_CFG_RSP, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1358,11 +1396,11 @@ ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
     dataLen += zclGetAttrDataLength( reportRec->dataType, reportRec->attrData );
   }
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     for ( uint8 i = 0; i < reportCmd->numAttr; i++ )
     {
       zclReport_t *reportRec = &(reportCmd->attrList[i]);
@@ -1374,8 +1412,9 @@ ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
       pBuf = zclSerializeData( reportRec->dataType, reportRec->attrData, pBuf );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_REPORT, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_REPORT, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1409,14 +1448,15 @@ ZStatus_t zcl_SendDefaultRspCmd( uint8 srcEP, afAddrType_t *dstAddr, uint16 clus
                                  zclDefaultRspCmd_t *defaultRspCmd, uint8 direction,
                                  uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum )
 {
-  uint8 buf[2]; // Command ID and Status;
+  uint8 buf[ZCL_HDR_ROOM + 2]; // Header room, Command ID and Status;
 
   // Load the buffer - serially
-  buf[0] = defaultRspCmd->commandID;
-  buf[1] = defaultRspCmd->statusCode;
+  buf[ZCL_HDR_ROOM] = defaultRspCmd->commandID;
+  buf[ZCL_HDR_ROOM + 1] = defaultRspCmd->statusCode;
 
-  return ( zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DEFAULT_RSP, FALSE,
-                            direction, disableDefaultRsp, manuCode, seqNum, 2, buf ) );
+  return ( zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DEFAULT_RSP, FALSE,
+                           direction, disableDefaultRsp, manuCode, seqNum, 2,
+                           buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM ) );
 }
 
 #ifdef ZCL_DISCOVER
@@ -1441,17 +1481,18 @@ ZStatus_t zcl_SendDiscoverCmd( uint8 srcEP, afAddrType_t *dstAddr,
   uint8 *buf;
   ZStatus_t status;
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     *pBuf++ = LO_UINT16(discoverCmd->startAttr);
     *pBuf++ = HI_UINT16(discoverCmd->startAttr);
     *pBuf++ = discoverCmd->maxAttrIDs;
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
@@ -1486,11 +1527,11 @@ ZStatus_t zcl_SendDiscoverRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
   // calculate the size of the command
   dataLen += discoverRspCmd->numAttr * (2 + 1); // Attribute ID and Data Type
 
-  buf = osal_mem_alloc( dataLen );
+  buf = osal_mem_alloc( ZCL_HDR_ROOM + dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
-    uint8 *pBuf = buf;
+    uint8 *pBuf = buf + ZCL_HDR_ROOM;
     *pBuf++ = discoverRspCmd->discComplete;
     for ( uint8 i = 0; i < discoverRspCmd->numAttr; i++ )
     {
@@ -1499,8 +1540,9 @@ ZStatus_t zcl_SendDiscoverRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
       *pBuf++ = discoverRspCmd->attrList[i].dataType;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    status = zclSendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_RSP, FALSE,
+                             direction, disableDefaultRsp, 0, seqNum, dataLen,
+                             buf + ZCL_HDR_ROOM, ZCL_HDR_ROOM );
     osal_mem_free( buf );
   }
   else
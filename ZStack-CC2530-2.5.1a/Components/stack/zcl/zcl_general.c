@@ -61,11 +61,32 @@
 
 #ifdef ZCL_SCENES
 #define zclGeneral_ScenesRemaingCapacity() ( ZCL_GEN_MAX_SCENES - zclGeneral_CountAllScenes() )
+
+// Index bucket of a scene - the endpoint is left out so that the 0xFF
+// wildcard of zclGeneral_FindScene() still lands in a single bucket
+#define zclGeneral_SceneHash( groupID, sceneID ) \
+  ( ( LO_UINT16( groupID ) ^ HI_UINT16( groupID ) ^ (sceneID) ) & ( ZCL_GEN_SCENE_HASH_CNT - 1 ) )
+
+// Slot bitmap access
+#define zclGeneral_SlotTst( map, slot )    ( (map)[(slot) >> 3] & BV( (slot) & 0x07 ) )
+#define zclGeneral_SlotSet( map, slot )    ( (map)[(slot) >> 3] |= BV( (slot) & 0x07 ) )
+#define zclGeneral_SlotClr( map, slot )    ( (map)[(slot) >> 3] &= ~BV( (slot) & 0x07 ) )
 #endif // ZCL_SCENES
 
 /*********************************************************************
  * CONSTANTS
  */
+#ifdef ZCL_SCENES
+// Endpoint stored in the NV record of a free scene slot
+#define ZCL_GEN_SCENE_FREE_EP              0x00
+
+#if ( ZCL_GEN_MAX_SCENES > ( ZCD_NV_SCENE_DATA_END - ZCD_NV_SCENE_DATA_START + 1 ) )
+  #error "ZCL_GEN_MAX_SCENES exceeds the NV items reserved for scenes"
+#endif
+
+// Length of a slot bitmap
+#define ZCL_GEN_SCENE_MAP_LEN              ( ( ZCL_GEN_MAX_SCENES + 7 ) / 8 )
+#endif // ZCL_SCENES
 
 /*********************************************************************
  * TYPEDEFS
@@ -79,8 +100,9 @@ typedef struct zclGenCBRec
 
 typedef struct zclGenSceneItem
 {
-  struct zclGenSceneItem    *next;
+  struct zclGenSceneItem    *next;    // Next scene in the same index bucket
   uint8                     endpoint; // Used to link it into the endpoint descriptor
+  uint8                     slot;     // NV record is ZCD_NV_SCENE_DATA_START + slot
   zclGeneral_Scene_t        scene;    // Scene info
 } zclGenSceneItem_t;
 
@@ -94,7 +116,7 @@ typedef struct zclGenAlarmItem
 // Scene NV types
 typedef struct
 {
-  uint16                    numRecs;
+  uint16                    numRecs;  // Records in the old ZCD_NV_SCENE_TABLE item
 } nvGenScenesHdr_t;
 
 typedef struct zclGenSceneNVItem
@@ -117,7 +139,13 @@ typedef struct zclGenSceneNVItem
 static zclGenCBRec_t *zclGenCBs = (zclGenCBRec_t *)NULL;
 static uint8 zclGenPluginRegisted = FALSE;
 #ifdef ZCL_SCENES
-static zclGenSceneItem_t *zclGenSceneTable = (zclGenSceneItem_t *)NULL;
+// Scenes hashed on group ID and scene ID
+static zclGenSceneItem_t *zclGenSceneTable[ZCL_GEN_SCENE_HASH_CNT];
+static uint8 zclGenSceneCnt = 0;
+
+// NV records in use and NV records not yet saved, one bit per slot
+static uint8 zclGenSceneUsed[ZCL_GEN_SCENE_MAP_LEN];
+static uint8 zclGenSceneDirty[ZCL_GEN_SCENE_MAP_LEN];
 #endif // ZCL_SCENES
 #ifdef ZCL_ALARMS
 static zclGenAlarmItem_t *zclGenAlarmTable = (zclGenAlarmItem_t *)NULL;
@@ -173,8 +201,9 @@ static ZStatus_t zclGeneral_ProcessInLocationClient( zclIncoming_t *pInMsg, zclG
 #endif // ZCL_LOCATION
 
 #ifdef ZCL_SCENES
-static uint8 zclGeneral_ScenesInitNV( void );
-static void zclGeneral_ScenesSetDefaultNV( void );
+static zclGenSceneItem_t *zclGeneral_LinkScene( uint8 endpoint, zclGeneral_Scene_t *scene, uint8 slot );
+static void zclGeneral_FreeScene( uint8 bucket, zclGenSceneItem_t *pPrev, zclGenSceneItem_t *pItem );
+static void zclGeneral_SceneChanged( zclGeneral_Scene_t *pScene );
 static void zclGeneral_ScenesWriteNV( void );
 static uint16 zclGeneral_ScenesRestoreFromNV( void );
 #endif // ZCL_SCENES
@@ -202,9 +231,6 @@ ZStatus_t zclGeneral_RegisterCmdCallbacks( uint8 endpoint, zclGeneral_AppCallbac
                         zclGeneral_HdlIncoming );
 
 #ifdef ZCL_SCENES
-    // Initialize NV items
-    zclGeneral_ScenesInitNV();
-
     // Restore the Scene table
     zclGeneral_ScenesRestoreFromNV();
 #endif // ZCL_SCENES
@@ -1537,7 +1563,7 @@ static ZStatus_t zclGeneral_AddGroup( uint8 endPoint, aps_Group_t *group, uint8
     osal_memcpy( &(group->name[1]), pData, nameLen );
   }
 
-  return ( aps_AddGroup( endPoint, group ) );
+  return ( afAddGroup( endPoint, group ) );
 }
 
 /*********************************************************************
@@ -1651,7 +1677,7 @@ static ZStatus_t zclGeneral_ProcessInGroupsServer( zclIncoming_t *pInMsg )
       break;
 
     case COMMAND_GROUP_REMOVE:
-      if ( aps_RemoveGroup( pInMsg->msg->endPoint, group.ID ) )
+      if ( afRemoveGroup( pInMsg->msg->endPoint, group.ID ) )
         status = ZCL_STATUS_SUCCESS;
       else
         status = ZCL_STATUS_NOT_FOUND;
@@ -1661,7 +1687,7 @@ static ZStatus_t zclGeneral_ProcessInGroupsServer( zclIncoming_t *pInMsg )
       break;
 
     case COMMAND_GROUP_REMOVE_ALL:
-      aps_RemoveAllGroup( pInMsg->msg->endPoint );
+      afRemoveAllGroup( pInMsg->msg->endPoint );
       break;
 
     case COMMAND_GROUP_ADD_IF_IDENTIFYING:
@@ -1791,43 +1817,130 @@ static ZStatus_t zclGeneral_ProcessInGroupsClient( zclIncoming_t *pInMsg,
  * @param   endpoint -
  * @param   scene - new scene item
  *
- * @return  ZStatus_t
+ * @return  ZSuccess, ZFailure if the table is full, ZMemError, or
+ *          NV_OPER_FAILED if the scene's NV record could not be created
  */
 ZStatus_t zclGeneral_AddScene( uint8 endpoint, zclGeneral_Scene_t *scene )
 {
-  zclGenSceneItem_t *pNewItem;
-  zclGenSceneItem_t *pLoop;
+  uint8 slot;
 
-  // Fill in the new profile list
-  pNewItem = osal_mem_alloc( sizeof( zclGenSceneItem_t ) );
-  if ( pNewItem == NULL )
+  // Look for a free NV record
+  for ( slot = 0; slot < ZCL_GEN_MAX_SCENES; slot++ )
+  {
+    if ( !zclGeneral_SlotTst( zclGenSceneUsed, slot ) )
+      break;
+  }
+
+  if ( slot == ZCL_GEN_MAX_SCENES )
+    return ( ZFailure );
+
+  if ( zclGeneral_LinkScene( endpoint, scene, slot ) == NULL )
     return ( ZMemError );
 
-  // Fill in the plugin record.
-  pNewItem->next = (zclGenSceneItem_t *)NULL;
-  pNewItem->endpoint = endpoint;
-  osal_memcpy( (uint8*)&(pNewItem->scene), (uint8*)scene, sizeof ( zclGeneral_Scene_t ));
+  // Update NV
+  zclGeneral_SlotSet( zclGenSceneDirty, slot );
+  zclGeneral_ScenesWriteNV();
 
-  // Find spot in list
-  if (  zclGenSceneTable == NULL )
+  // A scene without an NV record would be lost at the next reset
+  if ( osal_nv_item_len( ZCD_NV_SCENE_DATA_START + slot ) == 0 )
   {
-    zclGenSceneTable = pNewItem;
+    zclGeneral_RemoveScene( endpoint, scene->groupID, scene->ID );
+    return ( NV_OPER_FAILED );
   }
-  else
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_LinkScene
+ *
+ * @brief   Add a scene to the RAM index without updating NV
+ *
+ * @param   endpoint -
+ * @param   scene - new scene item
+ * @param   slot - NV record of the scene
+ *
+ * @return  pointer to the new item, NULL if not able to allocate
+ */
+static zclGenSceneItem_t *zclGeneral_LinkScene( uint8 endpoint, zclGeneral_Scene_t *scene, uint8 slot )
+{
+  zclGenSceneItem_t *pNewItem;
+  uint8 bucket;
+
+  // Fill in the new profile list
+  pNewItem = osal_mem_alloc( sizeof( zclGenSceneItem_t ) );
+  if ( pNewItem != NULL )
   {
-    // Look for end of list
-    pLoop = zclGenSceneTable;
-    while ( pLoop->next != NULL )
-      pLoop = pLoop->next;
+    // Fill in the plugin record.
+    pNewItem->endpoint = endpoint;
+    pNewItem->slot = slot;
+    osal_memcpy( (uint8*)&(pNewItem->scene), (uint8*)scene, sizeof ( zclGeneral_Scene_t ));
+
+    // Put new item at the head of its bucket
+    bucket = zclGeneral_SceneHash( scene->groupID, scene->ID );
+    pNewItem->next = zclGenSceneTable[bucket];
+    zclGenSceneTable[bucket] = pNewItem;
+
+    zclGeneral_SlotSet( zclGenSceneUsed, slot );
+    zclGenSceneCnt++;
+  }
 
-    // Put new item at end of list
-    pLoop->next = pNewItem;
+  return ( pNewItem );
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_FreeScene
+ *
+ * @brief   Unlink a scene from the RAM index and mark its NV record
+ *          to be freed
+ *
+ * @param   bucket - index bucket of the scene
+ * @param   pPrev - previous item in the bucket, NULL if first
+ * @param   pItem - item to free
+ *
+ * @return  none
+ */
+static void zclGeneral_FreeScene( uint8 bucket, zclGenSceneItem_t *pPrev, zclGenSceneItem_t *pItem )
+{
+  if ( pPrev == NULL )
+    zclGenSceneTable[bucket] = pItem->next;
+  else
+    pPrev->next = pItem->next;
+
+  zclGeneral_SlotClr( zclGenSceneUsed, pItem->slot );
+  zclGeneral_SlotSet( zclGenSceneDirty, pItem->slot );
+  zclGenSceneCnt--;
+
+  // Free the memory
+  osal_mem_free( pItem );
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_SceneChanged
+ *
+ * @brief   Save a scene that was updated in place
+ *
+ * @param   pScene - scene returned by zclGeneral_FindScene()
+ *
+ * @return  none
+ */
+static void zclGeneral_SceneChanged( zclGeneral_Scene_t *pScene )
+{
+  zclGenSceneItem_t *pLoop;
+
+  pLoop = zclGenSceneTable[zclGeneral_SceneHash( pScene->groupID, pScene->ID )];
+  while ( pLoop )
+  {
+    if ( &(pLoop->scene) == pScene )
+    {
+      zclGeneral_SlotSet( zclGenSceneDirty, pLoop->slot );
+      break;
+    }
+    pLoop = pLoop->next;
   }
 
   // Update NV
   zclGeneral_ScenesWriteNV();
-
-  return ( ZSuccess );
 }
 
 /*********************************************************************
@@ -1845,8 +1958,8 @@ zclGeneral_Scene_t *zclGeneral_FindScene( uint8 endpoint, uint16 groupID, uint8
 {
   zclGenSceneItem_t *pLoop;
 
-  // Look for end of list
-  pLoop = zclGenSceneTable;
+  // Only the scene's bucket can hold it
+  pLoop = zclGenSceneTable[zclGeneral_SceneHash( groupID, sceneID )];
   while ( pLoop )
   {
     if ( (pLoop->endpoint == endpoint || endpoint == 0xFF)
@@ -1873,15 +1986,19 @@ zclGeneral_Scene_t *zclGeneral_FindScene( uint8 endpoint, uint16 groupID, uint8
 uint8 zclGeneral_FindAllScenesForGroup( uint8 endpoint, uint16 groupID, uint8 *sceneList )
 {
   zclGenSceneItem_t *pLoop;
+  uint8 bucket;
   uint8 cnt = 0;
 
-  // Look for end of list
-  pLoop = zclGenSceneTable;
-  while ( pLoop )
+  // The scenes of a group are spread over all of the buckets
+  for ( bucket = 0; bucket < ZCL_GEN_SCENE_HASH_CNT; bucket++ )
   {
-    if ( pLoop->endpoint == endpoint && pLoop->scene.groupID == groupID )
-      sceneList[cnt++] = pLoop->scene.ID;
-    pLoop = pLoop->next;
+    pLoop = zclGenSceneTable[bucket];
+    while ( pLoop )
+    {
+      if ( pLoop->endpoint == endpoint && pLoop->scene.groupID == groupID )
+        sceneList[cnt++] = pLoop->scene.ID;
+      pLoop = pLoop->next;
+    }
   }
   return ( cnt );
 }
@@ -1901,22 +2018,17 @@ uint8 zclGeneral_RemoveScene( uint8 endpoint, uint16 groupID, uint8 sceneID )
 {
   zclGenSceneItem_t *pLoop;
   zclGenSceneItem_t *pPrev;
+  uint8 bucket = zclGeneral_SceneHash( groupID, sceneID );
 
-  // Look for end of list
-  pLoop = zclGenSceneTable;
+  // Only the scene's bucket can hold it
+  pLoop = zclGenSceneTable[bucket];
   pPrev = NULL;
   while ( pLoop )
   {
     if ( pLoop->endpoint == endpoint
         && pLoop->scene.groupID == groupID && pLoop->scene.ID == sceneID )
     {
-      if ( pPrev == NULL )
-        zclGenSceneTable = pLoop->next;
-      else
-        pPrev->next = pLoop->next;
-
-      // Free the memory
-      osal_mem_free( pLoop );
+      zclGeneral_FreeScene( bucket, pPrev, pLoop );
 
       // Update NV
       zclGeneral_ScenesWriteNV();
@@ -1945,29 +2057,25 @@ void zclGeneral_RemoveAllScenes( uint8 endpoint, uint16 groupID )
   zclGenSceneItem_t *pLoop;
   zclGenSceneItem_t *pPrev;
   zclGenSceneItem_t *pNext;
+  uint8 bucket;
 
-  // Look for end of list
-  pLoop = zclGenSceneTable;
-  pPrev = NULL;
-  while ( pLoop )
+  for ( bucket = 0; bucket < ZCL_GEN_SCENE_HASH_CNT; bucket++ )
   {
-    if ( pLoop->endpoint == endpoint && pLoop->scene.groupID == groupID )
+    pLoop = zclGenSceneTable[bucket];
+    pPrev = NULL;
+    while ( pLoop )
     {
-      if ( pPrev == NULL )
-        zclGenSceneTable = pLoop->next;
-      else
-        pPrev->next = pLoop->next;
       pNext = pLoop->next;
-
-      // Free the memory
-      osal_mem_free( pLoop );
+      if ( pLoop->endpoint == endpoint && pLoop->scene.groupID == groupID )
+      {
+        zclGeneral_FreeScene( bucket, pPrev, pLoop );
+      }
+      else
+      {
+        pPrev = pLoop;
+      }
       pLoop = pNext;
     }
-    else
-    {
-      pPrev = pLoop;
-      pLoop = pLoop->next;
-    }
   }
 
   // Update NV
@@ -1986,15 +2094,18 @@ void zclGeneral_RemoveAllScenes( uint8 endpoint, uint16 groupID )
 uint8 zclGeneral_CountScenes( uint8 endpoint )
 {
   zclGenSceneItem_t *pLoop;
+  uint8 bucket;
   uint8 cnt = 0;
 
-  // Look for end of list
-  pLoop = zclGenSceneTable;
-  while ( pLoop )
+  for ( bucket = 0; bucket < ZCL_GEN_SCENE_HASH_CNT; bucket++ )
   {
-    if ( pLoop->endpoint == endpoint  )
-      cnt++;
-    pLoop = pLoop->next;
+    pLoop = zclGenSceneTable[bucket];
+    while ( pLoop )
+    {
+      if ( pLoop->endpoint == endpoint  )
+        cnt++;
+      pLoop = pLoop->next;
+    }
   }
   return ( cnt );
 }
@@ -2010,17 +2121,7 @@ uint8 zclGeneral_CountScenes( uint8 endpoint )
  */
 uint8 zclGeneral_CountAllScenes( void )
 {
-  zclGenSceneItem_t *pLoop;
-  uint8 cnt = 0;
-
-  // Look for end of list
-  pLoop = zclGenSceneTable;
-  while ( pLoop )
-  {
-    cnt++;
-    pLoop = pLoop->next;
-  }
-  return ( cnt );
+  return ( zclGenSceneCnt );
 }
 
 /*********************************************************************
@@ -2162,12 +2263,12 @@ static ZStatus_t zclGeneral_ProcessInScenesServer( zclIncoming_t *pInMsg,
             pScene->extLen = scene.extLen;
 
             // Update NV
-            zclGeneral_ScenesWriteNV();
+            zclGeneral_SceneChanged( pScene );
           }
-          else
+          else if ( zclGeneral_AddScene( pInMsg->msg->endPoint, &scene ) != ZSuccess )
           {
-            // The Scene doesn't exist so add it
-            zclGeneral_AddScene( pInMsg->msg->endPoint, &scene );
+            // The Scene doesn't exist and could not be added
+            status = ZCL_STATUS_INSUFFICIENT_SPACE;
           }
         }
         else
@@ -2296,12 +2397,15 @@ static ZStatus_t zclGeneral_ProcessInScenesServer( zclIncoming_t *pInMsg,
           if ( pScene == &scene )
           {
             // The Scene doesn't exist so add it
-            zclGeneral_AddScene( pInMsg->msg->endPoint, &scene );
+            if ( zclGeneral_AddScene( pInMsg->msg->endPoint, &scene ) != ZSuccess )
+            {
+              status = ZCL_STATUS_INSUFFICIENT_SPACE;
+            }
           }
           else if ( sceneChanged )
           {
             // The Scene already exists so update only NV
-            zclGeneral_ScenesWriteNV();
+            zclGeneral_SceneChanged( pScene );
           }
         }
         else
@@ -3268,57 +3372,10 @@ static ZStatus_t zclGeneral_ProcessInLocationClient( zclIncoming_t *pInMsg,
 #endif // ZCL_LOCATION
 
 #ifdef ZCL_SCENES
-/*********************************************************************
- * @fn      zclGeneral_ScenesInitNV
- *
- * @brief   Initialize the NV Scene Table Items
- *
- * @param   none
- *
- * @return  number of scenes
- */
-static uint8 zclGeneral_ScenesInitNV( void )
-{
-  uint8  status;
-  uint16 size;
-
-  size = (uint16)((sizeof ( nvGenScenesHdr_t ))
-                  + ( sizeof( zclGenSceneNVItem_t ) * ZCL_GEN_MAX_SCENES ));
-
-  status = osal_nv_item_init( ZCD_NV_SCENE_TABLE, size, NULL );
-
-  if ( status != ZSUCCESS )
-  {
-    zclGeneral_ScenesSetDefaultNV();
-  }
-
-  return status;
-}
-
-/*********************************************************************
- * @fn          zclGeneral_ScenesSetDefaultNV
- *
- * @brief       Write the defaults to NV
- *
- * @param       none
- *
- * @return      none
- */
-static void zclGeneral_ScenesSetDefaultNV( void )
-{
-  nvGenScenesHdr_t hdr;
-
-  // Initialize the header
-  hdr.numRecs = 0;
-
-  // Save off the header
-  osal_nv_write( ZCD_NV_SCENE_TABLE, 0, sizeof( nvGenScenesHdr_t ), &hdr );
-}
-
 /*********************************************************************
  * @fn          zclGeneral_ScenesWriteNV
  *
- * @brief       Save the Scene Table in NV
+ * @brief       Save the changed records of the Scene Table in NV
  *
  * @param       none
  *
@@ -3326,32 +3383,50 @@ static void zclGeneral_ScenesSetDefaultNV( void )
  */
 static void zclGeneral_ScenesWriteNV( void )
 {
-  nvGenScenesHdr_t hdr;
   zclGenSceneItem_t *pLoop;
   zclGenSceneNVItem_t item;
+  uint8 bucket;
+  uint16 slot;
 
-  hdr.numRecs = 0;
-
-  // Look for end of list
-  pLoop = zclGenSceneTable;
-  while ( pLoop )
+  // Save the records of new and changed scenes
+  for ( bucket = 0; bucket < ZCL_GEN_SCENE_HASH_CNT; bucket++ )
   {
-    // Build the record
-    item.endpoint = pLoop->endpoint;
-    osal_memcpy( &(item.scene), &(pLoop->scene), sizeof ( zclGeneral_Scene_t ) );
-
-    // Save the record to NV
-    osal_nv_write( ZCD_NV_SCENE_TABLE,
-            (uint16)((sizeof( nvGenScenesHdr_t )) + (hdr.numRecs * sizeof ( zclGenSceneNVItem_t ))),
-                    sizeof ( zclGenSceneNVItem_t ), &item );
+    pLoop = zclGenSceneTable[bucket];
+    while ( pLoop )
+    {
+      if ( zclGeneral_SlotTst( zclGenSceneDirty, pLoop->slot ) )
+      {
+        zclGeneral_SlotClr( zclGenSceneDirty, pLoop->slot );
 
-    hdr.numRecs++;
+        // Build the record
+        item.endpoint = pLoop->endpoint;
+        osal_memcpy( &(item.scene), &(pLoop->scene), sizeof ( zclGeneral_Scene_t ) );
 
-    pLoop = pLoop->next;
+        // Save the record to NV
+        if ( osal_nv_item_init( (ZCD_NV_SCENE_DATA_START + pLoop->slot),
+                                sizeof ( zclGenSceneNVItem_t ), &item ) == SUCCESS )
+        {
+          // The record already exists in NV so overwrite it
+          osal_nv_write( (ZCD_NV_SCENE_DATA_START + pLoop->slot), 0,
+                         sizeof ( zclGenSceneNVItem_t ), &item );
+        }
+      }
+      pLoop = pLoop->next;
+    }
   }
 
-  // Save off the header
-  osal_nv_write( ZCD_NV_SCENE_TABLE, 0, sizeof( nvGenScenesHdr_t ), &hdr );
+  // The dirty slots left are those of removed scenes - only their endpoint changes
+  item.endpoint = ZCL_GEN_SCENE_FREE_EP;
+  for ( slot = 0; slot < ZCL_GEN_MAX_SCENES; slot++ )
+  {
+    if ( zclGeneral_SlotTst( zclGenSceneDirty, slot ) )
+    {
+      zclGeneral_SlotClr( zclGenSceneDirty, slot );
+
+      osal_nv_write( (ZCD_NV_SCENE_DATA_START + slot), 0,
+                     sizeof ( item.endpoint ), &(item.endpoint) );
+    }
+  }
 }
 
 /*********************************************************************
@@ -3366,27 +3441,53 @@ static void zclGeneral_ScenesWriteNV( void )
 static uint16 zclGeneral_ScenesRestoreFromNV( void )
 {
   uint16 x;
+  uint16 len;
   nvGenScenesHdr_t hdr;
 
   zclGenSceneNVItem_t item;
   uint16 numAdded = 0;
 
-  if ( osal_nv_read( ZCD_NV_SCENE_TABLE, 0, sizeof(nvGenScenesHdr_t), &hdr ) == ZSuccess )
+  // Every slot is read: a record that could not be created, such as when
+  // NV was full, leaves a gap before the records of later slots
+  for ( x = 0; x < ZCL_GEN_MAX_SCENES; x++ )
   {
-    // Read in the device list
-    for ( x = 0; x < hdr.numRecs; x++ )
+    if ( osal_nv_read( (ZCD_NV_SCENE_DATA_START + x), 0,
+                       sizeof ( zclGenSceneNVItem_t ), &item ) != ZSUCCESS )
     {
-      if ( osal_nv_read( ZCD_NV_SCENE_TABLE,
-                (uint16)(sizeof(nvGenScenesHdr_t) + (x * sizeof ( zclGenSceneNVItem_t ))),
-                                  sizeof ( zclGenSceneNVItem_t ), &item ) == ZSUCCESS )
+      continue;
+    }
+
+    // Add the scene
+    if ( item.endpoint != ZCL_GEN_SCENE_FREE_EP &&
+         zclGeneral_LinkScene( item.endpoint, &(item.scene), (uint8)x ) != NULL )
+    {
+      numAdded++;
+    }
+  }
+
+  // Move a table saved as a single NV item into the records
+  len = osal_nv_item_len( ZCD_NV_SCENE_TABLE );
+  if ( len != 0 )
+  {
+    if ( osal_nv_read( ZCD_NV_SCENE_TABLE, 0, sizeof(nvGenScenesHdr_t), &hdr ) == ZSuccess )
+    {
+      for ( x = 0; x < hdr.numRecs; x++ )
       {
-        // Add the scene
-        if ( zclGeneral_AddScene( item.endpoint, &(item.scene) ) == ZSuccess )
+        if ( osal_nv_read( ZCD_NV_SCENE_TABLE,
+                  (uint16)(sizeof(nvGenScenesHdr_t) + (x * sizeof ( zclGenSceneNVItem_t ))),
+                                    sizeof ( zclGenSceneNVItem_t ), &item ) == ZSUCCESS )
         {
-          numAdded++;
+          // A scene moved before a reset interrupted the move is already in
+          if ( zclGeneral_FindScene( item.endpoint, item.scene.groupID, item.scene.ID ) == NULL &&
+               zclGeneral_AddScene( item.endpoint, &(item.scene) ) == ZSuccess )
+          {
+            numAdded++;
+          }
         }
       }
     }
+
+    osal_nv_delete( ZCD_NV_SCENE_TABLE, len );
   }
 
   return ( numAdded );
@@ -888,8 +888,17 @@ extern "C"
 //   2 + 1 + 2 for Window Covering cluster (LiftPercentage/TiltPercentage attributes)
 #define ZCL_GEN_SCENE_EXT_LEN                            24
 
-// The maximum number of entries in the Scene table
+// The maximum number of entries in the Scene table (at most 255, since the
+// Scene Count attribute is a uint8). Each entry has its own NV item, starting
+// at ZCD_NV_SCENE_DATA_START.
+#ifndef ZCL_GEN_MAX_SCENES
 #define ZCL_GEN_MAX_SCENES                               16
+#endif
+
+// The number of buckets in the RAM index of the Scene table (a power of 2)
+#ifndef ZCL_GEN_SCENE_HASH_CNT
+#define ZCL_GEN_SCENE_HASH_CNT                           8
+#endif
 
 /*********************************************************************
  * TYPEDEFS
@@ -122,7 +122,6 @@ static uint8 zclOTA_Certificate[OTA_CERTIFICATE_LEN];
 static uint32 zclOTA_DownloadedImageSize;  // Downloaded image size
 static uint16 zclOTA_HeaderLen;            // Image header length
 
-static uint16 zclOTA_UpdateDelay;
 static zclOTA_FileID_t zclOTA_CurrentDlFileId;
 
 static uint16 zclOTA_ElementTag;
@@ -145,7 +144,7 @@ static const uint8 zclOTA_HdrMagic[] = {0x1E, 0xF1, 0xEE, 0x0B};
 static ZStatus_t zclOTA_HdlIncoming( zclIncoming_t *pInMsg );
 
 #if (defined OTA_CLIENT) && (OTA_CLIENT == TRUE)
-static void zclOTA_StartTimer(uint16 eventId, uint32 minutes);
+static void zclOTA_StartTimer(uint16 eventId, uint32 seconds);
 static ZStatus_t sendImageBlockReq(afAddrType_t *dstAddr);
 static void zclOTA_ProcessZDOMsgs( zdoIncomingMsg_t *pMsg );
 static void zclOTA_ImageBlockWaitExpired(void);
@@ -462,58 +461,40 @@ uint16 zclOTA_event_loop( uint8 task_id, uint16 events )
 #if (defined OTA_CLIENT) && (OTA_CLIENT == TRUE)
   if ( events & ZCL_OTA_IMAGE_BLOCK_WAIT_EVT )
   {
-    // If the time has expired, perform the required action
-    if (zclOTA_UpdateDelay == 0)
-    {
-      zclOTA_ImageBlockWaitExpired();
-    }
-    else
-    {
-      // Decrement the number of minutes to wait and reset the timer
-      zclOTA_UpdateDelay--;
-      osal_start_timerEx(zclOTA_TaskID, ZCL_OTA_IMAGE_BLOCK_WAIT_EVT, 60000);
-    }
+    // The time has expired, perform the required action
+    zclOTA_ImageBlockWaitExpired();
 
     return ( events ^ ZCL_OTA_IMAGE_BLOCK_WAIT_EVT );
   }
 
   if ( events & ZCL_OTA_UPGRADE_WAIT_EVT )
   {
-    // If the time has expired, perform the required action
-    if (zclOTA_UpdateDelay == 0)
+    // The time has expired, perform the required action
+    if (zclOTA_ImageUpgradeStatus == OTA_STATUS_COUNTDOWN)
     {
-      if (zclOTA_ImageUpgradeStatus == OTA_STATUS_COUNTDOWN)
+      zclOTA_UpgradeComplete(ZSuccess);
+    }
+    else if (zclOTA_ImageUpgradeStatus == OTA_STATUS_UPGRADE_WAIT)
+    {
+      if (++zclOTA_UpgradeEndRetry > OTA_MAX_END_REQ_RETRIES)
       {
+        // If we have not heard from the server for N retries, perform the upgrade
         zclOTA_UpgradeComplete(ZSuccess);
       }
-      else if (zclOTA_ImageUpgradeStatus == OTA_STATUS_UPGRADE_WAIT)
+      else
       {
-        if (++zclOTA_UpgradeEndRetry > OTA_MAX_END_REQ_RETRIES)
-        {
-          // If we have not heard from the server for N retries, perform the upgrade
-          zclOTA_UpgradeComplete(ZSuccess);
-        }
-        else
-        {
-          // Send another update end request
-          zclOTA_UpgradeEndReqParams_t  req;
+        // Send another update end request
+        zclOTA_UpgradeEndReqParams_t  req;
 
-          req.status = ZSuccess;
-          osal_memcpy(&req.fileId, &zclOTA_CurrentDlFileId, sizeof(zclOTA_FileID_t));
+        req.status = ZSuccess;
+        osal_memcpy(&req.fileId, &zclOTA_CurrentDlFileId, sizeof(zclOTA_FileID_t));
 
-          zclOTA_SendUpgradeEndReq(&zclOTA_serverAddr, &req);
+        zclOTA_SendUpgradeEndReq(&zclOTA_serverAddr, &req);
 
-          // Restart the timer for another hour
-          zclOTA_StartTimer(ZCL_OTA_UPGRADE_WAIT_EVT, 3600);
-        }
+        // Restart the timer for another hour
+        zclOTA_StartTimer(ZCL_OTA_UPGRADE_WAIT_EVT, 3600);
       }
     }
-    else
-    {
-      // Decrement the number of minutes to wait and reset the timer
-      zclOTA_UpdateDelay--;
-      osal_start_timerEx(zclOTA_TaskID, ZCL_OTA_UPGRADE_WAIT_EVT, 60000);
-    }
 
     return ( events ^ ZCL_OTA_UPGRADE_WAIT_EVT );
   }
@@ -977,11 +958,13 @@ ZStatus_t zclOTA_SendUpgradeEndReq( afAddrType_t *dstAddr,
  */
 static void zclOTA_StartTimer(uint16 eventId, uint32 seconds)
 {
-  // Record the number of whole minutes to wait
-  zclOTA_UpdateDelay = (seconds / 60);
+  // A long timer covers waits of up to OSAL_TIMERS_MAX_LONG_TIMEOUT msecs (49 days)
+  if (seconds > (OSAL_TIMERS_MAX_LONG_TIMEOUT / 1000))
+  {
+    seconds = OSAL_TIMERS_MAX_LONG_TIMEOUT / 1000;
+  }
 
-  // Set a timer for the remaining seconds to wait.
-  osal_start_timerEx(zclOTA_TaskID, eventId, (seconds % 60) * 1000);
+  osal_start_long_timer(zclOTA_TaskID, eventId, seconds * 1000);
 }
 
 /******************************************************************************
@@ -113,7 +113,7 @@
 
 #if !defined( MAX_NWK_FRAMECOUNTER_CHANGES )
   // The number of times the frame counter can change before
-  // saving to NV
+  // a new lease of frame counter values is saved to NV
   #define MAX_NWK_FRAMECOUNTER_CHANGES    1000
 #endif
 
@@ -137,6 +137,12 @@
 #define ZDAPP_UPDATE_NWK_NV_TIME 65000
 #endif
 
+// Delay time before saving changed bindings, so a burst of bind/unbind
+// requests is saved at once.
+#if !defined ZDAPP_UPDATE_BIND_NV_TIME
+#define ZDAPP_UPDATE_BIND_NV_TIME 700
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -155,7 +161,8 @@ zAddrType_t zdappMgmtNwkDiscRspAddr;
 uint8 zdappMgmtNwkDiscStartIndex;
 uint8 zdappMgmtSavedNwkState;
 
-uint16 nwkFrameCounterChanges = 0;
+// End of the frame counter values leased in the NV counter journal
+uint32 nwkFrameCounterLease = 0;
 uint8 continueJoining = TRUE;
 
 uint8  _tmpRejoinState;
@@ -190,6 +197,7 @@ void ZDApp_ProcessOSALMsg( osal_event_hdr_t *msgPtr );
 void ZDApp_ProcessNetworkJoin( void );
 void ZDApp_SetCoordAddress( uint8 endPoint, uint8 dstEP );
 uint8 ZDApp_RestoreNwkKey( void );
+void ZDApp_LeaseNwkFrameCounter( void );
 networkDesc_t* ZDApp_NwkDescListProcessing(void);
 
 void ZDApp_SecInit( uint8 state );
@@ -452,6 +460,18 @@ UINT16 ZDApp_event_loop( uint8 task_id, UINT16 events )
     return (events ^ ZDO_NWK_UPDATE_NV);
   }
 
+  if ( events & ZDO_BIND_UPDATE_NV )
+  {
+    // Save only the binding table entries that changed
+    if ( pBindWriteNV )
+    {
+      pBindWriteNV();
+    }
+
+    // Return unprocessed events
+    return (events ^ ZDO_BIND_UPDATE_NV);
+  }
+
   if ( events & ZDO_DEVICE_RESET )
   {
 #ifdef ZBA_FALLBACK_NWKKEY
@@ -536,9 +556,11 @@ UINT16 ZDApp_ProcessSecEvent( uint8 task_id, UINT16 events )
 
   if ( events & ZDO_FRAMECOUNTER_CHANGE )
   {
-    if ( nwkFrameCounterChanges++ > MAX_NWK_FRAMECOUNTER_CHANGES )
+    // Take the next lease while a block of frame counter values is still left
+    if ( (nwkFrameCounter >= nwkFrameCounterLease) ||
+         ((nwkFrameCounterLease - nwkFrameCounter) <= MAX_NWK_FRAMECOUNTER_CHANGES) )
     {
-      ZDApp_SaveNwkKey();
+      ZDApp_LeaseNwkFrameCounter();
     }
 
     // Return unprocessed events
@@ -926,7 +948,7 @@ uint8 ZDApp_RestoreNetworkState( void )
 
     if ( ZG_SECURE_ENABLED )
     {
-      nwkFrameCounterChanges = 0;
+      nwkFrameCounterLease = 0;
 
       if ( ZG_BUILD_COORDINATOR_TYPE && ZG_DEVICE_COORDINATOR_TYPE )
       {
@@ -1550,7 +1572,8 @@ void ZDApp_SaveNwkKey( void )
   osal_nv_write( ZCD_NV_NWKKEY, 0, sizeof( nwkActiveKeyItems ),
                 (void *)&keyItems );
 
-  nwkFrameCounterChanges = 0;
+  // Replaces the lease of a previous key as well
+  ZDApp_LeaseNwkFrameCounter();
 
   // Clear copy in RAM before return.
   osal_memset( &keyItems, 0x00, sizeof(keyItems) );
@@ -1573,6 +1596,12 @@ void ZDApp_ResetNwkKey( void )
   osal_memset( &keyItems, 0, sizeof( nwkActiveKeyItems ) );
   osal_nv_write( ZCD_NV_NWKKEY, 0, sizeof( nwkActiveKeyItems ),
                 (void *)&keyItems );
+
+  if ( osal_nv_lease_end( ZCD_NV_NWKKEY ) != 0 )
+  {
+    (void)osal_nv_lease( ZCD_NV_NWKKEY, 0 );
+  }
+  nwkFrameCounterLease = 0;
 }
 
 /*********************************************************************
@@ -1596,14 +1625,18 @@ uint8 ZDApp_RestoreNwkKey( void )
   {
     if ( keyItems.frameCounter > 0 )
     {
-      // Restore the key information
+      // Restore the key information, going on from the last lease if it is further
       keyItems.frameCounter += MAX_NWK_FRAMECOUNTER_CHANGES;
+      if ( osal_nv_lease_end( ZCD_NV_NWKKEY ) > keyItems.frameCounter )
+      {
+        keyItems.frameCounter = osal_nv_lease_end( ZCD_NV_NWKKEY );
+      }
       nwkFrameCounter = keyItems.frameCounter;
       ret = true;
     }
 
-    // Force a save for the first frame counter increment
-    nwkFrameCounterChanges = MAX_NWK_FRAMECOUNTER_CHANGES + 1;
+    // Force a lease for the first frame counter increment
+    nwkFrameCounterLease = 0;
   }
   // Clear copy in RAM before return.
   osal_memset( &keyItems, 0x00, sizeof(keyItems) );
@@ -1611,6 +1644,43 @@ uint8 ZDApp_RestoreNwkKey( void )
   return ( ret );
 }
 
+/*********************************************************************
+ * @fn      ZDApp_LeaseNwkFrameCounter()
+ *
+ * @brief   Lease the next frame counter values in the NV counter journal,
+ *          which appends a record instead of rewriting the key item. The
+ *          lease runs two blocks of MAX_NWK_FRAMECOUNTER_CHANGES ahead and
+ *          is renewed with one block left, so a restored frame counter is
+ *          past any value sent. If the lease fails, the frame counter is
+ *          written to the key item instead, and the lease is tried again a
+ *          block later.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void ZDApp_LeaseNwkFrameCounter( void )
+{
+  uint32 lease = nwkFrameCounter + (2 * (uint32)MAX_NWK_FRAMECOUNTER_CHANGES);
+
+  if ( osal_nv_lease( ZCD_NV_NWKKEY, lease ) != SUCCESS )
+  {
+    nwkActiveKeyItems keyItems;
+
+    // Keep the restore point up to date in the key item, as ZDSecMgrSaveApsLinkKey()
+    // does, so that a restore still goes one block past the frame counter
+    SSP_ReadNwkActiveKey( &keyItems );
+    keyItems.frameCounter = nwkFrameCounter;
+    osal_nv_write( ZCD_NV_NWKKEY, 0, sizeof( nwkActiveKeyItems ), (void *)&keyItems );
+
+    // Clear copy in RAM before return.
+    osal_memset( &keyItems, 0x00, sizeof(keyItems) );
+  }
+
+  // On a failure too, so that the next try is a block later, not on the next frame
+  nwkFrameCounterLease = lease;
+}
+
 /*********************************************************************
  * @fn      ZDApp_ResetTimerStart
  *
@@ -2925,6 +2995,27 @@ void ZDApp_NVUpdate( void )
 #endif
 }
 
+/*********************************************************************
+ * @fn          ZDApp_BindNVUpdate
+ *
+ * @brief       Set the Binding NV Update Timer. A running timer is not
+ *              restarted, so that a steady stream of requests is still
+ *              saved within ZDAPP_UPDATE_BIND_NV_TIME.
+ *
+ * @param       none
+ *
+ * @return      none
+ */
+void ZDApp_BindNVUpdate( void )
+{
+#if defined ( NV_RESTORE )
+  if ( !osal_get_timeoutEx( ZDAppTaskID, ZDO_BIND_UPDATE_NV ) )
+  {
+    osal_start_timerEx( ZDAppTaskID, ZDO_BIND_UPDATE_NV, ZDAPP_UPDATE_BIND_NV_TIME );
+  }
+#endif
+}
+
 /*********************************************************************
  * @fn      ZDApp_CoordStartPANIDConflictCB()
  *
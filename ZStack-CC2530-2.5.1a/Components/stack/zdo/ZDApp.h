@@ -82,6 +82,7 @@ extern "C"
 #define ZDO_FRAMECOUNTER_CHANGE   0x0400
 #define ZDO_TCLK_FRAMECOUNTER_CHANGE  0x0800
 #define ZDO_APS_FRAMECOUNTER_CHANGE   0x1000
+#define ZDO_BIND_UPDATE_NV        0x2000
 
 // Incoming to ZDO
 #define ZDO_NWK_DISC_CNF        0x01
@@ -597,6 +598,11 @@ extern void ZDApp_AnnounceNewAddress( void );
  */
 extern void ZDApp_NVUpdate( void );
 
+/*
+ * ZDApp_BindNVUpdate - Initiate a save of the changed bindings
+ */
+extern void ZDApp_BindNVUpdate( void );
+
 /*
  * Callback from network layer when coordinator start has a conflict with
  * an existing PAN ID.
@@ -1017,7 +1017,7 @@ void ZDO_ProcessBindUnbindReq( zdoIncomingMsg_t *inMsg, ZDO_BindUnbindReq_t *pRe
             bindStat = ZDP_SUCCESS;
 
             // Notify to save info into NV
-            ZDApp_NVUpdate();
+            ZDApp_BindNVUpdate();
 
             // Check for the destination address
             if ( pReq->dstAddress.addrMode == Addr64Bit )
@@ -1038,7 +1038,7 @@ void ZDO_ProcessBindUnbindReq( zdoIncomingMsg_t *inMsg, ZDO_BindUnbindReq_t *pRe
           bindStat = ZDP_SUCCESS;
 
           // Notify to save info into NV
-          ZDApp_NVUpdate();
+          ZDApp_BindNVUpdate();
         }
         else
           bindStat = ZDP_NO_ENTRY;
@@ -95,6 +95,12 @@ extern "C"
   #error "ZDSECMGR_TC_DEVICE_MAX shall be between 1 and 255 !"
 #endif
 
+// The NWK key and every APS and TC link key lease their frame counters from OSAL NV
+#if defined ( NV_RESTORE ) && \
+    ( ( 1 + ZDSECMGR_ENTRY_MAX + ZDSECMGR_TC_DEVICE_MAX ) > OSAL_NV_LEASE_CNT )
+  #error "OSAL_NV_LEASE_CNT shall count the NWK key and every APS and TC link key !"
+#endif
+
 #define ZDSECMGR_CTRL_NONE       0
 #define ZDSECMGR_CTRL_INIT       1
 #define ZDSECMGR_CTRL_TK_MASTER  2
@@ -322,8 +328,12 @@ void ZDSecMgrEntryFree( ZDSecMgrEntry_t* entry );
 ZStatus_t ZDSecMgrEntryNew( ZDSecMgrEntry_t** entry );
 ZStatus_t ZDSecMgrAuthenticationSet( uint8* extAddr, ZDSecMgr_Authentication_Option option );
 void ZDSecMgrApsLinkKeyInit(void);
+static uint8 ZDSecMgrLeaseFrmCntr( uint16 keyNvId, uint32 txFrmCntr, uint16 block );
+static void ZDSecMgrResetFrmCntr( uint16 keyNvId );
 #if defined ( NV_RESTORE )
+static uint32 ZDSecMgrRestoreFrmCntr( uint16 keyNvId, uint32 txFrmCntr, uint16 block );
 static void ZDSecMgrWriteNV(void);
+static uint8 ZDSecMgrWriteTableNV(void);
 static void ZDSecMgrRestoreFromNV(void);
 static void ZDSecMgrUpdateNV( uint16 index );
 #endif
@@ -3453,6 +3463,9 @@ ZStatus_t ZDSecMgrLinkKeySet( uint8* extAddr, uint8* key )
       osal_nv_write( entry->keyNvId, 0,
                     sizeof(APSME_LinkKeyData_t), pApsLinkKey );
 
+      // the new key starts its frame counter over, so drop any lease of the old one
+      ZDSecMgrResetFrmCntr( entry->keyNvId );
+
       // clear copy of key in RAM
       osal_memset(pApsLinkKey, 0x00, sizeof(APSME_LinkKeyData_t));
 
@@ -3750,8 +3763,36 @@ uint8 ZDSecMgrInitNV(void)
  * @return  none
  */
 static void ZDSecMgrWriteNV( void )
+{
+  // Stage the records and header so the table costs one NV item rewrite.
+  if ( osal_nv_begin() == SUCCESS )
+  {
+    uint8 stat = ZDSecMgrWriteTableNV();
+
+    // The commit also closes the transaction after a failed write, writing nothing.
+    if ( (osal_nv_commit() == SUCCESS) && (stat == SUCCESS) )
+    {
+      return;
+    }
+  }
+
+  // Could not stage the table, write it through a record at a time.
+  (void)ZDSecMgrWriteTableNV();
+}
+
+/*********************************************************************
+ * @fn      ZDSecMgrWriteTableNV()
+ *
+ * @brief   Write the APS link key list records and header to NV
+ *
+ * @param   none
+ *
+ * @return  SUCCESS, or NV_OPER_FAILED if a write failed
+ */
+static uint8 ZDSecMgrWriteTableNV( void )
 {
   uint16 i;
+  uint8 rtrn = SUCCESS;
   nvDeviceListHdr_t hdr;
 
   hdr.numRecs = 0;
@@ -3761,9 +3802,12 @@ static void ZDSecMgrWriteNV( void )
     for ( i = 0; i < ZDSECMGR_ENTRY_MAX; i++ )
     {
       // Save off the record
-      osal_nv_write( ZCD_NV_APS_LINK_KEY_TABLE,
-                    (uint16)((sizeof(nvDeviceListHdr_t)) + (i * sizeof(ZDSecMgrEntry_t))),
-                    sizeof(ZDSecMgrEntry_t), &ZDSecMgrEntries[i] );
+      if ( osal_nv_write( ZCD_NV_APS_LINK_KEY_TABLE,
+                          (uint16)((sizeof(nvDeviceListHdr_t)) + (i * sizeof(ZDSecMgrEntry_t))),
+                          sizeof(ZDSecMgrEntry_t), &ZDSecMgrEntries[i] ) != SUCCESS )
+      {
+        rtrn = NV_OPER_FAILED;
+      }
 
       if ( ZDSecMgrEntries[i].ami != INVALID_NODE_ADDR )
       {
@@ -3773,7 +3817,12 @@ static void ZDSecMgrWriteNV( void )
   }
 
   // Save off the header
-  osal_nv_write( ZCD_NV_APS_LINK_KEY_TABLE, 0, sizeof( nvDeviceListHdr_t ), &hdr );
+  if ( osal_nv_write( ZCD_NV_APS_LINK_KEY_TABLE, 0, sizeof( nvDeviceListHdr_t ), &hdr ) != SUCCESS )
+  {
+    rtrn = NV_OPER_FAILED;
+  }
+
+  return rtrn;
 }
 #endif // NV_RESTORE
 
@@ -3817,7 +3866,9 @@ static void ZDSecMgrRestoreFromNV( void )
                          sizeof(APSME_LinkKeyData_t), pApsLinkKey );
 
             // set new values for the counter
-            pApsLinkKey->txFrmCntr += ( MAX_APS_FRAMECOUNTER_CHANGES + 1 );
+            pApsLinkKey->txFrmCntr = ZDSecMgrRestoreFrmCntr( ZDSecMgrEntries[x].keyNvId,
+                                                             pApsLinkKey->txFrmCntr,
+                                                             MAX_APS_FRAMECOUNTER_CHANGES );
 
             // restore values for counters in RAM
             ApsLinkKeyFrmCntr[ZDSecMgrEntries[x].keyNvId - ZCD_NV_APS_LINK_KEY_DATA_START].txFrmCntr =
@@ -3826,8 +3877,12 @@ static void ZDSecMgrRestoreFromNV( void )
             ApsLinkKeyFrmCntr[ZDSecMgrEntries[x].keyNvId - ZCD_NV_APS_LINK_KEY_DATA_START].rxFrmCntr =
                                             pApsLinkKey->rxFrmCntr;
 
-            osal_nv_write( ZDSecMgrEntries[x].keyNvId, 0,
-                          sizeof(APSME_LinkKeyData_t), pApsLinkKey );
+            if ( !ZDSecMgrLeaseFrmCntr( ZDSecMgrEntries[x].keyNvId, pApsLinkKey->txFrmCntr,
+                                        MAX_APS_FRAMECOUNTER_CHANGES ) )
+            {
+              osal_nv_write( ZDSecMgrEntries[x].keyNvId, 0,
+                            sizeof(APSME_LinkKeyData_t), pApsLinkKey );
+            }
 
             // clear copy of key in RAM
             osal_memset(pApsLinkKey, 0x00, sizeof(APSME_LinkKeyData_t));
@@ -3985,6 +4040,7 @@ void APSME_TCLinkKeyInit(uint8 setDefault)
   uint8             i;
   APSME_TCLinkKey_t tcLinkKey;
   uint8             rtrn;
+  uint8             write;
 
   // Initialize all NV items for preconfigured TCLK
   for( i = 0; i < ZDSECMGR_TC_DEVICE_MAX; i++ )
@@ -4013,23 +4069,33 @@ void APSME_TCLinkKeyInit(uint8 setDefault)
 #if defined ( NV_RESTORE )
       if (setDefault == TRUE)
       {
-        // clear the value stored in NV
+        // clear the value stored in NV and its lease
         tcLinkKey.txFrmCntr = 0;
+        ZDSecMgrResetFrmCntr( ZCD_NV_TCLK_TABLE_START + i );
+        write = TRUE;
       }
       else
       {
-        // increase the value stored in NV
-        tcLinkKey.txFrmCntr += ( MAX_TCLK_FRAMECOUNTER_CHANGES + 1 );
+        // go on past the value stored in NV or leased, and lease from there
+        tcLinkKey.txFrmCntr = ZDSecMgrRestoreFrmCntr( ( ZCD_NV_TCLK_TABLE_START + i),
+                                                      tcLinkKey.txFrmCntr,
+                                                      MAX_TCLK_FRAMECOUNTER_CHANGES );
+        write = !ZDSecMgrLeaseFrmCntr( ( ZCD_NV_TCLK_TABLE_START + i), tcLinkKey.txFrmCntr,
+                                       MAX_TCLK_FRAMECOUNTER_CHANGES );
       }
 #else
       // Clear the counters if NV_RESTORE is not enabled and this NV item
       // already existed in the NV memory
       tcLinkKey.txFrmCntr = 0;
       tcLinkKey.rxFrmCntr = 0;
+      write = TRUE;
 #endif  // NV_RESTORE
 
-      osal_nv_write( ( ZCD_NV_TCLK_TABLE_START + i), 0,
-                      sizeof(APSME_TCLinkKey_t), &tcLinkKey );
+      if ( write )
+      {
+        osal_nv_write( ( ZCD_NV_TCLK_TABLE_START + i), 0,
+                        sizeof(APSME_TCLinkKey_t), &tcLinkKey );
+      }
 
       // set initial values for counters in RAM
       TCLinkKeyFrmCntr[i].txFrmCntr = tcLinkKey.txFrmCntr;
@@ -4446,11 +4512,78 @@ void ZDSecMgrInitNVKeyTables(uint8 setDefault)
   APSME_TCLinkKeyInit(setDefault);
 }
 
+/******************************************************************************
+ * @fn          ZDSecMgrLeaseFrmCntr
+ *
+ * @brief       Lease the next outgoing frame counter values of a link key in
+ *              the NV counter journal, under the NV Id of the key, instead of
+ *              rewriting the key item. As ZDApp_LeaseNwkFrameCounter() does,
+ *              the lease runs two blocks ahead and is renewed every block, so
+ *              a restored frame counter is past any value sent.
+ *
+ * @param       keyNvId   - [in] NV Id of the key, also the counter Id
+ * @param       txFrmCntr - [in] outgoing frame counter
+ * @param       block     - [in] frame counter changes between renewals
+ *
+ * @return      TRUE if leased, FALSE if the key item has to keep the counter
+ */
+static uint8 ZDSecMgrLeaseFrmCntr( uint16 keyNvId, uint32 txFrmCntr, uint16 block )
+{
+  return ( osal_nv_lease( keyNvId, txFrmCntr + (2 * (uint32)block) ) == SUCCESS );
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrResetFrmCntr
+ *
+ * @brief       Drop the frame counter lease of a link key whose counter starts
+ *              over. If that fails, the old lease only makes a restored
+ *              counter jump ahead.
+ *
+ * @param       keyNvId - [in] NV Id of the key
+ *
+ * @return      none
+ */
+static void ZDSecMgrResetFrmCntr( uint16 keyNvId )
+{
+  if ( osal_nv_lease_end( keyNvId ) != 0 )
+  {
+    (void)osal_nv_lease( keyNvId, 0 );
+  }
+}
+
+#if defined ( NV_RESTORE )
+/******************************************************************************
+ * @fn          ZDSecMgrRestoreFrmCntr
+ *
+ * @brief       The outgoing frame counter of a link key after a reset: past
+ *              the value saved in the key item and the last lease.
+ *
+ * @param       keyNvId   - [in] NV Id of the key
+ * @param       txFrmCntr - [in] frame counter saved in the key item
+ * @param       block     - [in] frame counter changes between saves
+ *
+ * @return      restored frame counter
+ */
+static uint32 ZDSecMgrRestoreFrmCntr( uint16 keyNvId, uint32 txFrmCntr, uint16 block )
+{
+  txFrmCntr += ( (uint32)block + 1 );
+
+  if ( osal_nv_lease_end( keyNvId ) > txFrmCntr )
+  {
+    txFrmCntr = osal_nv_lease_end( keyNvId );
+  }
+
+  return txFrmCntr;
+}
+#endif // NV_RESTORE
+
 /******************************************************************************
  * @fn          ZDSecMgrSaveApsLinkKey
  *
- * @brief       Save APS Link Key to NV. It will loop through all the keys
- *              to see which one to save.
+ * @brief       Save APS Link Key frame counters to NV. It will loop through
+ *              all the keys to see which one to save. The outgoing frame
+ *              counter is leased; the key item is only rewritten once the
+ *              incoming one has moved a block on, or if the lease failed.
  *
  * @param       none
  *
@@ -4474,12 +4607,19 @@ void ZDSecMgrSaveApsLinkKey(void)
         if (osal_nv_read(ZCD_NV_APS_LINK_KEY_DATA_START + i, 0,
                          sizeof(APSME_LinkKeyData_t), pKeyData) == SUCCESS)
         {
-          pKeyData->txFrmCntr = ApsLinkKeyFrmCntr[i].txFrmCntr;
-          pKeyData->rxFrmCntr = ApsLinkKeyFrmCntr[i].rxFrmCntr;
+          if ( !ZDSecMgrLeaseFrmCntr( ZCD_NV_APS_LINK_KEY_DATA_START + i,
+                                      ApsLinkKeyFrmCntr[i].txFrmCntr,
+                                      MAX_APS_FRAMECOUNTER_CHANGES ) ||
+               ( (ApsLinkKeyFrmCntr[i].rxFrmCntr - pKeyData->rxFrmCntr) >=
+                 MAX_APS_FRAMECOUNTER_CHANGES ) )
+          {
+            pKeyData->txFrmCntr = ApsLinkKeyFrmCntr[i].txFrmCntr;
+            pKeyData->rxFrmCntr = ApsLinkKeyFrmCntr[i].rxFrmCntr;
 
-          // Write the APS link key back to the NV
-          osal_nv_write(ZCD_NV_APS_LINK_KEY_DATA_START + i, 0,
-                        sizeof(APSME_LinkKeyData_t), pKeyData);
+            // Write the APS link key back to the NV
+            osal_nv_write(ZCD_NV_APS_LINK_KEY_DATA_START + i, 0,
+                          sizeof(APSME_LinkKeyData_t), pKeyData);
+          }
 
           // clear the pending write flag
           ApsLinkKeyFrmCntr[i].pendingFlag = FALSE;
@@ -4497,8 +4637,9 @@ void ZDSecMgrSaveApsLinkKey(void)
 /******************************************************************************
  * @fn          ZDSecMgrSaveTCLinkKey
  *
- * @brief       Save TC Link Key to NV. It will loop through all the keys
- *              to see which one to save.
+ * @brief       Save TC Link Key frame counters to NV. It will loop through
+ *              all the keys to see which one to save, as
+ *              ZDSecMgrSaveApsLinkKey() does.
  *
  * @param       none
  *
@@ -4520,12 +4661,19 @@ void ZDSecMgrSaveTCLinkKey(void)
         if (osal_nv_read(ZCD_NV_TCLK_TABLE_START + i, 0,
                          sizeof(APSME_TCLinkKey_t), pKeyData) == SUCCESS)
         {
-          pKeyData->txFrmCntr = TCLinkKeyFrmCntr[i].txFrmCntr;
-          pKeyData->rxFrmCntr = TCLinkKeyFrmCntr[i].rxFrmCntr;
+          if ( !ZDSecMgrLeaseFrmCntr( ZCD_NV_TCLK_TABLE_START + i,
+                                      TCLinkKeyFrmCntr[i].txFrmCntr,
+                                      MAX_TCLK_FRAMECOUNTER_CHANGES ) ||
+               ( (TCLinkKeyFrmCntr[i].rxFrmCntr - pKeyData->rxFrmCntr) >=
+                 MAX_TCLK_FRAMECOUNTER_CHANGES ) )
+          {
+            pKeyData->txFrmCntr = TCLinkKeyFrmCntr[i].txFrmCntr;
+            pKeyData->rxFrmCntr = TCLinkKeyFrmCntr[i].rxFrmCntr;
 
-          // Write the TC link key back to the NV
-          osal_nv_write(ZCD_NV_TCLK_TABLE_START + i, 0,
-                        sizeof(APSME_TCLinkKey_t), pKeyData);
+            // Write the TC link key back to the NV
+            osal_nv_write(ZCD_NV_TCLK_TABLE_START + i, 0,
+                          sizeof(APSME_TCLinkKey_t), pKeyData);
+          }
 
           // clear the pending write flag
           TCLinkKeyFrmCntr[i].pendingFlag = FALSE;
@@ -475,6 +475,15 @@ typedef enum
   LQI_ADJ_GET = 0xFF
 } ZMacLqiAdjust_t;  // Mode settings for lqi adjustment
 
+#if defined ZMAC_CHANNEL_MODEL
+/* A channel model that takes MAC data requests in place of the MAC, as a simulator
+ * of many nodes does. It owns pReq, and gives the data confirm, and a data
+ * indication at each node that receives the frame, through MAC_CbackEvent()
+ * as the MAC would.
+ */
+typedef void (*zmacChannelReq_t)( macMcpsDataReq_t *pReq );
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -637,6 +646,13 @@ typedef enum
    */
   extern uint8 (*pZMac_AppCallback)( uint8 *msgPtr );
 
+#if defined ZMAC_CHANNEL_MODEL
+  /*
+   * The channel model that MAC data requests go to, or NULL for the MAC.
+   */
+  extern zmacChannelReq_t pZMac_ChannelReq;
+#endif
+
   /*
    * This function returns true if the MAC state is idle.
    */
@@ -91,6 +91,11 @@ extern void MAC_SetRandomSeedCB(macRNGFcn_t pCBFcn);
 /* Pointer to scan result buffer */
 void *ZMac_ScanBuf = NULL;
 
+#if defined ZMAC_CHANNEL_MODEL
+/* Channel model that takes the data requests in place of the MAC, if set */
+zmacChannelReq_t pZMac_ChannelReq = NULL;
+#endif
+
 /********************************************************************************************************
  * LOCAL FUNCTION PROTOTYPES
  ********************************************************************************************************/
@@ -478,8 +483,17 @@ uint8 ZMacDataReqSec( ZMacDataReq_t *pData, applySecCB_t secCB )
       }
     }
 
-    /* Call Mac Data Request */
-    MAC_McpsDataReq( pBuf );
+    /* Call Mac Data Request, or hand the frame to the channel model */
+#if defined ZMAC_CHANNEL_MODEL
+    if ( pZMac_ChannelReq != NULL )
+    {
+      pZMac_ChannelReq( pBuf );
+    }
+    else
+#endif
+    {
+      MAC_McpsDataReq( pBuf );
+    }
 
     return ( ZMacSuccess );
   }
@@ -0,0 +1,197 @@
+/**************************************************************************************************
+  Filename:       bench.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Timing and checks shared by the host microbenchmarks.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Divides the iteration counts for a quick run
+static uint32 benchDiv = 1;
+
+// State of benchRand()
+static uint32 benchSeed = 1;
+
+/*********************************************************************
+ * @fn      benchInit
+ *
+ * @brief   Parses the benchmark command line.
+ *
+ * @param   argc, argv - from main()
+ *
+ * @return  none
+ */
+void benchInit( int argc, char **argv )
+{
+  int i;
+
+  for ( i = 1; i < argc; i++ )
+  {
+    if ( strcmp( argv[i], "-q" ) == 0 )
+    {
+      benchDiv = 100;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      benchIters
+ *
+ * @brief   Scales an iteration count down for a quick run.
+ *
+ * @param   cnt - iterations of a full run
+ *
+ * @return  iterations to run, at least one
+ */
+uint32 benchIters( uint32 cnt )
+{
+  cnt /= benchDiv;
+
+  return ( cnt ? cnt : 1 );
+}
+
+/*********************************************************************
+ * @fn      benchNow
+ *
+ * @brief   Reads the host monotonic clock.
+ *
+ * @param   none
+ *
+ * @return  nanoseconds
+ */
+unsigned long long benchNow( void )
+{
+  struct timespec now;
+
+  clock_gettime( CLOCK_MONOTONIC, &now );
+
+  return ( (unsigned long long)now.tv_sec * 1000000000 + now.tv_nsec );
+}
+
+/*********************************************************************
+ * @fn      benchReport
+ *
+ * @brief   Prints the cost per operation of a measurement.
+ *
+ * @param   name - what was measured
+ * @param   cnt - operations timed
+ * @param   ns - nanoseconds they took
+ *
+ * @return  none
+ */
+void benchReport( const char *name, uint32 cnt, unsigned long long ns )
+{
+  printf( "%-40s %10.1f ns/op  (%lu ops)\n", name, (double)ns / (cnt ? cnt : 1),
+          (unsigned long)cnt );
+}
+
+/*********************************************************************
+ * @fn      benchValue
+ *
+ * @brief   Prints a counter that is not a time.
+ *
+ * @param   name - what was counted
+ * @param   value - the count
+ * @param   unit - its unit
+ *
+ * @return  none
+ */
+void benchValue( const char *name, double value, const char *unit )
+{
+  printf( "%-40s %10.1f %s\n", name, value, unit );
+}
+
+/*********************************************************************
+ * @fn      benchRandSeed
+ *
+ * @brief   Restarts the benchRand() sequence.
+ *
+ * @param   seed - start of the sequence, 1 before the first call
+ *
+ * @return  none
+ */
+void benchRandSeed( uint32 seed )
+{
+  benchSeed = seed;
+}
+
+/*********************************************************************
+ * @fn      benchRand
+ *
+ * @brief   A random number generator of the benchmarks' own, so that every
+ *          build and host runs the same mix, whatever osal_rand() does.
+ *
+ * @param   none
+ *
+ * @return  the next number of the sequence
+ */
+uint16 benchRand( void )
+{
+  benchSeed = benchSeed * 1103515245 + 12345;
+
+  return ( (uint16)(benchSeed >> 16) );
+}
+
+/*********************************************************************
+ * @fn      benchFail
+ *
+ * @brief   Reports a failed check and ends the run.
+ *
+ * @param   file, line - where the check is
+ * @param   expr - the check
+ *
+ * @return  none
+ */
+void benchFail( const char *file, int line, const char *expr )
+{
+  fprintf( stderr, "%s:%d: check failed: %s\n", file, line, expr );
+  exit( 1 );
+}
+
+/*********************************************************************
+*********************************************************************/
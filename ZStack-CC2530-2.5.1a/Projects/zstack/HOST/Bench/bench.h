@@ -0,0 +1,118 @@
+/**************************************************************************************************
+  Filename:       bench.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Timing and checks shared by the host microbenchmarks.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ *  Support for the host microbenchmarks: each one times a hot path of the stack with the host
+ *  clock, checks that the path still did its job, and prints a line per measurement. With -q
+ *  the iteration counts shrink so that ctest runs every benchmark as a quick self-check.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "hal_defs.h"
+#include "hal_types.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Fails the benchmark, with the line, when a check does not hold.
+#define BENCH_CHECK( x )  st( if ( !(x) ) { benchFail( __FILE__, __LINE__, #x ); } )
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Parses the benchmark command line: -q for a quick run.
+ */
+extern void benchInit( int argc, char **argv );
+
+/*
+ * Scales an iteration count down for a quick run.
+ */
+extern uint32 benchIters( uint32 cnt );
+
+/*
+ * Nanoseconds on CLOCK_MONOTONIC, independent of the simulated clock.
+ */
+extern unsigned long long benchNow( void );
+
+/*
+ * Prints the cost per operation of 'cnt' operations that took 'ns' nanoseconds.
+ */
+extern void benchReport( const char *name, uint32 cnt, unsigned long long ns );
+
+/*
+ * Prints a counter, such as a wear or throughput figure, that is not a time.
+ */
+extern void benchValue( const char *name, double value, const char *unit );
+
+/*
+ * Restarts the benchRand() sequence from a seed, 1 at the start of a run.
+ */
+extern void benchRandSeed( uint32 seed );
+
+/*
+ * Repeatable pseudo-random numbers, the same on every build and host.
+ */
+extern uint16 benchRand( void );
+
+/*
+ * Reports a failed BENCH_CHECK() and ends the run.
+ */
+extern void benchFail( const char *file, int line, const char *expr );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
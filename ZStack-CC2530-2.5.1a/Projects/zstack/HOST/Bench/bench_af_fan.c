@@ -0,0 +1,272 @@
+/**************************************************************************************************
+  Filename:       bench_af_fan.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Times sending one ASDU to a list of destinations.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Times sending one ASDU to a list of destinations with AF_DataRequestList(), which sets the
+ *  request up once, against an AF_DataRequest() per destination. With the APS stub changing
+ *  every request it is handed, checks that each destination is still sent the request the
+ *  caller asked for.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "AF.h"
+
+#include "aps_host.h"
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_EP               10
+#define BENCH_PROFILE          0x0104
+#define BENCH_CLUSTER          0x0006
+#define BENCH_RADIUS           5
+#define BENCH_ASDU_LEN         24
+#define BENCH_DST_MAX          32
+
+#define BENCH_DST_FAIL         5       // Destination the APS stub fails
+#define BENCH_DST_BCAST        7       // Destination that is a broadcast
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { benchTask };
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 benchTaskID = 0;
+static endPointDesc_t benchEP;
+static SimpleDescriptionFormat_t benchSimpleDesc;
+static uint8 benchAsdu[BENCH_ASDU_LEN];
+static afAddrType_t benchDst[BENCH_DST_MAX];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark task.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTask
+ *
+ * @brief   Unused: nothing is sent to the benchmark task.
+ */
+static uint16 benchTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  (void)events;
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchCheck
+ *
+ * @brief   Sends to the destinations with AF_DataRequestList(), the APS stub overwriting
+ *          each request, and checks what every destination was sent.
+ */
+static void benchCheck( void )
+{
+  afStatus_t stat[BENCH_DST_MAX];
+  uint16 hash = 0;
+  uint8 transID = 100;
+  uint8 expectID = transID;
+  uint8 idx;
+
+  for ( idx = 0; idx < BENCH_ASDU_LEN; idx++ )
+  {
+    hash = (hash * 31) + benchAsdu[idx];
+  }
+
+  apsHostReset();
+  apsHostClobber = TRUE;
+  apsHostFailAddr = benchDst[BENCH_DST_FAIL].addr.shortAddr;
+
+  BENCH_CHECK( AF_DataRequestList( benchDst, BENCH_DST_MAX, &benchEP, BENCH_CLUSTER,
+                                   BENCH_ASDU_LEN, benchAsdu, &transID,
+                                   AF_ACK_REQUEST | AF_EN_SECURITY, BENCH_RADIUS,
+                                   stat ) == (afStatus_t)ZApsNoAck );
+  BENCH_CHECK( apsHostReqCnt == BENCH_DST_MAX );
+  BENCH_CHECK( apsHostMtuCnt == 1 );
+
+  for ( idx = 0; idx < BENCH_DST_MAX; idx++ )
+  {
+    apsHostReq_t *pLog = apsHostReqLog + idx;
+    uint16 txOptions = APS_TX_OPTIONS_SECURITY_ENABLE;
+
+    if ( idx != BENCH_DST_BCAST )
+    {
+      txOptions |= APS_TX_OPTIONS_ACK;
+    }
+
+    BENCH_CHECK( pLog->dstAddr == benchDst[idx].addr.shortAddr );
+    BENCH_CHECK( pLog->dstEP == benchDst[idx].endPoint );
+    BENCH_CHECK( pLog->transID == expectID );
+    BENCH_CHECK( pLog->clusterID == BENCH_CLUSTER );
+    BENCH_CHECK( pLog->txOptions == txOptions );
+    BENCH_CHECK( pLog->radius == BENCH_RADIUS );
+    BENCH_CHECK( pLog->asduLen == BENCH_ASDU_LEN );
+    BENCH_CHECK( pLog->asduHash == hash );
+
+    if ( idx == BENCH_DST_FAIL )
+    {
+      BENCH_CHECK( stat[idx] == (afStatus_t)ZApsNoAck );
+    }
+    else
+    {
+      BENCH_CHECK( stat[idx] == afStatus_SUCCESS );
+      expectID++;
+    }
+  }
+  BENCH_CHECK( transID == expectID );
+
+  apsHostReset();
+  printf( "%-40s %10s\n", "fan-out requests after APS changes", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchFan
+ *
+ * @brief   Times sending to cnt destinations both ways, per destination.
+ */
+static void benchFan( uint8 cnt )
+{
+  uint32 iters = benchIters( 2000000 ) / cnt;
+  unsigned long long t0;
+  char name[48];
+  uint8 transID = 0;
+  uint32 i;
+  uint8 idx;
+
+  t0 = benchNow();
+  for ( i = 0; i < iters; i++ )
+  {
+    for ( idx = 0; idx < cnt; idx++ )
+    {
+      AF_DataRequest( benchDst + idx, &benchEP, BENCH_CLUSTER, BENCH_ASDU_LEN, benchAsdu,
+                      &transID, AF_ACK_REQUEST, BENCH_RADIUS );
+    }
+  }
+  sprintf( name, "AF_DataRequest x %u, per dst", cnt );
+  benchReport( name, iters * cnt, benchNow() - t0 );
+
+  t0 = benchNow();
+  for ( i = 0; i < iters; i++ )
+  {
+    AF_DataRequestList( benchDst, cnt, &benchEP, BENCH_CLUSTER, BENCH_ASDU_LEN, benchAsdu,
+                        &transID, AF_ACK_REQUEST, BENCH_RADIUS, NULL );
+  }
+  sprintf( name, "AF_DataRequestList of %u, per dst", cnt );
+  benchReport( name, iters * cnt, benchNow() - t0 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Registers the endpoint, sets up the destinations and runs the check and timings.
+ */
+int main( int argc, char **argv )
+{
+  uint8 idx;
+
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  benchSimpleDesc.AppProfId = BENCH_PROFILE;
+  benchEP.endPoint = BENCH_EP;
+  benchEP.task_id = &benchTaskID;
+  benchEP.simpleDesc = &benchSimpleDesc;
+  benchEP.latencyReq = noLatencyReqs;
+  BENCH_CHECK( afRegister( &benchEP ) == afStatus_SUCCESS );
+
+  for ( idx = 0; idx < BENCH_ASDU_LEN; idx++ )
+  {
+    benchAsdu[idx] = 0xA0 + idx;
+  }
+
+  for ( idx = 0; idx < BENCH_DST_MAX; idx++ )
+  {
+    benchDst[idx].addrMode = afAddr16Bit;
+    benchDst[idx].addr.shortAddr = 0x1000 + idx;
+    benchDst[idx].endPoint = 1 + (idx % 4);
+  }
+  benchDst[BENCH_DST_BCAST].addrMode = afAddrBroadcast;
+  benchDst[BENCH_DST_BCAST].addr.shortAddr = NWK_BROADCAST_SHORTADDR_DEVALL;
+
+  benchCheck();
+  benchFan( 1 );
+  benchFan( 8 );
+  benchFan( BENCH_DST_MAX );
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,320 @@
+/**************************************************************************************************
+  Filename:       bench_af_groups.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks and times group delivery while the group table changes.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Checks that group frames reach the endpoints the group table names, in group table order,
+ *  while the table is changed at random through afAddGroup(), afRemoveGroup() and
+ *  afRemoveAllGroup(), and by appends through aps_AddGroup() that the AF is not told of.
+ *  Then times group frames against a full group table.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "AF.h"
+#include "aps_groups.h"
+
+#include "aps_host.h"
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_EP_CNT           8
+#define BENCH_EP_FIRST         10
+#define BENCH_GROUP_CNT        4       // Group IDs 1 to 4
+#define BENCH_PROFILE          0x0104
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { benchTask };
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 benchTaskID = 0;
+static endPointDesc_t benchEP[BENCH_EP_CNT];
+static SimpleDescriptionFormat_t benchSimpleDesc;
+static uint8 benchAsdu[4];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark task.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTask
+ *
+ * @brief   Unused: the benchmark receives the messages itself.
+ */
+static uint16 benchTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  (void)events;
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchDeliver
+ *
+ * @brief   Passes a group frame to afIncomingData() and takes the messages it delivered.
+ *
+ * @param   groupID - group of the frame
+ * @param   pEP - where to put the endpoints delivered to, in order, or NULL
+ *
+ * @return  number of messages delivered
+ */
+static uint8 benchDeliver( uint16 groupID, uint8 *pEP )
+{
+  aps_FrameFormat_t aff;
+  zAddrType_t srcAddr;
+  NLDE_Signal_t sig;
+  afIncomingMSGPacket_t *pMsg;
+  uint8 cnt = 0;
+
+  osal_memset( &aff, 0, sizeof( aff ) );
+  aff.FrmCtrl = APS_FC_DM_GROUP;
+  aff.GroupID = groupID;
+  aff.ProfileID = BENCH_PROFILE;
+  aff.ClusterID = 0x0006;
+  aff.asdu = benchAsdu;
+  aff.asduLength = sizeof( benchAsdu );
+
+  osal_memset( &srcAddr, 0, sizeof( srcAddr ) );
+  srcAddr.addrMode = Addr16Bit;
+  srcAddr.addr.shortAddr = 0x1234;
+  osal_memset( &sig, 0, sizeof( sig ) );
+
+  afIncomingData( &aff, &srcAddr, 0, &sig, 0, FALSE, 0 );
+
+  while ( (pMsg = (afIncomingMSGPacket_t *)osal_msg_receive( benchTaskID )) != NULL )
+  {
+    if ( pEP != NULL )
+    {
+      pEP[cnt] = pMsg->endPoint;
+    }
+    cnt++;
+    osal_msg_deallocate( (uint8 *)pMsg );
+  }
+
+  return ( cnt );
+}
+
+/*********************************************************************
+ * @fn      benchCheckGroups
+ *
+ * @brief   Checks each group frame reaches the endpoints of the group table walk.
+ */
+static void benchCheckGroups( void )
+{
+  apsGroupItem_t *pItem;
+  uint8 expect[APS_MAX_GROUPS];
+  uint8 got[APS_MAX_GROUPS];
+  uint8 cnt;
+  uint16 id;
+
+  for ( id = 1; id <= BENCH_GROUP_CNT; id++ )
+  {
+    cnt = 0;
+    for ( pItem = apsGroupTable; pItem != NULL; pItem = pItem->next )
+    {
+      if ( pItem->group.ID == id )
+      {
+        expect[cnt++] = pItem->endpoint;
+      }
+    }
+
+    BENCH_CHECK( benchDeliver( id, got ) == cnt );
+    BENCH_CHECK( osal_memcmp( got, expect, cnt ) );
+  }
+}
+
+/*********************************************************************
+ * @fn      benchChurn
+ *
+ * @brief   Changes the group table at random, checking delivery after each change.
+ */
+static void benchChurn( void )
+{
+  uint32 cnt = benchIters( 2000000 );
+  aps_Group_t group;
+  afGroupStat_t stat;
+  uint16 rnd;
+  uint32 i;
+
+  osal_memset( &group, 0, sizeof( group ) );
+  for ( i = 0; i < cnt; i++ )
+  {
+    rnd = osal_rand();
+    group.ID = 1 + (rnd % BENCH_GROUP_CNT);
+    rnd /= BENCH_GROUP_CNT;
+
+    switch ( rnd % 8 )
+    {
+      case 0:
+        afRemoveAllGroup( BENCH_EP_FIRST + ((rnd / 8) % BENCH_EP_CNT) );
+        break;
+
+      case 1:
+      case 2:
+      case 3:
+        afRemoveGroup( BENCH_EP_FIRST + ((rnd / 8) % BENCH_EP_CNT), group.ID );
+        break;
+
+      case 4:
+        // Not told to the AF: found by the tail check
+        aps_AddGroup( BENCH_EP_FIRST + ((rnd / 8) % BENCH_EP_CNT), &group );
+        break;
+
+      default:
+        afAddGroup( BENCH_EP_FIRST + ((rnd / 8) % BENCH_EP_CNT), &group );
+        break;
+    }
+
+    benchCheckGroups();
+  }
+
+  afGroupStat( &stat );
+  printf( "%-40s %10s  (%lu changes, %u rebuilds)\n", "group table changes", "ok",
+          (unsigned long)cnt, stat.rebuilds );
+}
+
+/*********************************************************************
+ * @fn      benchFull
+ *
+ * @brief   Times group frames against a full group table: a group of three endpoints
+ *          and a group no endpoint is in.
+ */
+static void benchFull( void )
+{
+  uint32 cnt = benchIters( 1000000 );
+  aps_Group_t group;
+  unsigned long long t0;
+  uint32 i;
+  uint8 x;
+
+  for ( x = 0; x < BENCH_EP_CNT; x++ )
+  {
+    afRemoveAllGroup( BENCH_EP_FIRST + x );
+  }
+
+  osal_memset( &group, 0, sizeof( group ) );
+  for ( x = 0; x < APS_MAX_GROUPS; x++ )
+  {
+    group.ID = (x < 3) ? 1 : 0x100 + x;
+    BENCH_CHECK( afAddGroup( BENCH_EP_FIRST + (x % BENCH_EP_CNT), &group ) == ZSuccess );
+  }
+  benchCheckGroups();
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    benchDeliver( 1, NULL );
+  }
+  benchReport( "group frame, 3 of 10 entries", cnt, benchNow() - t0 );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    benchDeliver( 2, NULL );
+  }
+  benchReport( "group frame, no member", cnt, benchNow() - t0 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Registers the endpoints and runs the checks and timings.
+ */
+int main( int argc, char **argv )
+{
+  uint8 i;
+
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  benchSimpleDesc.AppProfId = BENCH_PROFILE;
+  for ( i = 0; i < BENCH_EP_CNT; i++ )
+  {
+    benchEP[i].endPoint = BENCH_EP_FIRST + i;
+    benchEP[i].task_id = &benchTaskID;
+    benchEP[i].simpleDesc = &benchSimpleDesc;
+    benchEP[i].latencyReq = noLatencyReqs;
+    BENCH_CHECK( afRegister( benchEP + i ) == afStatus_SUCCESS );
+  }
+
+  benchChurn();
+  benchFull();
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,264 @@
+/**************************************************************************************************
+  Filename:       bench_af_rx.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Times the delivery of incoming frames by the AF to endpoints.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Times the delivery of incoming frames by afIncomingData() to the endpoint tasks: unicast,
+ *  group frames for one and for several endpoints, and broadcast to every endpoint. Checks
+ *  that a frame for a single endpoint is copied into its message, and that the endpoints of
+ *  a group or broadcast delivery share one reference-counted copy of the ASDU.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "AF.h"
+#include "aps_groups.h"
+
+#include "aps_host.h"
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_EP_CNT           8
+#define BENCH_EP_FIRST         10
+#define BENCH_PROFILE          0x0104
+#define BENCH_ASDU_LEN         40
+
+#define BENCH_GROUP_ONE        0x0001      // Group of the first endpoint only
+#define BENCH_GROUP_HALF       0x0002      // Group of every other endpoint
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { benchTask };
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 benchTaskID = 0;
+static endPointDesc_t benchEP[BENCH_EP_CNT];
+static SimpleDescriptionFormat_t benchSimpleDesc;
+static uint8 benchAsdu[BENCH_ASDU_LEN];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark task.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTask
+ *
+ * @brief   Unused: the benchmark receives the messages itself.
+ */
+static uint16 benchTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  (void)events;
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchDeliver
+ *
+ * @brief   Passes a frame to afIncomingData() and takes the messages it delivered.
+ *
+ * @param   dstEP - destination endpoint, AF_BROADCAST_ENDPOINT or 0 for a group
+ * @param   groupID - group of a group frame
+ * @param   check - TRUE to check how the ASDU was delivered
+ *
+ * @return  number of messages delivered
+ */
+static uint8 benchDeliver( uint8 dstEP, uint16 groupID, uint8 check )
+{
+  aps_FrameFormat_t aff;
+  zAddrType_t srcAddr;
+  NLDE_Signal_t sig;
+  afIncomingMSGPacket_t *pMsg;
+  uint8 *pData = NULL;
+  uint8 own = FALSE;
+  uint8 cnt = 0;
+
+  osal_memset( &aff, 0, sizeof( aff ) );
+  aff.FrmCtrl = (dstEP == 0) ? APS_FC_DM_GROUP : APS_FC_DM_UNICAST;
+  aff.DstEndPoint = dstEP;
+  aff.GroupID = groupID;
+  aff.ProfileID = BENCH_PROFILE;
+  aff.ClusterID = 0x0006;
+  aff.asdu = benchAsdu;
+  aff.asduLength = BENCH_ASDU_LEN;
+
+  osal_memset( &srcAddr, 0, sizeof( srcAddr ) );
+  srcAddr.addrMode = Addr16Bit;
+  srcAddr.addr.shortAddr = 0x1234;
+  osal_memset( &sig, 0, sizeof( sig ) );
+
+  afIncomingData( &aff, &srcAddr, 0, &sig, 0, FALSE, 0 );
+
+  while ( (pMsg = (afIncomingMSGPacket_t *)osal_msg_receive( benchTaskID )) != NULL )
+  {
+    if ( check )
+    {
+      BENCH_CHECK( osal_memcmp( pMsg->cmd.Data, benchAsdu, BENCH_ASDU_LEN ) );
+      if ( cnt == 0 )
+      {
+        pData = pMsg->cmd.Data;
+        own = ( pData == (uint8 *)(pMsg + 1) );
+      }
+      else
+      {
+        // Every endpoint after the first shares the first one's copy.
+        BENCH_CHECK( pMsg->cmd.Data == pData );
+        BENCH_CHECK( pData != (uint8 *)(pMsg + 1) );
+      }
+    }
+    cnt++;
+    osal_msg_deallocate( (uint8 *)pMsg );
+  }
+
+  if ( check && (cnt == 1) )
+  {
+    // A single endpoint has the ASDU in its own message.
+    BENCH_CHECK( own );
+  }
+  else if ( check )
+  {
+    BENCH_CHECK( !own );
+  }
+
+  return ( cnt );
+}
+
+/*********************************************************************
+ * @fn      benchRun
+ *
+ * @brief   Checks, then times, the delivery of one kind of frame.
+ */
+static void benchRun( const char *name, uint8 dstEP, uint16 groupID, uint8 expect )
+{
+  uint32 cnt = benchIters( 1000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  BENCH_CHECK( benchDeliver( dstEP, groupID, TRUE ) == expect );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    benchDeliver( dstEP, groupID, FALSE );
+  }
+  benchReport( name, cnt, benchNow() - t0 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Registers the endpoints and groups and runs each kind of frame.
+ */
+int main( int argc, char **argv )
+{
+  aps_Group_t group;
+  uint8 i;
+
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  benchSimpleDesc.AppProfId = BENCH_PROFILE;
+  for ( i = 0; i < BENCH_EP_CNT; i++ )
+  {
+    benchEP[i].endPoint = BENCH_EP_FIRST + i;
+    benchEP[i].task_id = &benchTaskID;
+    benchEP[i].simpleDesc = &benchSimpleDesc;
+    benchEP[i].latencyReq = noLatencyReqs;
+    BENCH_CHECK( afRegister( benchEP + i ) == afStatus_SUCCESS );
+  }
+  for ( i = 0; i < BENCH_ASDU_LEN; i++ )
+  {
+    benchAsdu[i] = i;
+  }
+
+  osal_memset( &group, 0, sizeof( group ) );
+  group.ID = BENCH_GROUP_ONE;
+  afAddGroup( BENCH_EP_FIRST, &group );
+  group.ID = BENCH_GROUP_HALF;
+  for ( i = 0; i < BENCH_EP_CNT; i += 2 )
+  {
+    afAddGroup( BENCH_EP_FIRST + i, &group );
+  }
+
+  benchRun( "af rx: unicast", BENCH_EP_FIRST, 0, 1 );
+  benchRun( "af rx: group, 1 endpoint", 0, BENCH_GROUP_ONE, 1 );
+  benchRun( "af rx: group, 4 endpoints", 0, BENCH_GROUP_HALF, BENCH_EP_CNT / 2 );
+  benchRun( "af rx: broadcast, 8 endpoints", AF_BROADCAST_ENDPOINT, 0, BENCH_EP_CNT );
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
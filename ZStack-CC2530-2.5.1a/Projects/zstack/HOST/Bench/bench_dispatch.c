@@ -0,0 +1,234 @@
+/**************************************************************************************************
+  Filename:       bench_dispatch.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Measures the OSAL dispatch overhead with synthetic tasks.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Measures the dispatch overhead of osal_run_system() with BENCH_TASK_CNT synthetic tasks:
+ *  an idle pass, and one ready task at the top, middle and bottom of the priority order.
+ *  Then task 0 keeps itself busy, as the NWK task does in a join storm, and the lowest
+ *  priority task posts one event: the number of dispatches before it runs shows whether
+ *  it starves. bench_dispatch_fair is the same source built with OSAL_FAIRNESS_LIMIT.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "hal_mcu.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TASK_CNT         64
+#define BENCH_BUSY_TASK        0
+#define BENCH_LOW_TASK         (BENCH_TASK_CNT - 1)
+
+// Dispatches after which the lowest priority task counts as starved
+#define BENCH_STARVED          10000
+
+#if !defined OSAL_FAIRNESS_LIMIT
+#define OSAL_FAIRNESS_LIMIT    0
+#endif
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define BENCH_TASKS_8   benchTask, benchTask, benchTask, benchTask, \
+                        benchTask, benchTask, benchTask, benchTask
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[BENCH_TASK_CNT] = {
+  BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8,
+  BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8
+};
+
+const uint8 tasksCnt = BENCH_TASK_CNT;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 benchRuns[BENCH_TASK_CNT];
+static uint8 benchBusy;
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTask
+ *
+ * @brief   Counts its dispatches; the busy task hands its events back.
+ */
+static uint16 benchTask( uint8 task_id, uint16 events )
+{
+  benchRuns[task_id]++;
+
+  return ( (benchBusy && (task_id == BENCH_BUSY_TASK)) ? events : 0 );
+}
+
+/*********************************************************************
+ * @fn      benchReady
+ *
+ * @brief   Times setting an event on one task and dispatching it.
+ */
+static void benchReady( uint8 task_id )
+{
+  char name[48];
+  uint32 cnt = benchIters( 2000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  benchRuns[task_id] = 0;
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    osal_set_event( task_id, 0x0001 );
+    osal_run_system();
+  }
+  sprintf( name, "dispatch: task %u of %u ready", task_id, BENCH_TASK_CNT );
+  benchReport( name, cnt, benchNow() - t0 );
+  BENCH_CHECK( benchRuns[task_id] == cnt );
+}
+
+/*********************************************************************
+ * @fn      benchIdle
+ *
+ * @brief   Times a pass of osal_run_system() with no task ready.
+ */
+static void benchIdle( void )
+{
+  uint32 cnt = benchIters( 2000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    osal_run_system();
+  }
+  benchReport( "dispatch: idle pass", cnt, benchNow() - t0 );
+}
+
+/*********************************************************************
+ * @fn      benchStarve
+ *
+ * @brief   Counts the dispatches that the lowest priority task waits while the highest
+ *          priority task stays busy.
+ */
+static void benchStarve( void )
+{
+  uint32 waited = 0;
+
+  benchBusy = TRUE;
+  benchRuns[BENCH_LOW_TASK] = 0;
+  osal_set_event( BENCH_BUSY_TASK, 0x0001 );
+  osal_set_event( BENCH_LOW_TASK, 0x0001 );
+
+  while ( (benchRuns[BENCH_LOW_TASK] == 0) && (waited < BENCH_STARVED) )
+  {
+    osal_run_system();
+    waited++;
+  }
+
+  benchBusy = FALSE;
+  osal_clear_event( BENCH_BUSY_TASK, 0x0001 );
+
+  benchValue( "fairness: dispatches before lowest runs", (double)waited,
+              (waited < BENCH_STARVED) ? "" : "(starved)" );
+#if OSAL_FAIRNESS_LIMIT
+  BENCH_CHECK( waited <= OSAL_FAIRNESS_LIMIT + 1 );
+#else
+  BENCH_CHECK( waited == BENCH_STARVED );
+#endif
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs each measurement in turn.
+ */
+int main( int argc, char **argv )
+{
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  printf( "OSAL_FAIRNESS_LIMIT %u\n", OSAL_FAIRNESS_LIMIT );
+  benchIdle();
+  benchReady( 0 );
+  benchReady( BENCH_TASK_CNT / 2 );
+  benchReady( BENCH_LOW_TASK );
+  benchStarve();
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,254 @@
+/**************************************************************************************************
+  Filename:       bench_heap.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Times the OSAL heap with slabs, with and without the site profiler.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Times osal_mem_alloc()/osal_mem_free() with the size-class slabs, and checks that a block
+ *  comes from the slab its requested size belongs to. bench_heap_sites is the same source built
+ *  with OSALMEM_SITE_PROFILER: there the slab checks show that profiling does not change which
+ *  slab serves a request, and a random run checks that every site's live bytes return to zero.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "hal_mcu.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_LIVE_MAX         100
+#define BENCH_SLAB_MAX         32
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { benchTask };
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark task.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTask
+ *
+ * @brief   Unused.
+ */
+static uint16 benchTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  (void)events;
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchSlab
+ *
+ * @brief   Allocates a whole slab class of blocks of exactly the class size, and checks
+ *          that the class served every one.
+ */
+static void benchSlab( void )
+{
+  void *blk[BENCH_SLAB_MAX];
+  osalMemSlabStat_t before, after;
+  uint8 i;
+
+  osal_heap_slab_stats( 0, &before );
+  BENCH_CHECK( before.cnt <= BENCH_SLAB_MAX );
+  for ( i = 0; i < before.cnt; i++ )
+  {
+    blk[i] = osal_mem_alloc( before.size );
+    BENCH_CHECK( blk[i] != NULL );
+  }
+  osal_heap_slab_stats( 0, &after );
+  BENCH_CHECK( after.hit - before.hit == before.cnt );
+
+  for ( i = 0; i < before.cnt; i++ )
+  {
+    osal_mem_free( blk[i] );
+  }
+  printf( "%-40s %10s\n", "slab class of a full-size request", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchPairs
+ *
+ * @brief   Times alloc/free pairs of slab-sized and heap-sized requests.
+ */
+static void benchPairs( void )
+{
+  static const uint8 sizes[] = { 8, 16, 24, 32, 48, 64, 100, 150 };
+  void *live[16];
+  uint32 cnt = benchIters( 2000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  osal_memset( live, 0, sizeof( live ) );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint8 slot = (uint8)((i * 5) % 16);
+
+    if ( live[slot] != NULL )
+    {
+      osal_mem_free( live[slot] );
+    }
+    live[slot] = osal_mem_alloc( sizes[i % sizeof( sizes )] );
+    BENCH_CHECK( live[slot] != NULL );
+  }
+#if OSALMEM_SITE_PROFILER
+  benchReport( "heap: free + alloc, site profiler", cnt, benchNow() - t0 );
+#else
+  benchReport( "heap: free + alloc, slabs", cnt, benchNow() - t0 );
+#endif
+
+  for ( i = 0; i < 16; i++ )
+  {
+    osal_mem_free( live[i] );
+  }
+}
+
+#if OSALMEM_SITE_PROFILER
+/*********************************************************************
+ * @fn      benchSites
+ *
+ * @brief   Allocates and frees at random, with more blocks live than the profiler
+ *          tracks, then checks that every site's live bytes are back to zero.
+ */
+static void benchSites( void )
+{
+  void *live[BENCH_LIVE_MAX];
+  uint16 before[OSALMEM_SITE_MAX];
+  osalMemSite_t site;
+  uint32 cnt = benchIters( 1000000 );
+  uint32 i;
+  uint8 idx;
+
+  osal_memset( live, 0, sizeof( live ) );
+  osal_memset( before, 0, sizeof( before ) );
+  for ( idx = 0; osal_heap_site_get( idx, &site ) == SUCCESS; idx++ )
+  {
+    before[idx] = site.live;
+  }
+
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint8 slot = benchRand() % BENCH_LIVE_MAX;
+
+    if ( live[slot] != NULL )
+    {
+      osal_mem_free( live[slot] );
+      live[slot] = NULL;
+    }
+    else
+    {
+      live[slot] = osal_mem_alloc( 1 + (benchRand() % 40) );
+    }
+  }
+
+  for ( i = 0; i < BENCH_LIVE_MAX; i++ )
+  {
+    if ( live[i] != NULL )
+    {
+      osal_mem_free( live[i] );
+    }
+  }
+
+  for ( idx = 0; osal_heap_site_get( idx, &site ) == SUCCESS; idx++ )
+  {
+    BENCH_CHECK( site.live == before[idx] );
+  }
+  benchValue( "sites: untracked allocations", osal_heap_site_untracked(), "" );
+  BENCH_CHECK( osal_heap_site_untracked() > 0 );
+}
+#endif
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs each benchmark in turn.
+ */
+int main( int argc, char **argv )
+{
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  benchSlab();
+  benchPairs();
+#if OSALMEM_SITE_PROFILER
+  benchSites();
+#endif
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
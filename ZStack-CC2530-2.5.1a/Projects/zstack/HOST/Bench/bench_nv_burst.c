@@ -0,0 +1,250 @@
+/**************************************************************************************************
+  Filename:       bench_nv_burst.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Times NV writes with burst and word by word flash access.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Runs a fixed mix of NV writes, re-creates and re-inits over 40 items of up to 120 bytes,
+ *  checked against a RAM model, and reports the time and the HalFlashRead()/HalFlashWrite()
+ *  calls per operation. Built once for each OSAL_NV_BURST_SIZE: bursts of one flash word
+ *  are the word by word path. The final image checksum is printed so that runs of the
+ *  different builds can be seen to leave the same flash contents.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_ITEM_CNT         40
+#define BENCH_ITEM_ID          0x0100  // Id of the first item
+#define BENCH_ITEM_MIN         8       // Shortest item
+#define BENCH_ITEM_MAX         120     // Longest item
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { NULL };
+const uint8 tasksCnt = 0;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 benchModel[BENCH_ITEM_CNT][BENCH_ITEM_MAX];
+static uint8 benchLen[BENCH_ITEM_CNT];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   No tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+}
+
+/*********************************************************************
+ * @fn      benchCreate
+ *
+ * @brief   Creates an item of random length and contents, in NV and in the model.
+ */
+static void benchCreate( uint16 item )
+{
+  uint8 idx;
+
+  benchLen[item] = BENCH_ITEM_MIN + (benchRand() % (BENCH_ITEM_MAX - BENCH_ITEM_MIN + 1));
+  for ( idx = 0; idx < benchLen[item]; idx++ )
+  {
+    benchModel[item][idx] = (uint8)benchRand();
+  }
+
+  BENCH_CHECK( osal_nv_item_init( BENCH_ITEM_ID + item, benchLen[item],
+                                  benchModel[item] ) == NV_ITEM_UNINIT );
+}
+
+/*********************************************************************
+ * @fn      benchVerify
+ *
+ * @brief   Checks the length and contents of every item against the model.
+ */
+static void benchVerify( void )
+{
+  uint8 buf[BENCH_ITEM_MAX];
+  uint16 item;
+
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    BENCH_CHECK( osal_nv_item_len( BENCH_ITEM_ID + item ) == benchLen[item] );
+    BENCH_CHECK( osal_nv_read( BENCH_ITEM_ID + item, 0, benchLen[item], buf ) == SUCCESS );
+    BENCH_CHECK( osal_memcmp( buf, benchModel[item], benchLen[item] ) );
+  }
+}
+
+/*********************************************************************
+ * @fn      benchMix
+ *
+ * @brief   Runs and times the mix: mostly partial and whole writes, some of them of
+ *          unchanged data, with the odd delete and re-create and re-init.
+ */
+static void benchMix( void )
+{
+  uint32 cnt = benchIters( 2000000 );
+  uint8 buf[BENCH_ITEM_MAX];
+  unsigned long long t0;
+  uint32 reads0, reads;
+  uint32 writes0, writes;
+  uint32 words;
+  uint16 item;
+  uint16 op;
+  uint8 ndx;
+  uint8 len;
+  uint8 idx;
+  uint32 i;
+
+  halHostFlashCalls( &reads0, &writes0 );
+  words = halHostFlashWrites();
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    item = benchRand() % BENCH_ITEM_CNT;
+    op = benchRand() % 100;
+
+    if ( op < 60 )
+    {
+      len = 1 + (benchRand() % benchLen[item]);
+      ndx = benchRand() % (benchLen[item] - len + 1);
+      for ( idx = 0; idx < len; idx++ )
+      {
+        buf[idx] = (uint8)benchRand();
+      }
+      BENCH_CHECK( osal_nv_write( BENCH_ITEM_ID + item, ndx, len, buf ) == SUCCESS );
+      osal_memcpy( benchModel[item] + ndx, buf, len );
+    }
+    else if ( op < 90 )
+    {
+      // Unchanged data, which the write compares and leaves
+      BENCH_CHECK( osal_nv_write( BENCH_ITEM_ID + item, 0, benchLen[item],
+                                  benchModel[item] ) == SUCCESS );
+    }
+    else if ( op < 99 )
+    {
+      BENCH_CHECK( osal_nv_read( BENCH_ITEM_ID + item, 0, benchLen[item], buf ) == SUCCESS );
+    }
+    else if ( (i % 4) == 0 )
+    {
+      BENCH_CHECK( osal_nv_delete( BENCH_ITEM_ID + item, benchLen[item] ) == SUCCESS );
+      benchCreate( item );
+    }
+    else
+    {
+      osal_nv_init( NULL );
+    }
+  }
+  t0 = benchNow() - t0;
+
+  words = halHostFlashWrites() - words;
+  halHostFlashCalls( &reads, &writes );
+
+  benchVerify();
+  osal_nv_init( NULL );
+  benchVerify();
+
+  benchReport( "nv: mixed operation", cnt, t0 );
+  benchValue( "nv: HalFlashRead calls per op", (double)(reads - reads0) / cnt, "calls" );
+  benchValue( "nv: HalFlashWrite calls per op", (double)(writes - writes0) / cnt, "calls" );
+  benchValue( "nv: flash words written per op", (double)words / cnt, "words" );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Creates the items on an empty NV image, runs the mix and prints the checksum
+ *          of the image it leaves.
+ */
+int main( int argc, char **argv )
+{
+  const uint8 *pImage;
+  uint32 sum = 0;
+  uint32 idx;
+  uint16 item;
+
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  halHostFlashReset();
+  osal_nv_init( NULL );
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    benchCreate( item );
+  }
+
+  benchMix();
+
+  pImage = halHostFlashImage();
+  for ( idx = 0; idx < (uint32)HAL_FLASH_PAGE_CNT * HAL_FLASH_PAGE_SIZE; idx++ )
+  {
+    sum = (sum * 31) + pImage[idx];
+  }
+  printf( "%-40s   %08lx\n", "nv: flash image checksum", (unsigned long)sum );
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,245 @@
+/**************************************************************************************************
+  Filename:       bench_nv_index.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Times NV item lookups with and without the RAM index.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Times NV item lookups (osal_nv_read() and osal_nv_item_len()) over a few hundred items,
+ *  built once for each OSAL_NV_INDEX_CNT: no index, an index smaller than the item count and
+ *  one that holds every item. Before timing, runs random writes, deletes, re-creates and
+ *  re-inits against a RAM model of the items, so the index is checked as well as timed.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_ITEM_CNT         300
+#define BENCH_ITEM_ID          0x0100  // Id of the first item
+#define BENCH_ITEM_MAX         12      // Longest item
+#define BENCH_ABSENT_ID        0x7000  // Id of no item
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { NULL };
+const uint8 tasksCnt = 0;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 benchModel[BENCH_ITEM_CNT][BENCH_ITEM_MAX];
+static uint8 benchLen[BENCH_ITEM_CNT];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   No tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+}
+
+/*********************************************************************
+ * @fn      benchCreate
+ *
+ * @brief   Creates an item of random length and contents, in NV and in the model.
+ */
+static void benchCreate( uint16 item )
+{
+  uint8 idx;
+
+  benchLen[item] = 1 + (osal_rand() % BENCH_ITEM_MAX);
+  for ( idx = 0; idx < benchLen[item]; idx++ )
+  {
+    benchModel[item][idx] = (uint8)osal_rand();
+  }
+
+  BENCH_CHECK( osal_nv_item_init( BENCH_ITEM_ID + item, benchLen[item],
+                                  benchModel[item] ) == NV_ITEM_UNINIT );
+}
+
+/*********************************************************************
+ * @fn      benchVerify
+ *
+ * @brief   Checks the length and contents of an item against the model.
+ */
+static void benchVerify( uint16 item )
+{
+  uint8 buf[BENCH_ITEM_MAX];
+
+  BENCH_CHECK( osal_nv_item_len( BENCH_ITEM_ID + item ) == benchLen[item] );
+  BENCH_CHECK( osal_nv_read( BENCH_ITEM_ID + item, 0, benchLen[item], buf ) == SUCCESS );
+  BENCH_CHECK( osal_memcmp( buf, benchModel[item], benchLen[item] ) );
+}
+
+/*********************************************************************
+ * @fn      benchChurn
+ *
+ * @brief   Random writes, deletes and re-creates, and re-inits, checked against the model.
+ */
+static void benchChurn( void )
+{
+  uint32 cnt = benchIters( 2000000 );
+  uint8 buf[BENCH_ITEM_MAX];
+  uint16 item;
+  uint16 op;
+  uint8 ndx;
+  uint8 len;
+  uint8 idx;
+  uint32 i;
+
+  for ( i = 0; i < cnt; i++ )
+  {
+    item = osal_rand() % BENCH_ITEM_CNT;
+    op = osal_rand() % 100;
+
+    if ( op < 30 )
+    {
+      len = 1 + (osal_rand() % benchLen[item]);
+      ndx = osal_rand() % (benchLen[item] - len + 1);
+      for ( idx = 0; idx < len; idx++ )
+      {
+        buf[idx] = (uint8)osal_rand();
+      }
+      BENCH_CHECK( osal_nv_write( BENCH_ITEM_ID + item, ndx, len, buf ) == SUCCESS );
+      osal_memcpy( benchModel[item] + ndx, buf, len );
+    }
+    else if ( op == 30 )
+    {
+      BENCH_CHECK( osal_nv_delete( BENCH_ITEM_ID + item, benchLen[item] ) == SUCCESS );
+      benchCreate( item );
+    }
+    else if ( (op == 31) && ((osal_rand() % 64) == 0) )
+    {
+      osal_nv_init( NULL );
+    }
+    else
+    {
+      benchVerify( item );
+    }
+  }
+
+  BENCH_CHECK( osal_nv_item_len( BENCH_ABSENT_ID ) == 0 );
+  osal_nv_init( NULL );
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    benchVerify( item );
+  }
+  printf( "%-40s %10s\n", "nv: items after churn and re-init", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchLookup
+ *
+ * @brief   Times reads of random items, and length lookups of an absent item, which has
+ *          to be looked for everywhere.
+ */
+static void benchLookup( void )
+{
+  uint32 cnt = benchIters( 2000000 );
+  uint8 buf[BENCH_ITEM_MAX];
+  unsigned long long t0;
+  uint16 item;
+  uint32 i;
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    item = (uint16)((i * 7919) % BENCH_ITEM_CNT);
+    osal_nv_read( BENCH_ITEM_ID + item, 0, benchLen[item], buf );
+  }
+  benchReport( "nv: read of 1 of 300 items", cnt, benchNow() - t0 );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    osal_nv_item_len( BENCH_ABSENT_ID );
+  }
+  benchReport( "nv: length of an absent item", cnt, benchNow() - t0 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Creates the items on an empty NV image, then runs the check and timings.
+ */
+int main( int argc, char **argv )
+{
+  uint16 item;
+
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  halHostFlashReset();
+  osal_nv_init( NULL );
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    benchCreate( item );
+  }
+
+  benchChurn();
+  benchLookup();
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
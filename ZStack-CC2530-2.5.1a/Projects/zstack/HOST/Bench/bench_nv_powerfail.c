@@ -0,0 +1,567 @@
+/**************************************************************************************************
+  Filename:       bench_nv_powerfail.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Cuts the power at every NV flash step and checks the reboot.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Power-fail harness for OSAL NV. For each of three workloads, binding record updates,
+ *  scene record saves and network frame counter saves, it:
+ *    - runs the workload to report item writes per second, flash words per write and page
+ *      erases, ageing the flash as it goes;
+ *    - records a window of operations that includes a page compaction, then, for every flash
+ *      step (word write or page erase) of that window, replays the window in a fork()ed child
+ *      whose power is cut at that step (halHostFlashCut());
+ *    - boots a second child on the image left, re-running osal_nv_init(), and checks every
+ *      item holds either the values before the operation that was cut or the values after
+ *      it, per the RAM reference model, and that NV still works after more writes and a
+ *      second boot.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Items: binding record blocks, scene records and the active network key info.
+#define BENCH_BIND_CNT         4
+#define BENCH_BIND_RECS        8
+#define BENCH_BIND_REC_LEN     14
+#define BENCH_BIND_LEN         (BENCH_BIND_RECS * BENCH_BIND_REC_LEN)
+#define BENCH_SCENE_CNT        8
+#define BENCH_SCENE_LEN        48
+#define BENCH_KEY_LEN          21      // Key sequence number, key and frame counter
+#define BENCH_KEY_FC_OFF       17      // Offset of the frame counter
+
+#define BENCH_ITEM_CNT         (BENCH_BIND_CNT + BENCH_SCENE_CNT + 1)
+#define BENCH_ITEM_MAX         BENCH_BIND_LEN
+
+#define BENCH_WINDOW_MIN       40      // Operations in the power cut window, at least
+#define BENCH_WINDOW_MAX       400
+#define BENCH_AFTER_OPS        50      // Operations run after a cut, before the second boot
+
+// Exit codes of the child that boots after a cut
+#define BENCH_BOOT_OLD         10      // Items as before the cut operation
+#define BENCH_BOOT_NEW         11      // Items as after it
+#define BENCH_BOOT_BAD         1
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// One write of a workload
+typedef struct
+{
+  uint8  item;
+  uint8  off;
+  uint8  len;
+  uint8  seed;
+} benchOp_t;
+
+// The contents every item should have
+typedef struct
+{
+  uint8 data[BENCH_ITEM_CNT][BENCH_ITEM_MAX];
+} benchModel_t;
+
+// A workload: its name and the operation it picks next
+typedef struct
+{
+  const char *name;
+  void (*pick)( benchOp_t *pOp );
+} benchWorkload_t;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void benchPickBind( benchOp_t *pOp );
+static void benchPickScene( benchOp_t *pOp );
+static void benchPickFrameCnt( benchOp_t *pOp );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { NULL };
+const uint8 tasksCnt = 0;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static const benchWorkload_t benchWorkloads[] = {
+  { "binding records", benchPickBind },
+  { "scene records", benchPickScene },
+  { "frame counter", benchPickFrameCnt }
+};
+
+static uint16 benchIds[BENCH_ITEM_CNT];
+static uint8 benchLens[BENCH_ITEM_CNT];
+
+static benchModel_t benchModel;
+static benchOp_t benchWindow[BENCH_WINDOW_MAX];
+static uint32 benchSteps[BENCH_WINDOW_MAX];        // Flash steps to the end of each operation
+static benchModel_t benchBefore[BENCH_WINDOW_MAX + 1];
+static uint8 benchBase[HAL_NV_PAGE_CNT * HAL_FLASH_PAGE_SIZE];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   No tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+}
+
+/*********************************************************************
+ * @fn      benchPickBind
+ *
+ * @brief   Rewrites one binding record of a block.
+ */
+static void benchPickBind( benchOp_t *pOp )
+{
+  pOp->item = benchRand() % BENCH_BIND_CNT;
+  pOp->off = (benchRand() % BENCH_BIND_RECS) * BENCH_BIND_REC_LEN;
+  pOp->len = BENCH_BIND_REC_LEN;
+}
+
+/*********************************************************************
+ * @fn      benchPickScene
+ *
+ * @brief   Saves a whole scene record, or, one time in four, frees it by its endpoint byte.
+ */
+static void benchPickScene( benchOp_t *pOp )
+{
+  pOp->item = BENCH_BIND_CNT + (benchRand() % BENCH_SCENE_CNT);
+  pOp->off = 0;
+  pOp->len = ((benchRand() % 4) == 0) ? 1 : BENCH_SCENE_LEN;
+}
+
+/*********************************************************************
+ * @fn      benchPickFrameCnt
+ *
+ * @brief   Saves the frame counter of the active network key.
+ */
+static void benchPickFrameCnt( benchOp_t *pOp )
+{
+  pOp->item = BENCH_BIND_CNT + BENCH_SCENE_CNT;
+  pOp->off = BENCH_KEY_FC_OFF;
+  pOp->len = 4;
+}
+
+/*********************************************************************
+ * @fn      benchFill
+ *
+ * @brief   The data an operation writes, no longer than any item.
+ */
+static void benchFill( uint8 *buf, uint8 len, uint8 seed )
+{
+  uint8 idx;
+
+  for ( idx = 0; (idx < len) && (idx < BENCH_ITEM_MAX); idx++ )
+  {
+    buf[idx] = (uint8)((seed * 37) + (idx * 11));
+  }
+}
+
+/*********************************************************************
+ * @fn      benchRun
+ *
+ * @brief   Writes an operation to NV and, if pModel is not NULL, to the model.
+ */
+static void benchRun( const benchOp_t *pOp, benchModel_t *pModel )
+{
+  uint8 buf[BENCH_ITEM_MAX];
+
+  benchFill( buf, pOp->len, pOp->seed );
+  BENCH_CHECK( osal_nv_write( benchIds[pOp->item], pOp->off, pOp->len, buf ) == SUCCESS );
+
+  if ( pModel != NULL )
+  {
+    osal_memcpy( pModel->data[pOp->item] + pOp->off, buf, pOp->len );
+  }
+}
+
+/*********************************************************************
+ * @fn      benchBoot
+ *
+ * @brief   Starts NV as a device does after a reset.
+ */
+static void benchBoot( void )
+{
+  uint8 item;
+
+  osal_nv_init( NULL );
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    osal_nv_item_init( benchIds[item], benchLens[item], NULL );
+  }
+}
+
+/*********************************************************************
+ * @fn      benchMatch
+ *
+ * @brief   Compares every item with a model.
+ *
+ * @return  TRUE if they all match
+ */
+static uint8 benchMatch( const benchModel_t *pModel )
+{
+  uint8 buf[BENCH_ITEM_MAX];
+  uint8 item;
+
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    if ( (osal_nv_read( benchIds[item], 0, benchLens[item], buf ) != SUCCESS) ||
+         !osal_memcmp( buf, pModel->data[item], benchLens[item] ) )
+    {
+      return ( FALSE );
+    }
+  }
+
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      benchFlashSteps
+ *
+ * @brief   Word writes and page erases of the NV pages so far.
+ */
+static uint32 benchFlashSteps( void )
+{
+  uint32 steps = halHostFlashWrites();
+  uint8 pg;
+
+  for ( pg = HAL_NV_PAGE_BEG; pg < HAL_NV_PAGE_BEG + HAL_NV_PAGE_CNT; pg++ )
+  {
+    steps += halHostFlashErases( pg );
+  }
+
+  return ( steps );
+}
+
+/*********************************************************************
+ * @fn      benchNvImage
+ *
+ * @brief   The NV pages of the flash image.
+ */
+static uint8 *benchNvImage( void )
+{
+  return ( halHostFlashImage() + ((uint32)HAL_NV_PAGE_BEG * HAL_FLASH_PAGE_SIZE) );
+}
+
+/*********************************************************************
+ * @fn      benchThroughput
+ *
+ * @brief   Runs a workload, reporting writes per second, words per write and page erases.
+ */
+static void benchThroughput( const benchWorkload_t *pLoad )
+{
+  uint32 cnt = benchIters( 500000 );
+  uint32 erases[HAL_NV_PAGE_CNT];
+  uint32 words = halHostFlashWrites();
+  uint32 total = 0;
+  uint32 most = 0;
+  unsigned long long t0;
+  benchOp_t op;
+  char name[64];
+  uint32 i;
+  uint8 pg;
+
+  for ( pg = 0; pg < HAL_NV_PAGE_CNT; pg++ )
+  {
+    erases[pg] = halHostFlashErases( HAL_NV_PAGE_BEG + pg );
+  }
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    pLoad->pick( &op );
+    op.seed = (uint8)benchRand();
+    benchRun( &op, &benchModel );
+  }
+  t0 = benchNow() - t0;
+
+  for ( pg = 0; pg < HAL_NV_PAGE_CNT; pg++ )
+  {
+    erases[pg] = halHostFlashErases( HAL_NV_PAGE_BEG + pg ) - erases[pg];
+    total += erases[pg];
+    most = (erases[pg] > most) ? erases[pg] : most;
+  }
+
+  BENCH_CHECK( benchMatch( &benchModel ) );
+  benchBoot();
+  BENCH_CHECK( benchMatch( &benchModel ) );
+
+  sprintf( name, "%s: writes/s", pLoad->name );
+  benchValue( name, (double)cnt * 1e9 / (double)t0, "writes" );
+  sprintf( name, "%s: flash words per write", pLoad->name );
+  benchValue( name, (double)(halHostFlashWrites() - words) / cnt, "words" );
+  sprintf( name, "%s: page erases", pLoad->name );
+  benchValue( name, (double)total, "erases" );
+  sprintf( name, "%s: erases of the most worn page", pLoad->name );
+  benchValue( name, (double)most, "erases" );
+}
+
+/*********************************************************************
+ * @fn      benchRecord
+ *
+ * @brief   Records a window of operations, from the flash as it is now, that has at least
+ *          BENCH_WINDOW_MIN operations and a page erase, with the flash steps to the end of
+ *          each operation and the model before each.
+ *
+ * @return  number of operations in the window
+ */
+static uint16 benchRecord( const benchWorkload_t *pLoad )
+{
+  uint32 steps;
+  uint32 erases;
+  uint16 cnt;
+
+  osal_memcpy( benchBase, benchNvImage(), sizeof( benchBase ) );
+  benchBoot();
+  benchBefore[0] = benchModel;
+
+  steps = benchFlashSteps();
+  erases = steps - halHostFlashWrites();
+  for ( cnt = 0; cnt < BENCH_WINDOW_MAX; cnt++ )
+  {
+    if ( (cnt >= BENCH_WINDOW_MIN) && ((benchFlashSteps() - halHostFlashWrites()) != erases) )
+    {
+      break;
+    }
+
+    pLoad->pick( benchWindow + cnt );
+    benchWindow[cnt].seed = (uint8)benchRand();
+    benchBefore[cnt + 1] = benchBefore[cnt];
+    benchRun( benchWindow + cnt, benchBefore + cnt + 1 );
+    benchSteps[cnt] = benchFlashSteps() - steps;
+  }
+  BENCH_CHECK( cnt < BENCH_WINDOW_MAX );
+
+  benchModel = benchBefore[cnt];
+  return ( cnt );
+}
+
+/*********************************************************************
+ * @fn      benchBootAfterCut
+ *
+ * @brief   In the child that boots on the image left by a cut in operation 'op': checks the
+ *          items are as before or as after it, then that NV keeps working.
+ *
+ * @return  exit code, BENCH_BOOT_OLD, BENCH_BOOT_NEW or BENCH_BOOT_BAD
+ */
+static int benchBootAfterCut( const benchWorkload_t *pLoad, uint16 op )
+{
+  benchModel_t *pModel;
+  benchOp_t next;
+  int code;
+  uint16 i;
+
+  benchBoot();
+
+  if ( benchMatch( benchBefore + op ) )
+  {
+    code = BENCH_BOOT_OLD;
+  }
+  else if ( benchMatch( benchBefore + op + 1 ) )
+  {
+    code = BENCH_BOOT_NEW;
+  }
+  else
+  {
+    return ( BENCH_BOOT_BAD );
+  }
+
+  pModel = benchBefore + op + ((code == BENCH_BOOT_OLD) ? 0 : 1);
+  for ( i = 0; i < BENCH_AFTER_OPS; i++ )
+  {
+    pLoad->pick( &next );
+    next.seed = (uint8)benchRand();
+    benchRun( &next, pModel );
+  }
+  benchBoot();
+
+  return ( benchMatch( pModel ) ? code : BENCH_BOOT_BAD );
+}
+
+/*********************************************************************
+ * @fn      benchPowerCuts
+ *
+ * @brief   Cuts the power at every flash step of the window in turn.
+ */
+static void benchPowerCuts( const benchWorkload_t *pLoad, uint16 cnt )
+{
+  uint32 counts[BENCH_BOOT_NEW + 1] = { 0 };
+  char name[64];
+  uint32 step;
+  pid_t pid;
+  int status;
+  uint16 op;
+  uint16 i;
+
+  for ( step = 0; ; step++ )
+  {
+    osal_memcpy( benchNvImage(), benchBase, sizeof( benchBase ) );
+
+    fflush( stdout );  // Or a child that fails prints it again
+    pid = fork();
+    if ( pid == 0 )
+    {
+      benchBoot();
+      halHostFlashCut( step );
+      for ( i = 0; i < cnt; i++ )
+      {
+        benchRun( benchWindow + i, NULL );
+      }
+      _exit( 0 );
+    }
+    BENCH_CHECK( waitpid( pid, &status, 0 ) == pid );
+    BENCH_CHECK( WIFEXITED( status ) );
+    if ( WEXITSTATUS( status ) == 0 )
+    {
+      break;  // The window ran to its end before the step
+    }
+    BENCH_CHECK( WEXITSTATUS( status ) == HAL_HOST_CUT_EXIT );
+
+    for ( op = 0; (op < cnt) && (benchSteps[op] <= step); op++ );
+    BENCH_CHECK( op < cnt );
+
+    pid = fork();
+    if ( pid == 0 )
+    {
+      _exit( benchBootAfterCut( pLoad, op ) );
+    }
+    BENCH_CHECK( waitpid( pid, &status, 0 ) == pid );
+    BENCH_CHECK( WIFEXITED( status ) );
+    if ( WEXITSTATUS( status ) == BENCH_BOOT_BAD )
+    {
+      printf( "%s: bad NV after a cut at step %lu, in operation %u\n",
+              pLoad->name, (unsigned long)step, op );
+    }
+    counts[(WEXITSTATUS( status ) == BENCH_BOOT_BAD) ? 0 : WEXITSTATUS( status )]++;
+  }
+
+  sprintf( name, "%s: power cuts", pLoad->name );
+  printf( "%-40s %10lu  (%u ops; old %lu, new %lu, bad %lu)\n", name, (unsigned long)step, cnt,
+          (unsigned long)counts[BENCH_BOOT_OLD], (unsigned long)counts[BENCH_BOOT_NEW],
+          (unsigned long)counts[0] );
+  BENCH_CHECK( counts[0] == 0 );
+
+  // Carry on from the end of the window
+  osal_memcpy( benchNvImage(), benchBase, sizeof( benchBase ) );
+  benchBoot();
+  for ( i = 0; i < cnt; i++ )
+  {
+    benchRun( benchWindow + i, NULL );
+  }
+  BENCH_CHECK( benchMatch( &benchModel ) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Creates the items on an empty NV image and runs each workload.
+ */
+int main( int argc, char **argv )
+{
+  uint8 item;
+  uint8 load;
+
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    if ( item < BENCH_BIND_CNT )
+    {
+      benchIds[item] = ZCD_NV_BINDING_DATA_START + item;
+      benchLens[item] = BENCH_BIND_LEN;
+    }
+    else if ( item < BENCH_BIND_CNT + BENCH_SCENE_CNT )
+    {
+      benchIds[item] = ZCD_NV_SCENE_DATA_START + item - BENCH_BIND_CNT;
+      benchLens[item] = BENCH_SCENE_LEN;
+    }
+    else
+    {
+      benchIds[item] = ZCD_NV_NWK_ACTIVE_KEY_INFO;
+      benchLens[item] = BENCH_KEY_LEN;
+    }
+  }
+
+  halHostFlashReset();
+  osal_nv_init( NULL );
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    benchFill( benchModel.data[item], benchLens[item], item );
+    BENCH_CHECK( osal_nv_item_init( benchIds[item], benchLens[item],
+                                    benchModel.data[item] ) == NV_ITEM_UNINIT );
+  }
+
+  for ( load = 0; load < sizeof( benchWorkloads ) / sizeof( benchWorkloads[0] ); load++ )
+  {
+    benchThroughput( benchWorkloads + load );
+    benchPowerCuts( benchWorkloads + load, benchRecord( benchWorkloads + load ) );
+  }
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
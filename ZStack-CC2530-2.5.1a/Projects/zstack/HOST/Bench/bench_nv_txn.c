@@ -0,0 +1,239 @@
+/**************************************************************************************************
+  Filename:       bench_nv_txn.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks and times NV transactions.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+/*
+ *  Checks and times OSAL NV transactions: a commit of several items writes all of them, and a
+ *  transaction with a write that cannot be staged (an item that does not exist, or one more
+ *  than OSAL_NV_TXN_MAX items) fails its commit and leaves every item as it was.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TXN_MAX          4       // OSAL_NV_TXN_MAX, as built
+#define BENCH_ITEM_CNT         6       // More than BENCH_TXN_MAX
+#define BENCH_ITEM_ID          0x0100  // Id of the first item
+#define BENCH_ITEM_LEN         32
+#define BENCH_ITEM_NONE        0x0180  // Id of an item that is never created
+#define BENCH_ITEM_NULL        0       // No item
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { NULL };
+const uint8 tasksCnt = 0;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 benchModel[BENCH_ITEM_CNT][BENCH_ITEM_LEN];
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   No tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+}
+
+/*********************************************************************
+ * @fn      benchMatch
+ *
+ * @brief   Compares every item with the model.
+ */
+static bool benchMatch( void )
+{
+  uint8 buf[BENCH_ITEM_LEN];
+  uint8 item;
+
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    if ( (osal_nv_read( BENCH_ITEM_ID + item, 0, BENCH_ITEM_LEN, buf ) != SUCCESS) ||
+         !osal_memcmp( buf, benchModel[item], BENCH_ITEM_LEN ) )
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      benchTxn
+ *
+ * @brief   Writes the first cnt items with a new fill in one transaction, then writes
+ *          the item bad, if not BENCH_ITEM_NULL, and commits.
+ *
+ * @return  The status of the commit.
+ */
+static uint8 benchTxn( uint8 cnt, uint8 fill, uint16 bad )
+{
+  uint8 buf[BENCH_ITEM_LEN];
+  uint8 item;
+
+  BENCH_CHECK( osal_nv_begin() == SUCCESS );
+
+  osal_memset( buf, fill, BENCH_ITEM_LEN );
+  for ( item = 0; item < cnt; item++ )
+  {
+    buf[0] = item;
+    if ( osal_nv_write( BENCH_ITEM_ID + item, 0, BENCH_ITEM_LEN, buf ) != SUCCESS )
+    {
+      BENCH_CHECK( item >= BENCH_TXN_MAX );
+    }
+  }
+
+  if ( bad != BENCH_ITEM_NULL )
+  {
+    BENCH_CHECK( osal_nv_write( bad, 0, BENCH_ITEM_LEN, buf ) == NV_OPER_FAILED );
+  }
+
+  return osal_nv_commit();
+}
+
+/*********************************************************************
+ * @fn      benchModelSet
+ *
+ * @brief   Updates the model as a good benchTxn() updates NV.
+ */
+static void benchModelSet( uint8 cnt, uint8 fill )
+{
+  uint8 item;
+
+  for ( item = 0; item < cnt; item++ )
+  {
+    osal_memset( benchModel[item], fill, BENCH_ITEM_LEN );
+    benchModel[item][0] = item;
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs the checks, then times commits against plain writes.
+ */
+int main( int argc, char **argv )
+{
+  uint32 cnt;
+  uint32 idx;
+  unsigned long long t0;
+  uint8 item;
+
+  benchInit( argc, argv );
+  cnt = benchIters( 20000 );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  halHostFlashReset();
+  osal_nv_init( NULL );
+  for ( item = 0; item < BENCH_ITEM_CNT; item++ )
+  {
+    BENCH_CHECK( osal_nv_item_init( BENCH_ITEM_ID + item, BENCH_ITEM_LEN,
+                                    benchModel[item] ) == NV_ITEM_UNINIT );
+  }
+
+  // A good transaction writes every item it staged.
+  BENCH_CHECK( benchTxn( 3, 0x11, BENCH_ITEM_NULL ) == SUCCESS );
+  benchModelSet( 3, 0x11 );
+  BENCH_CHECK( benchMatch() );
+
+  // A write to an item that does not exist fails the commit, and nothing is written.
+  BENCH_CHECK( benchTxn( 3, 0x22, BENCH_ITEM_NONE ) == NV_OPER_FAILED );
+  BENCH_CHECK( benchMatch() );
+  BENCH_CHECK( osal_nv_item_len( BENCH_ITEM_NONE ) == 0 );
+
+  // So does a write to one item more than the transaction can stage.
+  BENCH_CHECK( benchTxn( BENCH_TXN_MAX + 1, 0x33, BENCH_ITEM_NULL ) == NV_OPER_FAILED );
+  BENCH_CHECK( benchMatch() );
+
+  // The failures left no transaction open, and the items are as the model after a reboot.
+  BENCH_CHECK( benchTxn( BENCH_TXN_MAX, 0x44, BENCH_ITEM_NULL ) == SUCCESS );
+  benchModelSet( BENCH_TXN_MAX, 0x44 );
+  osal_nv_init( NULL );
+  BENCH_CHECK( benchMatch() );
+
+  t0 = benchNow();
+  for ( idx = 0; idx < cnt; idx++ )
+  {
+    BENCH_CHECK( benchTxn( 3, (uint8)idx, BENCH_ITEM_NULL ) == SUCCESS );
+  }
+  benchReport( "nv: commit of 3 items", cnt, benchNow() - t0 );
+
+  t0 = benchNow();
+  for ( idx = 0; idx < cnt; idx++ )
+  {
+    uint8 buf[BENCH_ITEM_LEN];
+
+    osal_memset( buf, (uint8)idx, BENCH_ITEM_LEN );
+    for ( item = 0; item < 3; item++ )
+    {
+      buf[0] = item;
+      BENCH_CHECK( osal_nv_write( BENCH_ITEM_ID + item, 0, BENCH_ITEM_LEN, buf ) == SUCCESS );
+    }
+  }
+  benchReport( "nv: 3 plain item writes", cnt, benchNow() - t0 );
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
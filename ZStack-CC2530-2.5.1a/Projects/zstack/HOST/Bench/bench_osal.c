@@ -0,0 +1,412 @@
+/**************************************************************************************************
+  Filename:       bench_osal.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Microbenchmarks of the OSAL scheduler, timers, heap, messages and NV.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Times the OSAL hot paths on the host: event dispatch, message round trips, heap
+ *  allocation, timer expiry and NV item access. Runs on the virtual clock, so the timer
+ *  checks are exact, and first checks that the OSAL clock stays right across the 71.6 min
+ *  wrap of the microsecond count.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Nv.h"
+#include "OnBoard.h"
+#include "hal_mcu.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_EVT_TASK         0
+#define BENCH_MSG_TASK         1
+#define BENCH_TIMER_TASK       2
+
+#define BENCH_TIMER_CNT        15      // One per event bit, below SYS_EVENT_MSG
+#define BENCH_HEAP_LIVE        32
+#define BENCH_NV_ID            0x0401
+#define BENCH_NV_LEN           32
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchEvtTask( uint8 task_id, uint16 events );
+static uint16 benchMsgTask( uint8 task_id, uint16 events );
+static uint16 benchTimerTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = {
+  benchEvtTask,
+  benchMsgTask,
+  benchTimerTask
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 benchEvtCnt;
+static uint32 benchMsgCnt;
+static uint32 benchTimerCnt;
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchEvtTask
+ *
+ * @brief   Counts the events dispatched to it.
+ */
+static uint16 benchEvtTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  benchEvtCnt++;
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchMsgTask
+ *
+ * @brief   Receives and frees the messages sent to it.
+ */
+static uint16 benchMsgTask( uint8 task_id, uint16 events )
+{
+  uint8 *pMsg;
+
+  if ( events & SYS_EVENT_MSG )
+  {
+    while ( (pMsg = osal_msg_receive( task_id )) != NULL )
+    {
+      benchMsgCnt++;
+      osal_msg_deallocate( pMsg );
+    }
+  }
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchTimerTask
+ *
+ * @brief   Counts the timer events that expired.
+ */
+static uint16 benchTimerTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+
+  while ( events )
+  {
+    events &= events - 1;
+    benchTimerCnt++;
+  }
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchClock
+ *
+ * @brief   Runs the virtual clock through 75 minutes, past the wrap of the 32-bit
+ *          microsecond count, and checks the OSAL clock moved by exactly as much.
+ */
+static void benchClock( void )
+{
+  uint32 start = osal_GetSystemClock();
+  uint16 sec;
+
+  for ( sec = 0; sec < 75 * 60; sec++ )
+  {
+    halHostClockAdvance( 1000000 );
+    osal_run_system();
+  }
+
+  BENCH_CHECK( osal_GetSystemClock() - start == 75UL * 60 * 1000 );
+  printf( "%-40s %10s\n", "clock across the usec wrap", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchEvents
+ *
+ * @brief   Times osal_set_event() and the dispatch of the event.
+ */
+static void benchEvents( void )
+{
+  uint32 cnt = benchIters( 2000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  benchEvtCnt = 0;
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    osal_set_event( BENCH_EVT_TASK, 0x0001 );
+    osal_run_system();
+  }
+  benchReport( "scheduler: set event + dispatch", cnt, benchNow() - t0 );
+  BENCH_CHECK( benchEvtCnt == cnt );
+}
+
+/*********************************************************************
+ * @fn      benchMessages
+ *
+ * @brief   Times a message allocate, send, dispatch, receive and free.
+ */
+static void benchMessages( void )
+{
+  uint32 cnt = benchIters( 1000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  benchMsgCnt = 0;
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint8 *pMsg = osal_msg_allocate( 16 );
+
+    BENCH_CHECK( pMsg != NULL );
+    osal_msg_send( BENCH_MSG_TASK, pMsg );
+    osal_run_system();
+  }
+  benchReport( "messages: allocate, send, receive, free", cnt, benchNow() - t0 );
+  BENCH_CHECK( benchMsgCnt == cnt );
+}
+
+/*********************************************************************
+ * @fn      benchHeap
+ *
+ * @brief   Times osal_mem_alloc() and osal_mem_free() of mixed sizes, with a working
+ *          set of live blocks freed out of order.
+ */
+static void benchHeap( void )
+{
+  static const uint8 sizes[] = { 8, 12, 16, 24, 40, 64, 100, 20 };
+  void *live[BENCH_HEAP_LIVE];
+  uint32 cnt = benchIters( 2000000 );
+  unsigned long long t0;
+  uint32 i;
+
+  osal_memset( live, 0, sizeof( live ) );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint8 slot = (uint8)((i * 7) % BENCH_HEAP_LIVE);
+
+    if ( live[slot] != NULL )
+    {
+      osal_mem_free( live[slot] );
+    }
+    live[slot] = osal_mem_alloc( sizes[i % sizeof( sizes )] );
+    BENCH_CHECK( live[slot] != NULL );
+  }
+  benchReport( "heap: free + alloc, mixed sizes", cnt, benchNow() - t0 );
+
+  for ( i = 0; i < BENCH_HEAP_LIVE; i++ )
+  {
+    osal_mem_free( live[i] );
+  }
+}
+
+/*********************************************************************
+ * @fn      benchTimers
+ *
+ * @brief   Times the expiry of reload timers of 1 to 15 msecs, on the virtual clock ticking
+ *          like the MAC backoff timer, and checks each fired once per period.
+ */
+static void benchTimers( void )
+{
+  uint32 msecs = benchIters( 200000 );
+  uint32 expect = 0;
+  unsigned long long t0;
+  uint32 start;
+  uint8 i;
+
+  benchTimerCnt = 0;
+  for ( i = 0; i < BENCH_TIMER_CNT; i++ )
+  {
+    osal_start_reload_timer( BENCH_TIMER_TASK, BV( i ), i + 1 );
+  }
+  start = osal_GetSystemClock();
+
+  t0 = benchNow();
+  while ( osal_GetSystemClock() - start < msecs )
+  {
+    halHostClockAdvance( 320 );     // One tick, so no timer is due twice in an update
+    osal_run_system();
+  }
+  t0 = benchNow() - t0;
+
+  for ( i = 0; i < BENCH_TIMER_CNT; i++ )
+  {
+    osal_stop_timerEx( BENCH_TIMER_TASK, BV( i ) );
+    expect += msecs / (i + 1);
+  }
+  benchReport( "timers: 15 reload timers, per expiry", benchTimerCnt, t0 );
+  BENCH_CHECK( benchTimerCnt == expect );
+}
+
+/*********************************************************************
+ * @fn      benchDeadline
+ *
+ * @brief   Checks that deadline timers for the past, including ones far enough back
+ *          to look like a long timeout when taken unsigned, expire on the next tick,
+ *          and that one in the future expires on time.
+ */
+static void benchDeadline( void )
+{
+  static const int32 past[] = { 0, -1, -70000L, -100000000L };
+  uint32 now = osal_GetSystemClock();
+  uint8 i;
+
+  benchTimerCnt = 0;
+  for ( i = 0; i < sizeof( past ) / sizeof( past[0] ); i++ )
+  {
+    BENCH_CHECK( osal_start_deadline_timer( BENCH_TIMER_TASK, BV( i ), now + past[i] ) == SUCCESS );
+  }
+  BENCH_CHECK( osal_start_deadline_timer( BENCH_TIMER_TASK, BV( i ), now + 50 ) == SUCCESS );
+
+  while ( osal_GetSystemClock() - now < 2 )
+  {
+    halHostClockAdvance( 320 );
+    osal_run_system();
+  }
+  BENCH_CHECK( benchTimerCnt == i );
+
+  while ( osal_GetSystemClock() - now < 50 )
+  {
+    halHostClockAdvance( 320 );
+    osal_run_system();
+  }
+  BENCH_CHECK( benchTimerCnt == (uint32)i + 1 );
+  printf( "%-40s %10s\n", "deadline timers in the past", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchNv
+ *
+ * @brief   Times NV writes, which compact pages as they fill, and reads of one item.
+ */
+static void benchNv( void )
+{
+  uint8 buf[BENCH_NV_LEN];
+  uint8 rd[BENCH_NV_LEN];
+  uint32 cnt = benchIters( 200000 );
+  unsigned long long t0;
+  uint32 i;
+
+  halHostFlashReset();
+  osal_nv_init( NULL );
+  osal_memset( buf, 0, sizeof( buf ) );
+  BENCH_CHECK( osal_nv_item_init( BENCH_NV_ID, BENCH_NV_LEN, buf ) == NV_ITEM_UNINIT );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    buf[0] = (uint8)i;
+    buf[BENCH_NV_LEN - 1] = (uint8)(i >> 8);
+    BENCH_CHECK( osal_nv_write( BENCH_NV_ID, 0, BENCH_NV_LEN, buf ) == SUCCESS );
+  }
+  benchReport( "nv: write 32 bytes", cnt, benchNow() - t0 );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    osal_nv_read( BENCH_NV_ID, 0, BENCH_NV_LEN, rd );
+  }
+  benchReport( "nv: read 32 bytes", cnt, benchNow() - t0 );
+  BENCH_CHECK( osal_memcmp( rd, buf, BENCH_NV_LEN ) );
+
+  osal_nv_init( NULL );
+  osal_nv_read( BENCH_NV_ID, 0, BENCH_NV_LEN, rd );
+  BENCH_CHECK( osal_memcmp( rd, buf, BENCH_NV_LEN ) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs each benchmark in turn.
+ */
+int main( int argc, char **argv )
+{
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  benchClock();
+  benchEvents();
+  benchMessages();
+  benchHeap();
+  benchTimers();
+  benchDeadline();
+  benchNv();
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,230 @@
+/**************************************************************************************************
+  Filename:       bench_sim.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Broadcast flood over a simulated network of 200 nodes.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Runs the broadcast flood of sim_flood.h over 200 nodes on a grid, each with its own OSAL,
+ *  NV and ZMAC (sim_host.h), and reports how much faster than real time it runs, with the
+ *  reach and latency of the floods. Each run is a fork()ed child, as the nodes can only be
+ *  started once per process. Checks that two runs from the same seed replay event for
+ *  event and that another seed does not, that what every node counted adds up to what the
+ *  channel model delivered, so that no node saw another's RAM, and that each node's NV
+ *  holds its own address.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+
+#include "bench.h"
+#include "sim_flood.h"
+#include "sim_host.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_NODES            200
+#define BENCH_GRID_COLS        20
+#define BENCH_GRID_RANGE       2
+#define BENCH_GRID_LOSS        10      // Percent of frames in range lost
+
+#define BENCH_PERIOD_MS        500
+#define BENCH_RADIUS           16
+#define BENCH_SETTLE_MS        2000    // Run on after the last flood
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// What a run sends back to the harness
+typedef struct
+{
+  simStats_t sim;
+  simFloodStats_t nodes;               // Sum over the nodes
+  uint32 nvOk;                         // Nodes whose NV holds their own address
+  uint32 simMs;
+  unsigned long long wallNs;
+} benchRun_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+simFloodCfg_t simFloodCfg;
+
+/*********************************************************************
+ * @fn      benchSimRun
+ *
+ * @brief   Runs the network from a seed in a child, and collects the results.
+ *
+ * @param   seed - seed of the run
+ *          pRun - where to put the results
+ *
+ * @return  none
+ */
+static void benchSimRun( uint32 seed, benchRun_t *pRun )
+{
+  int fd[2];
+  int status;
+  pid_t pid;
+
+  BENCH_CHECK( pipe( fd ) == 0 );
+  fflush( stdout );
+
+  pid = fork();
+  BENCH_CHECK( pid >= 0 );
+  if ( pid == 0 )
+  {
+    benchRun_t run;
+    simFloodStats_t stats;
+    unsigned long long t0;
+    uint16 addr;
+    uint8 node;
+
+    osal_memset( &run, 0, sizeof( run ) );
+    run.simMs = (uint32)simFloodCfg.floods * simFloodCfg.period + BENCH_SETTLE_MS;
+
+    simGridInit( BENCH_GRID_COLS, BENCH_GRID_RANGE, BENCH_GRID_LOSS );
+    t0 = benchNow();
+    simInit( BENCH_NODES, simGridLink, seed );
+    simRun( run.simMs );
+    run.wallNs = benchNow() - t0;
+    run.sim = simStats;
+
+    for ( node = 0; node < BENCH_NODES; node++ )
+    {
+      simSelect( node );
+      simFloodGetStats( &stats );
+      run.nodes.indications += stats.indications;
+      run.nodes.floods += stats.floods;
+      run.nodes.replies += stats.replies;
+      run.nodes.confirms += stats.confirms;
+      run.nodes.noAcks += stats.noAcks;
+      run.nodes.latencySum += stats.latencySum;
+      if ( stats.latencyMax > run.nodes.latencyMax )
+      {
+        run.nodes.latencyMax = stats.latencyMax;
+      }
+
+      if ( (osal_nv_read( SIM_NV_ADDR, 0, sizeof( addr ), &addr ) == SUCCESS) &&
+           (addr == SIM_NODE_ADDR( node )) )
+      {
+        run.nvOk++;
+      }
+    }
+
+    BENCH_CHECK( write( fd[1], &run, sizeof( run ) ) == (ssize_t)sizeof( run ) );
+    _exit( 0 );
+  }
+
+  close( fd[1] );
+  BENCH_CHECK( read( fd[0], pRun, sizeof( *pRun ) ) == (ssize_t)sizeof( *pRun ) );
+  close( fd[0] );
+  BENCH_CHECK( waitpid( pid, &status, 0 ) == pid );
+  BENCH_CHECK( WIFEXITED( status ) && (WEXITSTATUS( status ) == 0) );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs the flood three times, twice from one seed, reports and checks the runs.
+ */
+int main( int argc, char **argv )
+{
+  benchRun_t run;
+  benchRun_t replay;
+  benchRun_t other;
+  double heard;
+
+  benchInit( argc, argv );
+
+  simFloodCfg.period = BENCH_PERIOD_MS;
+  simFloodCfg.floods = (uint16)benchIters( 1000 );
+  simFloodCfg.radius = BENCH_RADIUS;
+
+  benchSimRun( 1, &run );
+  benchSimRun( 1, &replay );
+  benchSimRun( 2, &other );
+
+  heard = (double)run.nodes.floods / ((double)(BENCH_NODES - 1) * simFloodCfg.floods);
+
+  benchValue( "nodes", BENCH_NODES, "" );
+  benchValue( "simulated time", run.simMs / 1000.0, "s" );
+  benchValue( "speed-up on real time", (run.simMs * 1e6) / (double)run.wallNs, "x" );
+  benchReport( "simulation event", run.sim.events, run.wallNs );
+  benchValue( "frames on air per flood",
+              (double)run.sim.transmissions / simFloodCfg.floods, "" );
+  benchValue( "nodes reached per flood", heard * 100, "%" );
+  benchValue( "mean flood latency",
+              (double)run.nodes.latencySum / (run.nodes.floods ? run.nodes.floods : 1), "ms" );
+  benchValue( "max flood latency", run.nodes.latencyMax, "ms" );
+  benchValue( "replies confirmed MAC_NO_ACK", run.sim.noAcks, "" );
+
+  // Same seed, same run: every event at the same time; another seed differs.
+  BENCH_CHECK( run.sim.digest == replay.sim.digest );
+  BENCH_CHECK( memcmp( &run.sim, &replay.sim, sizeof( run.sim ) ) == 0 );
+  BENCH_CHECK( memcmp( &run.nodes, &replay.nodes, sizeof( run.nodes ) ) == 0 );
+  BENCH_CHECK( run.sim.digest != other.sim.digest );
+
+  // What the nodes counted, each in its own RAM, adds up to what the channel did.
+  BENCH_CHECK( run.sim.heapDrops == 0 );
+  BENCH_CHECK( run.nodes.indications == run.sim.indications );
+  BENCH_CHECK( run.nodes.confirms == run.sim.requests );
+  BENCH_CHECK( run.nodes.noAcks == run.sim.noAcks );
+  BENCH_CHECK( run.nodes.replies + run.sim.noAcks == run.nodes.floods );
+  BENCH_CHECK( run.nvOk == BENCH_NODES );
+
+  // A flood relayed by every node reaches nearly all of them through a 10% loss.
+  BENCH_CHECK( heard > 0.95 );
+
+  printf( "%-40s %10s\n", "replay, isolation and reach", "ok" );
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
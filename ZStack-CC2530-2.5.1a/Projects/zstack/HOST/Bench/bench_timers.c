@@ -0,0 +1,270 @@
+/**************************************************************************************************
+  Filename:       bench_timers.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Compares the OSAL timer backends at 10, 100 and 1000 timers.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Compares the OSAL timer backends at 10, 100 and 1000 active timers. The same source is
+ *  built against the delta-list backend (bench_timers) and the legacy unsorted list
+ *  (bench_timers_list, OSAL_TIMERS_DELTA_LIST=FALSE). Timers are reload timers of 100 to
+ *  5000 msecs spread over the event bits of BENCH_TASK_CNT tasks, and the virtual clock
+ *  ticks every 320 usecs like the MAC backoff timer, so the expiries are checked exactly.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "hal_mcu.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_TIMER_MAX        1000
+#define BENCH_EVT_CNT          15      // Event bits per task, below SYS_EVENT_MSG
+#define BENCH_TASK_CNT         72      // Enough tasks for BENCH_TIMER_MAX timers
+
+#define BENCH_PERIOD_MIN       100
+#define BENCH_PERIOD_SPAN      4900
+
+#if defined OSAL_TIMERS_DELTA_LIST && !OSAL_TIMERS_DELTA_LIST
+#define BENCH_BACKEND          "list"
+#else
+#define BENCH_BACKEND          "delta"
+#endif
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define BENCH_TASKS_8   benchTimerTask, benchTimerTask, benchTimerTask, benchTimerTask, \
+                        benchTimerTask, benchTimerTask, benchTimerTask, benchTimerTask
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTimerTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[BENCH_TASK_CNT] = {
+  BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8,
+  BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8, BENCH_TASKS_8
+};
+
+const uint8 tasksCnt = BENCH_TASK_CNT;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 benchPeriod[BENCH_TIMER_MAX];
+static uint32 benchExpired;
+static uint32 benchDispatched;
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark tasks.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTimerTask
+ *
+ * @brief   Counts the timer events that expired.
+ */
+static uint16 benchTimerTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  benchDispatched++;
+
+  while ( events )
+  {
+    events &= events - 1;
+    benchExpired++;
+  }
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchActive
+ *
+ * @brief   Counts the running timers of the benchmark tasks. Unlike
+ *          osal_timer_num_active(), the count does not wrap at 256.
+ */
+static uint16 benchActive( void )
+{
+  uint16 cnt = 0;
+  uint8 task;
+  uint8 evt;
+
+  for ( task = 0; task < BENCH_TASK_CNT; task++ )
+  {
+    for ( evt = 0; evt < BENCH_EVT_CNT; evt++ )
+    {
+      if ( osal_get_timeoutEx( task, BV( evt ) ) != 0 )
+      {
+        cnt++;
+      }
+    }
+  }
+
+  return ( cnt );
+}
+
+/*********************************************************************
+ * @fn      benchRun
+ *
+ * @brief   Times starting, ticking, finding and stopping 'cnt' timers.
+ */
+static void benchRun( uint16 cnt )
+{
+  char name[48];
+  uint32 msecs = benchIters( 20000 );
+  uint32 ticks = 0;
+  uint32 expect = 0;
+  unsigned long long t0;
+  uint32 start;
+  uint16 i;
+
+  benchRandSeed( 1 );
+  benchExpired = 0;
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    benchPeriod[i] = BENCH_PERIOD_MIN + (benchRand() % BENCH_PERIOD_SPAN);
+    BENCH_CHECK( osal_start_reload_timer( i / BENCH_EVT_CNT, BV( i % BENCH_EVT_CNT ),
+                                          benchPeriod[i] ) == SUCCESS );
+  }
+  sprintf( name, "%s, %4u timers: start", BENCH_BACKEND, cnt );
+  benchReport( name, cnt, benchNow() - t0 );
+  BENCH_CHECK( benchActive() == cnt );
+
+  start = osal_GetSystemClock();
+  t0 = benchNow();
+  while ( osal_GetSystemClock() - start < msecs )
+  {
+    uint32 before;
+
+    halHostClockAdvance( 320 );
+    do
+    {
+      before = benchDispatched;
+      osal_run_system();
+    } while ( benchDispatched != before );
+    ticks++;
+  }
+  sprintf( name, "%s, %4u timers: tick", BENCH_BACKEND, cnt );
+  benchReport( name, ticks, benchNow() - t0 );
+
+  for ( i = 0; i < cnt; i++ )
+  {
+    expect += msecs / benchPeriod[i];
+  }
+  BENCH_CHECK( benchExpired == expect );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint16 j = benchRand() % cnt;
+
+    BENCH_CHECK( osal_get_timeoutEx( j / BENCH_EVT_CNT, BV( j % BENCH_EVT_CNT ) ) != 0 );
+  }
+  sprintf( name, "%s, %4u timers: find", BENCH_BACKEND, cnt );
+  benchReport( name, cnt, benchNow() - t0 );
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    uint16 j = cnt - 1 - i;
+
+    BENCH_CHECK( osal_stop_timerEx( j / BENCH_EVT_CNT, BV( j % BENCH_EVT_CNT ) ) == SUCCESS );
+  }
+  sprintf( name, "%s, %4u timers: stop", BENCH_BACKEND, cnt );
+  benchReport( name, cnt, benchNow() - t0 );
+
+  // The list backend frees stopped timers on the next tick.
+  halHostClockAdvance( 2000 );
+  osal_run_system();
+  BENCH_CHECK( osal_timer_num_active() == 0 );
+  BENCH_CHECK( benchActive() == 0 );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs the benchmark at each timer count.
+ */
+int main( int argc, char **argv )
+{
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  benchRun( 10 );
+  benchRun( 100 );
+  benchRun( BENCH_TIMER_MAX );
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
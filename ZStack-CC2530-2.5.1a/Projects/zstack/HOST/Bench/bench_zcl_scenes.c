@@ -0,0 +1,255 @@
+/**************************************************************************************************
+  Filename:       bench_zcl_scenes.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks and times the NV records of the ZCL scene table.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Checks that the scene table is restored from every NV record slot, including the records
+ *  behind a slot whose record was never created, and that a scene whose NV record cannot be
+ *  created is not added. Then times adding and removing a scene, with the flash writes each
+ *  costs.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "zcl.h"
+#include "zcl_general.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define BENCH_EP               8
+#define BENCH_FILL_ID          0x0F00  // First of the items that fill NV
+#define BENCH_FILL_LEN         200
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// An NV record of a scene, as zcl_general.c stores it
+typedef struct
+{
+  uint8                     endpoint;
+  zclGeneral_Scene_t        scene;
+} benchSceneNVItem_t;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 benchTask( uint8 task_id, uint16 events );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { benchTask };
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static zclGeneral_AppCallbacks_t benchCBs;
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words of the benchmark task.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+}
+
+/*********************************************************************
+ * @fn      benchTask
+ *
+ * @brief   Unused.
+ */
+static uint16 benchTask( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+  (void)events;
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      benchScene
+ *
+ * @brief   Fills in a scene of group 0.
+ */
+static void benchScene( zclGeneral_Scene_t *pScene, uint8 sceneID )
+{
+  osal_memset( pScene, 0, sizeof( zclGeneral_Scene_t ) );
+  pScene->ID = sceneID;
+  pScene->transTime = sceneID;
+  pScene->extLen = 2;
+  pScene->extField[0] = sceneID;
+}
+
+/*********************************************************************
+ * @fn      benchRestore
+ *
+ * @brief   Creates the NV records of slots 2 and 4 only, then has the scene table
+ *          restored from them.
+ */
+static void benchRestore( void )
+{
+  benchSceneNVItem_t item;
+
+  item.endpoint = BENCH_EP;
+  benchScene( &item.scene, 2 );
+  BENCH_CHECK( osal_nv_item_init( ZCD_NV_SCENE_DATA_START + 2, sizeof( item ), &item ) == NV_ITEM_UNINIT );
+  benchScene( &item.scene, 4 );
+  BENCH_CHECK( osal_nv_item_init( ZCD_NV_SCENE_DATA_START + 4, sizeof( item ), &item ) == NV_ITEM_UNINIT );
+
+  // The first registration restores the scene table
+  BENCH_CHECK( zclGeneral_RegisterCmdCallbacks( BENCH_EP, &benchCBs ) == ZSuccess );
+
+  BENCH_CHECK( zclGeneral_CountAllScenes() == 2 );
+  BENCH_CHECK( zclGeneral_FindScene( BENCH_EP, 0, 2 ) != NULL );
+  BENCH_CHECK( zclGeneral_FindScene( BENCH_EP, 0, 4 ) != NULL );
+  printf( "%-40s %10s\n", "scenes: restore past missing records", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchNvFull
+ *
+ * @brief   Fills NV, checks a scene is not added without its NV record, then frees NV and
+ *          checks the same scene is added.
+ */
+static void benchNvFull( void )
+{
+  static uint8 fill[BENCH_FILL_LEN];
+  zclGeneral_Scene_t scene;
+  uint16 id = BENCH_FILL_ID;
+
+  while ( osal_nv_item_init( id, BENCH_FILL_LEN, fill ) == NV_ITEM_UNINIT )
+  {
+    id++;
+  }
+  while ( osal_nv_item_init( id, 1, fill ) == NV_ITEM_UNINIT )
+  {
+    id++;
+  }
+
+  benchScene( &scene, 9 );
+  BENCH_CHECK( zclGeneral_AddScene( BENCH_EP, &scene ) == NV_OPER_FAILED );
+  BENCH_CHECK( zclGeneral_FindScene( BENCH_EP, 0, 9 ) == NULL );
+  BENCH_CHECK( zclGeneral_CountAllScenes() == 2 );
+
+  while ( id-- > BENCH_FILL_ID )
+  {
+    osal_nv_delete( id, osal_nv_item_len( id ) );
+  }
+
+  BENCH_CHECK( zclGeneral_AddScene( BENCH_EP, &scene ) == ZSuccess );
+  BENCH_CHECK( zclGeneral_CountAllScenes() == 3 );
+  BENCH_CHECK( zclGeneral_RemoveScene( BENCH_EP, 0, 9 ) );
+  printf( "%-40s %10s\n", "scenes: no add without an NV record", "ok" );
+}
+
+/*********************************************************************
+ * @fn      benchAddRemove
+ *
+ * @brief   Times adding and removing a scene with the other slots in use.
+ */
+static void benchAddRemove( void )
+{
+  uint32 cnt = benchIters( 200000 );
+  zclGeneral_Scene_t scene;
+  unsigned long long t0;
+  uint32 writes;
+  uint32 i;
+
+  benchScene( &scene, 20 );
+  writes = halHostFlashWrites();
+
+  t0 = benchNow();
+  for ( i = 0; i < cnt; i++ )
+  {
+    BENCH_CHECK( zclGeneral_AddScene( BENCH_EP, &scene ) == ZSuccess );
+    zclGeneral_RemoveScene( BENCH_EP, 0, 20 );
+  }
+  benchReport( "scenes: add + remove", cnt, benchNow() - t0 );
+  benchValue( "scenes: flash writes per add + remove",
+              (double)(halHostFlashWrites() - writes) / cnt, "writes" );
+}
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Runs the checks and timings on an empty NV image.
+ */
+int main( int argc, char **argv )
+{
+  benchInit( argc, argv );
+
+  halHostRandSeed = 1;
+  InitBoard( OB_COLD );
+  osal_init_system();
+
+  halHostFlashReset();
+  osal_nv_init( NULL );
+
+  benchRestore();
+  benchNvFull();
+  benchAddRemove();
+
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,106 @@
+/**************************************************************************************************
+  Filename:       sim_flood.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Flood application of the host network simulation.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef SIM_FLOOD_H
+#define SIM_FLOOD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ *  The application that each node of the flood simulation runs, as the NWK task over ZMAC.
+ *  Node 0 originates a broadcast flood every period. A node that hears a flood for the first
+ *  time relays it, after a random jitter, while its radius lasts, and unicasts a reply to the
+ *  neighbour it heard it from.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Settings of the run, shared by every node
+typedef struct
+{
+  uint16 period;          // Milliseconds between floods
+  uint16 floods;          // Floods that node 0 originates
+  uint8  radius;          // Hops a flood is relayed
+} simFloodCfg_t;
+
+// What a node has seen since it started
+typedef struct
+{
+  uint32 indications;     // Data indications from ZMAC
+  uint32 floods;          // Floods heard, once each
+  uint32 replies;         // Unicast replies received
+  uint32 confirms;        // Data confirms from ZMAC
+  uint32 noAcks;          // Of which MAC_NO_ACK
+  uint32 latencySum;      // Milliseconds from origin to first hearing, over the floods
+  uint32 latencyMax;
+} simFloodStats_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+extern simFloodCfg_t simFloodCfg;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Copies the counts of the current node (simSelect).
+ */
+extern void simFloodGetStats( simFloodStats_t *pStats );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_FLOOD_H */
@@ -0,0 +1,305 @@
+/**************************************************************************************************
+  Filename:       sim_flood_node.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Flood application of the host network simulation, run by every node.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  The flood application of bench_sim (sim_flood.h). Everything in this file is per node: the
+ *  simulation build gives each node its own copy of the RAM of the *_node.c objects.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "ZMAC.h"
+
+#include "sim_flood.h"
+#include "sim_host.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define SIM_FLOOD_EVT          0x0001  // Node 0 originates the next flood
+#define SIM_RELAY_EVT          0x0002  // The pending flood is relayed
+
+#define SIM_RELAY_JITTER_MS    8       // Relays wait 1 to this many msec
+
+// The frames carry a NWK header, so that ZMAC passes them on: frame control (data frame,
+// protocol version 2), destination, source, radius and sequence, then the flood number and
+// the msec it was originated at.
+#define SIM_FRAME_FC           0x08
+#define SIM_FRAME_DST          2
+#define SIM_FRAME_SRC          4
+#define SIM_FRAME_RADIUS       6
+#define SIM_FRAME_SEQ          7
+#define SIM_FRAME_FLOOD        8
+#define SIM_FRAME_ORIGIN       10
+#define SIM_FRAME_LEN          24
+
+extern uint8 NWK_TaskID;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16 simFloodTask( uint8 task_id, uint16 events );
+static void simFloodSend( uint16 dstAddr, uint8 *pFrame );
+static void simFloodRx( macMcpsDataInd_t *pInd );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const pTaskEventHandlerFn tasksArr[] = { simFloodTask };
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 simFloodAddr;
+static uint16 simFloodLast;            // Last flood heard or originated
+static uint8 simFloodHandle;
+static uint8 simRelayFrame[SIM_FRAME_LEN];
+static uint8 simRelayPending;
+static simFloodStats_t simFloodStats;
+
+/*********************************************************************
+ * @fn      osalInitTasks
+ *
+ * @brief   Allocates the event words and starts the flood task, as the NWK task, so that
+ *          ZMAC sends it the data indications and confirms. Node 0 starts flooding.
+ *
+ * @param   void
+ *
+ * @return  none
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt );
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt) );
+
+  NWK_TaskID = 0;
+  ZMacGetReq( ZMacShortAddress, (uint8 *)&simFloodAddr );
+
+  if ( (simFloodAddr == SIM_NODE_ADDR( 0 )) && (simFloodCfg.floods != 0) )
+  {
+    osal_start_timerEx( NWK_TaskID, SIM_FLOOD_EVT, simFloodCfg.period );
+  }
+}
+
+/*********************************************************************
+ * @fn      simFloodGetStats
+ *
+ * @brief   Copies the counts of the current node.
+ *
+ * @param   pStats - where to put them
+ *
+ * @return  none
+ */
+void simFloodGetStats( simFloodStats_t *pStats )
+{
+  *pStats = simFloodStats;
+}
+
+/*********************************************************************
+ * @fn      simFloodTask
+ *
+ * @brief   Takes the MAC messages, originates floods on node 0 and relays them.
+ *
+ * @param   task_id - the task
+ *          events - events to process
+ *
+ * @return  events not processed
+ */
+static uint16 simFloodTask( uint8 task_id, uint16 events )
+{
+  uint8 *pMsg;
+
+  if ( events & SYS_EVENT_MSG )
+  {
+    while ( (pMsg = osal_msg_receive( task_id )) != NULL )
+    {
+      macEventHdr_t *pHdr = (macEventHdr_t *)pMsg;
+
+      if ( pHdr->event == MAC_MCPS_DATA_IND )
+      {
+        simFloodRx( (macMcpsDataInd_t *)pMsg );
+      }
+      else if ( pHdr->event == MAC_MCPS_DATA_CNF )
+      {
+        simFloodStats.confirms++;
+        if ( pHdr->status == MAC_NO_ACK )
+        {
+          simFloodStats.noAcks++;
+        }
+      }
+      osal_msg_deallocate( pMsg );
+    }
+
+    return ( events ^ SYS_EVENT_MSG );
+  }
+
+  if ( events & SIM_FLOOD_EVT )
+  {
+    uint8 frame[SIM_FRAME_LEN];
+    uint32 now = osal_GetSystemClock();
+
+    osal_memset( frame, 0, SIM_FRAME_LEN );
+    simFloodLast++;
+    frame[SIM_FRAME_RADIUS] = simFloodCfg.radius;
+    frame[SIM_FRAME_FLOOD] = LO_UINT16( simFloodLast );
+    frame[SIM_FRAME_FLOOD + 1] = HI_UINT16( simFloodLast );
+    osal_buffer_uint32( frame + SIM_FRAME_ORIGIN, now );
+    simFloodSend( MAC_SHORT_ADDR_BROADCAST, frame );
+
+    if ( simFloodLast < simFloodCfg.floods )
+    {
+      osal_start_timerEx( task_id, SIM_FLOOD_EVT, simFloodCfg.period );
+    }
+
+    return ( events ^ SIM_FLOOD_EVT );
+  }
+
+  if ( events & SIM_RELAY_EVT )
+  {
+    if ( simRelayPending )
+    {
+      simRelayPending = FALSE;
+      simFloodSend( MAC_SHORT_ADDR_BROADCAST, simRelayFrame );
+    }
+
+    return ( events ^ SIM_RELAY_EVT );
+  }
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      simFloodSend
+ *
+ * @brief   Sends a frame from this node through ZMAC: a broadcast, or a unicast with an ack.
+ *
+ * @param   dstAddr - destination, or MAC_SHORT_ADDR_BROADCAST
+ *          pFrame - SIM_FRAME_LEN bytes, the header is filled in here
+ *
+ * @return  none
+ */
+static void simFloodSend( uint16 dstAddr, uint8 *pFrame )
+{
+  ZMacDataReq_t req;
+
+  pFrame[0] = SIM_FRAME_FC;
+  pFrame[1] = 0;
+  pFrame[SIM_FRAME_DST] = LO_UINT16( dstAddr );
+  pFrame[SIM_FRAME_DST + 1] = HI_UINT16( dstAddr );
+  pFrame[SIM_FRAME_SRC] = LO_UINT16( simFloodAddr );
+  pFrame[SIM_FRAME_SRC + 1] = HI_UINT16( simFloodAddr );
+  pFrame[SIM_FRAME_SEQ] = simFloodHandle;
+
+  osal_memset( &req, 0, sizeof( req ) );
+  req.DstAddr.addrMode = Addr16Bit;
+  req.DstAddr.addr.shortAddr = dstAddr;
+  req.DstPANId = SIM_PAN_ID;
+  req.SrcAddrMode = SADDR_MODE_SHORT;
+  req.Handle = simFloodHandle++;
+  req.TxOptions = (dstAddr == MAC_SHORT_ADDR_BROADCAST) ? 0 : MAC_TXOPTION_ACK;
+  req.msduLength = SIM_FRAME_LEN;
+  req.msdu = pFrame;
+
+  (void)ZMacDataReq( &req );
+}
+
+/*********************************************************************
+ * @fn      simFloodRx
+ *
+ * @brief   Counts a received frame. A flood heard for the first time is replied to, and
+ *          relayed after a jitter while its radius lasts.
+ *
+ * @param   pInd - the data indication
+ *
+ * @return  none
+ */
+static void simFloodRx( macMcpsDataInd_t *pInd )
+{
+  uint8 *pFrame = pInd->msdu.p;
+  uint16 flood;
+  uint32 latency;
+
+  simFloodStats.indications++;
+
+  if ( BUILD_UINT16( pFrame[SIM_FRAME_DST], pFrame[SIM_FRAME_DST + 1] ) !=
+       MAC_SHORT_ADDR_BROADCAST )
+  {
+    simFloodStats.replies++;
+    return;
+  }
+
+  flood = BUILD_UINT16( pFrame[SIM_FRAME_FLOOD], pFrame[SIM_FRAME_FLOOD + 1] );
+  if ( flood <= simFloodLast )
+  {
+    return;  // Heard it already
+  }
+  simFloodLast = flood;
+  simFloodStats.floods++;
+
+  latency = osal_GetSystemClock() - osal_build_uint32( pFrame + SIM_FRAME_ORIGIN, 4 );
+  simFloodStats.latencySum += latency;
+  if ( latency > simFloodStats.latencyMax )
+  {
+    simFloodStats.latencyMax = latency;
+  }
+
+  if ( (pFrame[SIM_FRAME_RADIUS] > 1) && !simRelayPending )
+  {
+    osal_memcpy( simRelayFrame, pFrame, SIM_FRAME_LEN );
+    simRelayFrame[SIM_FRAME_RADIUS]--;
+    simRelayPending = TRUE;
+    osal_start_timerEx( NWK_TaskID, SIM_RELAY_EVT, 1 + (Onboard_rand() % SIM_RELAY_JITTER_MS) );
+  }
+
+  osal_memset( pFrame + SIM_FRAME_DST, 0, SIM_FRAME_LEN - SIM_FRAME_DST );
+  simFloodSend( pInd->mac.srcAddr.addr.shortAddr, pFrame );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,769 @@
+/**************************************************************************************************
+  Filename:       sim_host.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Discrete-event simulation of many nodes on the host: event queue, channel model and node switching.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Timers.h"
+#include "OnBoard.h"
+#include "ZMAC.h"
+#include "hal_mcu.h"
+
+#include "sim_host.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// 2.4 GHz O-QPSK PHY and the MAC timing of IEEE 802.15.4.
+#define SIM_BYTE_US             32      // 250 kbit/s
+#define SIM_BACKOFF_US          320     // aUnitBackoffPeriod
+#define SIM_BACKOFF_CNT         8       // Backoff periods drawn from, 2^macMinBE
+#define SIM_PHY_HDR_LEN         6       // Preamble, SFD and frame length
+#define SIM_MAC_HDR_LEN         9       // Frame control, DSN, PAN ID and two short addresses
+#define SIM_MAC_FCS_LEN         2
+#define SIM_ACK_LEN             5
+#define SIM_TURNAROUND_US       192     // aTurnaroundTime
+#define SIM_ACK_WAIT_US         864     // macAckWaitDuration
+
+// Longest a node is left without a wake-up, so that the milliseconds that osalTimeUpdate()
+// catches up with on it fit in 16 bits.
+#define SIM_WAKE_MAX_MS         30000
+
+#define SIM_EVT_WAKE            0       // A node's next timer is due
+#define SIM_EVT_IND             1       // A frame has been received by a node
+#define SIM_EVT_CNF             2       // A node's data request is done
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// A frame on air, shared by the events that deliver and confirm it
+typedef struct
+{
+  macMcpsDataReq_t *pReq;               // Sender's request, freed by ZMAC on the confirm
+  uint8 *msdu;                          // Copy of the MSDU, after this header
+  uint16 refCnt;                        // Events still to run on the frame
+  uint16 dstAddr;
+  uint8 src;
+  uint8 handle;
+  uint8 dsn;
+  uint8 len;
+} simFrame_t;
+
+typedef struct
+{
+  unsigned long long time;
+  uint32 seq;                           // Order of events at the same time
+  uint32 gen;                           // Wake-up generation of the node
+  simFrame_t *pFrame;
+  uint8 type;
+  uint8 node;
+  uint8 status;                         // MAC status of a confirm
+  uint8 lqi;                            // LQI of an indication or of a confirm's ack
+  uint8 retries;                        // Retries of a confirm
+} simEvent_t;
+
+typedef struct
+{
+  unsigned long long txFree;            // When the radio is done with the last frame
+  unsigned long long wakeTime;          // When the node's current wake-up is due
+  uint32 wakeGen;                       // Generation of the node's current wake-up
+  uint8 dsn;
+} simNode_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+simStats_t simStats;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static simNode_t simNodes[SIM_NODE_MAX];
+static uint8 simNodeCnt;
+static uint8 simCur;
+static simLink_t simLinkFn;
+static uint32 simRandState = 1;
+
+// Pending events, a binary min-heap on time and sequence.
+static simEvent_t *simEvents;
+static uint32 simEventCnt;
+static uint32 simEventMax;
+static uint32 simEventSeq;
+
+static uint8 simGridCols = 1;
+static uint8 simGridRange = 1;
+static uint8 simGridLoss;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void simDigest( const void *pData, uint8 len );
+static void simAdvance( unsigned long long time );
+static uint8 simEarlier( simEvent_t *pA, simEvent_t *pB );
+static void simPush( simEvent_t *pEvt );
+static void simPop( simEvent_t *pEvt );
+static void simSchedule( uint8 type, uint8 node, unsigned long long time, simFrame_t *pFrame,
+                         uint8 status, uint8 lqi, uint8 retries );
+static uint8 simReady( void );
+static void simSettle( void );
+static void simDataReq( macMcpsDataReq_t *pReq );
+static void simDeliver( simEvent_t *pEvt );
+static void simConfirm( simEvent_t *pEvt );
+
+/*********************************************************************
+ * @fn      simRand
+ *
+ * @brief   xorshift32 on the seed of the run, apart from the nodes' own Onboard_rand().
+ *
+ * @param   none
+ *
+ * @return  random number
+ */
+uint16 simRand( void )
+{
+  simRandState ^= simRandState << 13;
+  simRandState ^= simRandState >> 17;
+  simRandState ^= simRandState << 5;
+
+  return ( (uint16)(simRandState >> 16) );
+}
+
+/*********************************************************************
+ * @fn      simDigest
+ *
+ * @brief   Folds bytes into the digest of the run, FNV-1a.
+ *
+ * @param   pData - the bytes
+ *          len - how many
+ *
+ * @return  none
+ */
+static void simDigest( const void *pData, uint8 len )
+{
+  const uint8 *pByte = pData;
+
+  while ( len-- )
+  {
+    simStats.digest = (simStats.digest ^ *pByte++) * 16777619UL;
+  }
+}
+
+/*********************************************************************
+ * @fn      simAdvance
+ *
+ * @brief   Moves the virtual clock forward to the given time.
+ *
+ * @param   time - microseconds, not before the clock
+ *
+ * @return  none
+ */
+static void simAdvance( unsigned long long time )
+{
+  while ( time > halHostClockUs64() )
+  {
+    unsigned long long step = time - halHostClockUs64();
+
+    halHostClockAdvance( (step > 0xFFFFFFFFUL) ? 0xFFFFFFFFUL : (uint32)step );
+  }
+}
+
+/*********************************************************************
+ * @fn      simEarlier
+ *
+ * @brief   Orders events by time, then by when they were scheduled.
+ *
+ * @param   pA, pB - the events
+ *
+ * @return  TRUE if pA runs before pB
+ */
+static uint8 simEarlier( simEvent_t *pA, simEvent_t *pB )
+{
+  if ( pA->time != pB->time )
+  {
+    return ( pA->time < pB->time );
+  }
+
+  return ( pA->seq < pB->seq );
+}
+
+/*********************************************************************
+ * @fn      simPush
+ *
+ * @brief   Adds an event to the heap, growing it as needed.
+ *
+ * @param   pEvt - the event, its sequence is set here
+ *
+ * @return  none
+ */
+static void simPush( simEvent_t *pEvt )
+{
+  uint32 idx;
+
+  if ( simEventCnt == simEventMax )
+  {
+    simEventMax = (simEventMax != 0) ? (simEventMax * 2) : 1024;
+    simEvents = realloc( simEvents, simEventMax * sizeof( simEvent_t ) );
+    if ( simEvents == NULL )
+    {
+      abort();
+    }
+  }
+
+  pEvt->seq = simEventSeq++;
+
+  // Sift up from the new leaf.
+  for ( idx = simEventCnt++; idx > 0; idx = (idx - 1) / 2 )
+  {
+    simEvent_t *pParent = simEvents + ((idx - 1) / 2);
+
+    if ( !simEarlier( pEvt, pParent ) )
+    {
+      break;
+    }
+    simEvents[idx] = *pParent;
+  }
+  simEvents[idx] = *pEvt;
+}
+
+/*********************************************************************
+ * @fn      simPop
+ *
+ * @brief   Takes the earliest event off the heap, which must not be empty.
+ *
+ * @param   pEvt - where to put the event
+ *
+ * @return  none
+ */
+static void simPop( simEvent_t *pEvt )
+{
+  simEvent_t *pLast;
+  uint32 idx = 0;
+
+  *pEvt = simEvents[0];
+  pLast = simEvents + --simEventCnt;
+
+  // Sift the last leaf down from the root.
+  for ( ;; )
+  {
+    uint32 child = (idx * 2) + 1;
+
+    if ( child >= simEventCnt )
+    {
+      break;
+    }
+    if ( (child + 1 < simEventCnt) && simEarlier( simEvents + child + 1, simEvents + child ) )
+    {
+      child++;
+    }
+    if ( !simEarlier( simEvents + child, pLast ) )
+    {
+      break;
+    }
+    simEvents[idx] = simEvents[child];
+    idx = child;
+  }
+  simEvents[idx] = *pLast;
+}
+
+/*********************************************************************
+ * @fn      simSchedule
+ *
+ * @brief   Schedules an event, holding its frame until it has run.
+ *
+ * @param   type - SIM_EVT_WAKE, SIM_EVT_IND or SIM_EVT_CNF
+ *          node - node it runs on
+ *          time - when it runs, in microseconds
+ *          pFrame - frame of an indication or confirm, else NULL
+ *          status, lqi, retries - of a confirm, and the LQI of an indication
+ *
+ * @return  none
+ */
+static void simSchedule( uint8 type, uint8 node, unsigned long long time, simFrame_t *pFrame,
+                         uint8 status, uint8 lqi, uint8 retries )
+{
+  simEvent_t evt;
+
+  evt.time = time;
+  evt.gen = simNodes[node].wakeGen;
+  evt.pFrame = pFrame;
+  evt.type = type;
+  evt.node = node;
+  evt.status = status;
+  evt.lqi = lqi;
+  evt.retries = retries;
+
+  if ( pFrame != NULL )
+  {
+    pFrame->refCnt++;
+  }
+
+  simPush( &evt );
+}
+
+/*********************************************************************
+ * @fn      simReady
+ *
+ * @brief   Checks the current node for tasks with events to run.
+ *
+ * @param   none
+ *
+ * @return  TRUE if a task is ready
+ */
+static uint8 simReady( void )
+{
+  uint8 idx;
+
+  for ( idx = 0; idx < tasksCnt; idx++ )
+  {
+    if ( tasksEvents[idx] != 0 )
+    {
+      return ( TRUE );
+    }
+  }
+
+  return ( FALSE );
+}
+
+/*********************************************************************
+ * @fn      simSettle
+ *
+ * @brief   Runs the current node until it has nothing ready, then schedules it to wake up
+ *          for its next timer.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void simSettle( void )
+{
+  simNode_t *pNode = simNodes + simCur;
+  unsigned long long wake;
+  uint16 timeout;
+
+  do
+  {
+    osal_run_system();
+  } while ( simReady() );
+
+  timeout = osal_next_timeout();
+  if ( (timeout == 0) || (timeout > SIM_WAKE_MAX_MS) )
+  {
+    timeout = SIM_WAKE_MAX_MS;
+  }
+  wake = halHostClockUs64() + ((unsigned long long)timeout * 1000);
+
+  if ( wake != pNode->wakeTime )
+  {
+    pNode->wakeTime = wake;
+    pNode->wakeGen++;
+    simSchedule( SIM_EVT_WAKE, simCur, wake, NULL, 0, 0, 0 );
+  }
+}
+
+/*********************************************************************
+ * @fn      simDataReq
+ *
+ * @brief   The channel model at ZMAC: puts the current node's frame on air, after a random
+ *          backoff and once the node's earlier frames are done, and schedules its receptions
+ *          and its confirm. A unicast is sent again, after the ack wait, until a
+ *          transmission reaches the destination or the attempts run out.
+ *
+ * @param   pReq - the data request, which the confirm gives back to ZMAC
+ *
+ * @return  none
+ */
+static void simDataReq( macMcpsDataReq_t *pReq )
+{
+  simNode_t *pNode = simNodes + simCur;
+  simFrame_t *pFrame;
+  unsigned long long air;
+  unsigned long long time;
+  unsigned long long cnfTime;
+  uint8 attempts = 1;
+  uint8 status = MAC_SUCCESS;
+  uint8 cnfLqi = 0;
+  uint8 tries;
+  uint8 dst;
+  uint8 lqi;
+
+  pFrame = malloc( sizeof( simFrame_t ) + pReq->msdu.len );
+  if ( pFrame == NULL )
+  {
+    abort();
+  }
+  pFrame->pReq = pReq;
+  pFrame->msdu = (uint8 *)(pFrame + 1);
+  pFrame->refCnt = 0;
+  pFrame->dstAddr = pReq->mac.dstAddr.addr.shortAddr;
+  pFrame->src = simCur;
+  pFrame->handle = pReq->mac.msduHandle;
+  pFrame->dsn = pNode->dsn++;
+  pFrame->len = pReq->msdu.len;
+  (void)memcpy( pFrame->msdu, pReq->msdu.p, pReq->msdu.len );
+
+  // ZMAC reads the Tx options of the request back from the MAC's own copy.
+  pReq->internal.txOptions = pReq->mac.txOptions;
+  simStats.requests++;
+
+  air = (unsigned long long)(SIM_PHY_HDR_LEN + SIM_MAC_HDR_LEN + pFrame->len + SIM_MAC_FCS_LEN)
+        * SIM_BYTE_US;
+  time = halHostClockUs64();
+  if ( time < pNode->txFree )
+  {
+    time = pNode->txFree;
+  }
+
+  if ( pFrame->dstAddr == MAC_SHORT_ADDR_BROADCAST )
+  {
+    time += (unsigned long long)(simRand() % SIM_BACKOFF_CNT) * SIM_BACKOFF_US + air;
+    simStats.transmissions++;
+
+    for ( dst = 0; dst < simNodeCnt; dst++ )
+    {
+      if ( (dst != simCur) && simLinkFn( simCur, dst, &lqi ) )
+      {
+        simSchedule( SIM_EVT_IND, dst, time, pFrame, 0, lqi, 0 );
+      }
+    }
+    cnfTime = time;
+    tries = 0;
+  }
+  else
+  {
+    if ( pReq->mac.txOptions & MAC_TXOPTION_ACK )
+    {
+      attempts = SIM_TX_ATTEMPTS;
+      status = MAC_NO_ACK;
+    }
+
+    dst = (uint8)pFrame->dstAddr;
+    for ( tries = 0; tries < attempts; tries++ )
+    {
+      if ( tries != 0 )
+      {
+        time += SIM_ACK_WAIT_US;  // No ack for the last attempt
+      }
+      time += (unsigned long long)(simRand() % SIM_BACKOFF_CNT) * SIM_BACKOFF_US + air;
+      simStats.transmissions++;
+
+      if ( (pFrame->dstAddr < simNodeCnt) && (dst != simCur) && simLinkFn( simCur, dst, &lqi ) )
+      {
+        simSchedule( SIM_EVT_IND, dst, time, pFrame, 0, lqi, 0 );
+        if ( attempts > 1 )
+        {
+          time += SIM_TURNAROUND_US + ((SIM_PHY_HDR_LEN + SIM_ACK_LEN) * SIM_BYTE_US);
+          status = MAC_SUCCESS;
+          cnfLqi = lqi;
+        }
+        break;
+      }
+    }
+
+    if ( tries == attempts )
+    {
+      tries--;
+      if ( status == MAC_NO_ACK )
+      {
+        time += SIM_ACK_WAIT_US;
+        simStats.noAcks++;
+      }
+    }
+    cnfTime = time;
+  }
+
+  pNode->txFree = cnfTime;
+  simSchedule( SIM_EVT_CNF, simCur, cnfTime, pFrame, status, cnfLqi, tries );
+}
+
+/*********************************************************************
+ * @fn      simDeliver
+ *
+ * @brief   Gives a received frame to the current node's ZMAC, in a data indication
+ *          allocated from the node's own heap, as the MAC does.
+ *
+ * @param   pEvt - the indication event
+ *
+ * @return  none
+ */
+static void simDeliver( simEvent_t *pEvt )
+{
+  simFrame_t *pFrame = pEvt->pFrame;
+  macMcpsDataInd_t *pInd;
+
+  pInd = (macMcpsDataInd_t *)osal_msg_allocate( sizeof( macMcpsDataInd_t ) + pFrame->len );
+  if ( pInd == NULL )
+  {
+    simStats.heapDrops++;
+    return;
+  }
+
+  osal_memset( pInd, 0, sizeof( macMcpsDataInd_t ) );
+  pInd->hdr.event = MAC_MCPS_DATA_IND;
+  pInd->hdr.status = MAC_SUCCESS;
+  pInd->msdu.p = (uint8 *)(pInd + 1);
+  pInd->msdu.len = pFrame->len;
+  osal_memcpy( pInd->msdu.p, pFrame->msdu, pFrame->len );
+  pInd->mac.srcAddr.addrMode = SADDR_MODE_SHORT;
+  pInd->mac.srcAddr.addr.shortAddr = SIM_NODE_ADDR( pFrame->src );
+  pInd->mac.dstAddr.addrMode = SADDR_MODE_SHORT;
+  pInd->mac.dstAddr.addr.shortAddr = pFrame->dstAddr;
+  pInd->mac.timestamp = (uint32)(pEvt->time / SIM_BACKOFF_US);
+  pInd->mac.srcPanId = SIM_PAN_ID;
+  pInd->mac.dstPanId = SIM_PAN_ID;
+  pInd->mac.mpduLinkQuality = pEvt->lqi;
+  pInd->mac.rssi = (int8)(-90 + (pEvt->lqi / 4));
+  pInd->mac.dsn = pFrame->dsn;
+
+  simStats.indications++;
+  simDigest( &pEvt->time, sizeof( pEvt->time ) );
+  simDigest( &pEvt->node, sizeof( pEvt->node ) );
+  simDigest( &pFrame->src, sizeof( pFrame->src ) );
+  simDigest( pFrame->msdu, pFrame->len );
+
+  MAC_CbackEvent( (macCbackEvent_t *)pInd );
+}
+
+/*********************************************************************
+ * @fn      simConfirm
+ *
+ * @brief   Gives the current node's ZMAC the confirm of its data request.
+ *
+ * @param   pEvt - the confirm event
+ *
+ * @return  none
+ */
+static void simConfirm( simEvent_t *pEvt )
+{
+  macMcpsDataCnf_t cnf;
+
+  osal_memset( &cnf, 0, sizeof( cnf ) );
+  cnf.hdr.event = MAC_MCPS_DATA_CNF;
+  cnf.hdr.status = pEvt->status;
+  cnf.msduHandle = pEvt->pFrame->handle;
+  cnf.pDataReq = pEvt->pFrame->pReq;
+  cnf.timestamp = (uint32)(pEvt->time / SIM_BACKOFF_US);
+  cnf.retries = pEvt->retries;
+  cnf.mpduLinkQuality = pEvt->lqi;
+  cnf.rssi = (int8)(-90 + (pEvt->lqi / 4));
+
+  simDigest( &pEvt->time, sizeof( pEvt->time ) );
+  simDigest( &pEvt->node, sizeof( pEvt->node ) );
+  simDigest( &pEvt->status, sizeof( pEvt->status ) );
+  simDigest( &pEvt->retries, sizeof( pEvt->retries ) );
+
+  MAC_CbackEvent( (macCbackEvent_t *)&cnf );
+}
+
+/*********************************************************************
+ * @fn      simSelect
+ *
+ * @brief   Swaps in the RAM and the flash of a node.
+ *
+ * @param   node - the node
+ *
+ * @return  none
+ */
+void simSelect( uint8 node )
+{
+  halHostNodeSelect( node );
+  simCur = node;
+}
+
+/*********************************************************************
+ * @fn      simInit
+ *
+ * @brief   Starts each node as ZMain does, from blank flash, with its own seed for
+ *          Onboard_rand(), its short and extended address and the channel model, and
+ *          runs it until it is idle. Called once per process: the RAM that the nodes are
+ *          started from is what they had before the first call.
+ *
+ * @param   nodeCnt - nodes, up to SIM_NODE_MAX
+ *          pLink - the channel model
+ *          seed - seed of the run, which every random draw comes from
+ *
+ * @return  none
+ */
+void simInit( uint8 nodeCnt, simLink_t pLink, uint32 seed )
+{
+  uint8 extAddr[SADDR_EXT_LEN];
+  uint16 addr;
+  uint16 panId = SIM_PAN_ID;
+  uint8 node;
+
+  simNodeCnt = (nodeCnt < SIM_NODE_MAX) ? nodeCnt : SIM_NODE_MAX;
+  simLinkFn = pLink;
+  simRandState = (seed != 0) ? seed : 1;
+  osal_memset( &simStats, 0, sizeof( simStats ) );
+  simStats.digest = 2166136261UL;
+
+  for ( node = 0; node < simNodeCnt; node++ )
+  {
+    simSelect( node );
+    osal_memset( simNodes + node, 0, sizeof( simNode_t ) );
+
+    halHostRandSeed = (seed * 2654435761UL) + node + 1;
+    halHostFlashReset();
+    InitBoard( OB_COLD );
+    osal_nv_init( NULL );
+    ZMacInit();
+
+    osal_memset( extAddr, 0, SADDR_EXT_LEN );
+    extAddr[0] = node;
+    extAddr[7] = 0x5A;
+    addr = SIM_NODE_ADDR( node );
+    ZMacSetReq( ZMacExtAddr, extAddr );
+    ZMacSetReq( ZMacShortAddress, (uint8 *)&addr );
+    ZMacSetReq( ZMacPanId, (uint8 *)&panId );
+    pZMac_ChannelReq = simDataReq;
+
+    // An item of the node's own in its own NV, for the harness to check.
+    (void)osal_nv_item_init( SIM_NV_ADDR, sizeof( addr ), &addr );
+
+    osal_init_system();
+    osal_int_enable( INTS_ALL );
+    simSettle();
+  }
+}
+
+/*********************************************************************
+ * @fn      simRun
+ *
+ * @brief   Runs the events due in the given time, in order, moving the clock to each one,
+ *          and then moves the clock to the end.
+ *
+ * @param   ms - simulated milliseconds
+ *
+ * @return  none
+ */
+void simRun( uint32 ms )
+{
+  unsigned long long end = halHostClockUs64() + ((unsigned long long)ms * 1000);
+  simEvent_t evt;
+
+  while ( (simEventCnt != 0) && (simEvents[0].time <= end) )
+  {
+    simPop( &evt );
+    if ( (evt.type == SIM_EVT_WAKE) && (evt.gen != simNodes[evt.node].wakeGen) )
+    {
+      continue;  // Replaced by a later wake-up
+    }
+
+    simAdvance( evt.time );
+    simStats.events++;
+    simSelect( evt.node );
+
+    if ( evt.type == SIM_EVT_IND )
+    {
+      simDeliver( &evt );
+    }
+    else if ( evt.type == SIM_EVT_CNF )
+    {
+      simConfirm( &evt );
+    }
+    simSettle();
+
+    if ( (evt.pFrame != NULL) && (--evt.pFrame->refCnt == 0) )
+    {
+      free( evt.pFrame );
+    }
+  }
+
+  simAdvance( end );
+}
+
+/*********************************************************************
+ * @fn      simGridInit
+ *
+ * @brief   Sets up the grid channel model.
+ *
+ * @param   cols - nodes in a row
+ *          range - furthest a frame is heard, in units of the grid
+ *          lossPct - percentage of the frames in range that are lost
+ *
+ * @return  none
+ */
+void simGridInit( uint8 cols, uint8 range, uint8 lossPct )
+{
+  simGridCols = (cols != 0) ? cols : 1;
+  simGridRange = (range != 0) ? range : 1;
+  simGridLoss = lossPct;
+}
+
+/*********************************************************************
+ * @fn      simGridLink
+ *
+ * @brief   Hears frames from nodes in range, at an LQI that falls off with the square of
+ *          the distance, less a random share of them.
+ *
+ * @param   src - sender
+ *          dst - receiver
+ *          pLqi - where to put the LQI
+ *
+ * @return  TRUE if the frame is received
+ */
+uint8 simGridLink( uint8 src, uint8 dst, uint8 *pLqi )
+{
+  int dx = (int)(src % simGridCols) - (int)(dst % simGridCols);
+  int dy = (int)(src / simGridCols) - (int)(dst / simGridCols);
+  int dist2 = (dx * dx) + (dy * dy);
+  int range2 = (int)simGridRange * simGridRange;
+
+  if ( (dist2 > range2) || ((simRand() % 100) < simGridLoss) )
+  {
+    return ( FALSE );
+  }
+
+  *pLqi = (uint8)(255 - ((dist2 * 200) / range2));
+
+  return ( TRUE );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,159 @@
+/**************************************************************************************************
+  Filename:       sim_host.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Discrete-event simulation of many nodes on the host.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef SIM_HOST_H
+#define SIM_HOST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ *  Discrete-event simulation of a network of nodes on the host. Every node runs its own OSAL,
+ *  OSAL NV, board and ZMAC in one process, each with its own task events, heap, timers and
+ *  NV image (halHostNodeSelect), and all of them on the one virtual clock. The channel model
+ *  takes each node's MAC data requests at ZMAC (pZMac_ChannelReq) and gives back the data
+ *  confirms and indications through MAC_CbackEvent(), as the MAC does. Time jumps from one
+ *  event to the next, and every random draw comes from the seed, so a run replays exactly.
+ *
+ *  Node n has the short address SIM_NODE_ADDR(n) on PAN SIM_PAN_ID. A unicast is sent up to
+ *  SIM_TX_ATTEMPTS times until it is acked; a frame that arrives is always acked. Frames do
+ *  not collide: a node's frames go out one at a time, after a random CSMA backoff.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+#include "hal_board_cfg.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Most nodes a simulation has.
+#define SIM_NODE_MAX            HAL_HOST_NODE_CNT
+
+#define SIM_PAN_ID              0x1A62
+
+// Transmissions of a unicast before it is confirmed MAC_NO_ACK: macMaxFrameRetries + 1.
+#define SIM_TX_ATTEMPTS         4
+
+// Application item that simInit() writes each node's short address to, in its own NV.
+#define SIM_NV_ADDR             0x0401
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define SIM_NODE_ADDR( n )      ((uint16)(n))
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*
+ * A channel model: returns TRUE if a frame that node src sends is received by node dst, and
+ * the LQI it is received at. Random losses must draw on simRand() to keep a run repeatable.
+ */
+typedef uint8 (*simLink_t)( uint8 src, uint8 dst, uint8 *pLqi );
+
+// Counts of a simulation run since simInit()
+typedef struct
+{
+  uint32 events;          // Events run
+  uint32 requests;        // Data requests taken from ZMAC
+  uint32 transmissions;   // Frames on air, retries included
+  uint32 indications;     // Data indications given to nodes
+  uint32 noAcks;          // Unicasts confirmed MAC_NO_ACK
+  uint32 heapDrops;       // Frames received by a node with no heap left for them
+  uint32 digest;          // Hash of every indication and confirm, with its time
+} simStats_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+extern simStats_t simStats;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Powers up nodeCnt nodes, from blank flash, on the given channel model and seed. Once per
+ * process: the nodes start from the RAM as it was before the first call.
+ */
+extern void simInit( uint8 nodeCnt, simLink_t pLink, uint32 seed );
+
+/*
+ * Runs the network for the given simulated time.
+ */
+extern void simRun( uint32 ms );
+
+/*
+ * Makes a node current, so that the harness can look at its state.
+ */
+extern void simSelect( uint8 node );
+
+/*
+ * Returns a random number drawn from the seed of the run.
+ */
+extern uint16 simRand( void );
+
+/*
+ * Sets up the grid channel model: nodes in rows of cols, one unit apart, hear each other up
+ * to range units away, and lose lossPct percent of the frames that are in range.
+ */
+extern void simGridInit( uint8 cols, uint8 range, uint8 lossPct );
+
+/*
+ * The grid channel model.
+ */
+extern uint8 simGridLink( uint8 src, uint8 dst, uint8 *pLqi );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_HOST_H */
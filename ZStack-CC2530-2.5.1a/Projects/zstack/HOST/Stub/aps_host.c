@@ -0,0 +1,381 @@
+/**************************************************************************************************
+  Filename:       aps_host.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-ins for the APS and NWK library calls made by the AF.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "AF.h"
+#include "APSMEDE.h"
+#include "aps_frag.h"
+#include "aps_groups.h"
+#include "NLMEDE.h"
+#include "rtg.h"
+
+#include "aps_host.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define APS_HOST_MTU           100
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+apsHostReq_t apsHostReqLog[APS_HOST_REQ_LOG];
+uint32 apsHostReqCnt;
+uint32 apsHostMtuCnt;
+uint16 apsHostFailAddr = INVALID_NODE_ADDR;
+uint8 apsHostClobber;
+
+// No fragmentation: AF rejects ASDUs longer than the MTU.
+APSF_SendFragmented_t *apsfSendFragmented = NULL;
+
+apsGroupItem_t *apsGroupTable = NULL;
+
+/*********************************************************************
+ * @fn      apsHostReset
+ *
+ * @brief   Clears the request log and counters and the test settings.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void apsHostReset( void )
+{
+  osal_memset( apsHostReqLog, 0, sizeof( apsHostReqLog ) );
+  apsHostReqCnt = 0;
+  apsHostMtuCnt = 0;
+  apsHostFailAddr = INVALID_NODE_ADDR;
+  apsHostClobber = FALSE;
+}
+
+/*********************************************************************
+ * @fn      APSDE_DataReq
+ *
+ * @brief   Logs a data request in place of sending it.
+ *
+ * @param   req - the request
+ *
+ * @return  ZSuccess, or ZApsNoAck for apsHostFailAddr
+ */
+ZStatus_t APSDE_DataReq( APSDE_DataReq_t *req )
+{
+  if ( apsHostReqCnt < APS_HOST_REQ_LOG )
+  {
+    apsHostReq_t *pLog = apsHostReqLog + apsHostReqCnt;
+    uint16 idx;
+
+    pLog->dstAddr = req->dstAddr.addr.shortAddr;
+    pLog->dstEP = req->dstEP;
+    pLog->transID = req->transID;
+    pLog->clusterID = req->clusterID;
+    pLog->txOptions = req->txOptions;
+    pLog->asduLen = req->asduLen;
+    pLog->radius = req->radiusCounter;
+    pLog->asduHash = 0;
+    for ( idx = 0; idx < req->asduLen; idx++ )
+    {
+      pLog->asduHash = (pLog->asduHash * 31) + req->asdu[idx];
+    }
+  }
+  apsHostReqCnt++;
+
+  if ( apsHostClobber )
+  {
+    req->txOptions = 0xFFFF;
+    req->radiusCounter = 0;
+    req->discoverRoute = 0xFF;
+    req->asduLen = 0xFFFF;
+    req->asdu = NULL;
+    req->apsCount = 0xFF;
+    req->blkCount = 0xFF;
+  }
+
+  return ( (req->dstAddr.addr.shortAddr == apsHostFailAddr) ? ZApsNoAck : ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      APSDE_DataReqMTU
+ *
+ * @brief   Returns a fixed MTU.
+ */
+uint8 APSDE_DataReqMTU( APSDE_DataReqMTU_t *fields )
+{
+  (void)fields;
+  apsHostMtuCnt++;
+
+  return ( APS_HOST_MTU );
+}
+
+/*********************************************************************
+ * @fn      NLME_GetShortAddr
+ *
+ * @brief   This device is the coordinator.
+ */
+uint16 NLME_GetShortAddr( void )
+{
+  return ( 0x0000 );
+}
+
+/*********************************************************************
+ * @fn      NLME_IsAddressBroadcast
+ *
+ * @brief   Treats every broadcast address as one for this device.
+ */
+addr_filter_t NLME_IsAddressBroadcast( uint16 shortAddress )
+{
+  return ( (shortAddress >= NWK_BROADCAST_SHORTADDR_DEVZCZR) ? ADDR_BCAST_FOR_ME : ADDR_NOT_BCAST );
+}
+
+/*********************************************************************
+ * @fn      RTG_CheckRtStatus
+ *
+ * @brief   Every route is active.
+ */
+RTG_Status_t RTG_CheckRtStatus( uint16 DstAddress, byte RtStatus, uint8 options )
+{
+  (void)DstAddress;
+  (void)RtStatus;
+  (void)options;
+
+  return ( RTG_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      RTG_AddSrcRtgEntry_Guaranteed
+ *
+ * @brief   Source routes are not kept.
+ */
+RTG_Status_t RTG_AddSrcRtgEntry_Guaranteed( uint16 srcAddr, uint8 relayCnt, uint16* pRelayList )
+{
+  (void)srcAddr;
+  (void)relayCnt;
+  (void)pRelayList;
+
+  return ( RTG_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      aps_AddGroup
+ *
+ * @brief   Appends a group of an endpoint to the tail of the group table.
+ *
+ * @return  ZSuccess, ZApsDuplicateEntry, ZApsTableFull or ZMemError
+ */
+ZStatus_t aps_AddGroup( uint8 endpoint, aps_Group_t *group )
+{
+  apsGroupItem_t **ppItem = &apsGroupTable;
+  apsGroupItem_t *pItem;
+  uint8 cnt = 0;
+
+  for ( ; *ppItem != NULL; ppItem = &(*ppItem)->next )
+  {
+    if ( ((*ppItem)->endpoint == endpoint) && ((*ppItem)->group.ID == group->ID) )
+    {
+      return ( ZApsDuplicateEntry );
+    }
+    cnt++;
+  }
+
+  if ( cnt >= APS_MAX_GROUPS )
+  {
+    return ( ZApsTableFull );
+  }
+
+  pItem = osal_mem_alloc( sizeof( apsGroupItem_t ) );
+  if ( pItem == NULL )
+  {
+    return ( ZMemError );
+  }
+
+  pItem->next = NULL;
+  pItem->endpoint = endpoint;
+  pItem->group = *group;
+  *ppItem = pItem;
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      aps_FindGroup
+ *
+ * @brief   Finds the group entry of an endpoint.
+ */
+aps_Group_t *aps_FindGroup( uint8 endpoint, uint16 groupID )
+{
+  apsGroupItem_t *pItem;
+
+  for ( pItem = apsGroupTable; pItem != NULL; pItem = pItem->next )
+  {
+    if ( (pItem->endpoint == endpoint) && (pItem->group.ID == groupID) )
+    {
+      return ( &pItem->group );
+    }
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      aps_FindGroupForEndpoint
+ *
+ * @brief   Finds the endpoint of a group that follows lastEP in the table.
+ */
+uint8 aps_FindGroupForEndpoint( uint16 groupID, uint8 lastEP )
+{
+  apsGroupItem_t *pItem;
+  uint8 found = (lastEP == APS_GROUPS_FIND_FIRST);
+
+  for ( pItem = apsGroupTable; pItem != NULL; pItem = pItem->next )
+  {
+    if ( pItem->group.ID == groupID )
+    {
+      if ( found )
+      {
+        return ( pItem->endpoint );
+      }
+      if ( pItem->endpoint == lastEP )
+      {
+        found = TRUE;
+      }
+    }
+  }
+
+  return ( APS_GROUPS_EP_NOT_FOUND );
+}
+
+/*********************************************************************
+ * @fn      aps_RemoveGroup
+ *
+ * @brief   Removes a group of an endpoint.
+ *
+ * @return  TRUE if removed, FALSE if not found
+ */
+uint8 aps_RemoveGroup( uint8 endpoint, uint16 groupID )
+{
+  apsGroupItem_t **ppItem;
+
+  for ( ppItem = &apsGroupTable; *ppItem != NULL; ppItem = &(*ppItem)->next )
+  {
+    if ( ((*ppItem)->endpoint == endpoint) && ((*ppItem)->group.ID == groupID) )
+    {
+      apsGroupItem_t *pItem = *ppItem;
+
+      *ppItem = pItem->next;
+      osal_mem_free( pItem );
+      return ( TRUE );
+    }
+  }
+
+  return ( FALSE );
+}
+
+/*********************************************************************
+ * @fn      aps_RemoveAllGroup
+ *
+ * @brief   Removes every group of an endpoint.
+ */
+void aps_RemoveAllGroup( uint8 endpoint )
+{
+  apsGroupItem_t **ppItem = &apsGroupTable;
+
+  while ( *ppItem != NULL )
+  {
+    if ( (*ppItem)->endpoint == endpoint )
+    {
+      apsGroupItem_t *pItem = *ppItem;
+
+      *ppItem = pItem->next;
+      osal_mem_free( pItem );
+    }
+    else
+    {
+      ppItem = &(*ppItem)->next;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      aps_FindAllGroupsForEndpoint
+ *
+ * @brief   Lists the groups of an endpoint.
+ *
+ * @return  number of groups copied to groupList
+ */
+uint8 aps_FindAllGroupsForEndpoint( uint8 endpoint, uint16 *groupList )
+{
+  apsGroupItem_t *pItem;
+  uint8 cnt = 0;
+
+  for ( pItem = apsGroupTable; pItem != NULL; pItem = pItem->next )
+  {
+    if ( pItem->endpoint == endpoint )
+    {
+      groupList[cnt++] = pItem->group.ID;
+    }
+  }
+
+  return ( cnt );
+}
+
+/*********************************************************************
+ * @fn      aps_CountAllGroups
+ *
+ * @brief   Counts the entries of the group table.
+ */
+uint8 aps_CountAllGroups( void )
+{
+  apsGroupItem_t *pItem;
+  uint8 cnt = 0;
+
+  for ( pItem = apsGroupTable; pItem != NULL; pItem = pItem->next )
+  {
+    cnt++;
+  }
+
+  return ( cnt );
+}
+
+/*********************************************************************
+*********************************************************************/
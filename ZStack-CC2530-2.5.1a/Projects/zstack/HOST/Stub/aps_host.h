@@ -0,0 +1,116 @@
+/**************************************************************************************************
+  Filename:       aps_host.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-ins for the APS and NWK library calls made by the AF.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef APS_HOST_H
+#define APS_HOST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ *  Stands in for the parts of the prebuilt APS and NWK libraries that AF.c calls, so that the
+ *  AF (and the ZCL above it) can be benchmarked on the host. Data requests are not sent
+ *  anywhere: they are counted and logged for the benchmark to check. The group table is a
+ *  list with new entries at the tail, as the APS library keeps it.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+#include "APSMEDE.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Requests kept in apsHostReqLog[]; later ones are only counted.
+#define APS_HOST_REQ_LOG       64
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// What APSDE_DataReq() was asked to send
+typedef struct
+{
+  uint16 dstAddr;
+  uint8  dstEP;
+  uint8  transID;
+  uint16 clusterID;
+  uint16 txOptions;
+  uint16 asduLen;
+  uint8  radius;
+  uint16 asduHash;
+} apsHostReq_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+extern apsHostReq_t apsHostReqLog[APS_HOST_REQ_LOG];
+extern uint32 apsHostReqCnt;     // Calls of APSDE_DataReq()
+extern uint32 apsHostMtuCnt;     // Calls of APSDE_DataReqMTU()
+
+// Requests to this short address fail with ZApsNoAck.
+extern uint16 apsHostFailAddr;
+
+// When TRUE, APSDE_DataReq() overwrites the request fields that the library may change in
+// place (Tx options, radius, ASDU), so that a caller that reuses a request shows up.
+extern uint8 apsHostClobber;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Clears the request log and counters, and the failure and clobber settings.
+ */
+extern void apsHostReset( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APS_HOST_H */
@@ -0,0 +1,487 @@
+/**************************************************************************************************
+  Filename:       mac_host.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-ins for the MAC library calls made by ZMAC.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*
+ *  Stands in for the prebuilt MAC library, and the few NWK library entries, that ZMAC calls,
+ *  so that ZMAC runs on the host under the channel model of a simulation (pZMac_ChannelReq).
+ *  The PIB keeps only the addresses; the rest of the MLME requests do nothing. The state
+ *  here is per node in the simulation build, as the MAC's is on each device.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "ZMAC.h"
+#include "mac_main.h"
+#include "nwk.h"
+#include "nwk_bufs.h"
+#include "nwk_globals.h"
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+nwkIB_t _NIB;
+uint8 NWK_TaskID;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 macHostShortAddr;
+static uint16 macHostPanId;
+static uint8 macHostExtAddr[SADDR_EXT_LEN];
+static uint8 macHostAssocPanCoord;
+
+/*********************************************************************
+ * @fn      MAC_Init
+ *
+ * @brief   Sets the NWK protocol version that ZMAC filters frames on.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void MAC_Init( void )
+{
+  _NIB.nwkProtocolVersion = ZB_PROT_VERS;
+}
+
+/*********************************************************************
+ * @fn      MAC_InitDevice
+ *
+ * @brief   Nothing to initialize.
+ */
+void MAC_InitDevice( void )
+{
+}
+
+/*********************************************************************
+ * @fn      MAC_InitCoord
+ *
+ * @brief   Nothing to initialize.
+ */
+void MAC_InitCoord( void )
+{
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeResetReq
+ *
+ * @brief   Returns the addresses to their defaults.
+ *
+ * @param   setDefaultPib - unused, the PIB is always reset
+ *
+ * @return  MAC_SUCCESS
+ */
+uint8 MAC_MlmeResetReq( bool setDefaultPib )
+{
+  (void)setDefaultPib;
+
+  macHostShortAddr = INVALID_NODE_ADDR;
+  macHostPanId = 0xFFFF;
+  osal_memset( macHostExtAddr, 0, SADDR_EXT_LEN );
+  macHostAssocPanCoord = FALSE;
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeGetReq
+ *
+ * @brief   Reads a PIB attribute.
+ *
+ * @param   pibAttribute - attribute
+ *          pValue - where to put its value
+ *
+ * @return  MAC_SUCCESS, or MAC_UNSUPPORTED_ATTRIBUTE for one that is not kept
+ */
+uint8 MAC_MlmeGetReq( uint8 pibAttribute, void *pValue )
+{
+  switch ( pibAttribute )
+  {
+    case MAC_SHORT_ADDRESS:
+      osal_memcpy( pValue, &macHostShortAddr, sizeof( uint16 ) );
+      break;
+
+    case MAC_PAN_ID:
+      osal_memcpy( pValue, &macHostPanId, sizeof( uint16 ) );
+      break;
+
+    case MAC_EXTENDED_ADDRESS:
+      osal_memcpy( pValue, macHostExtAddr, SADDR_EXT_LEN );
+      break;
+
+    case MAC_ASSOCIATED_PAN_COORD:
+      *(uint8 *)pValue = macHostAssocPanCoord;
+      break;
+
+    default:
+      return ( MAC_UNSUPPORTED_ATTRIBUTE );
+  }
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeSetReq
+ *
+ * @brief   Writes a PIB attribute; those that are not kept are ignored.
+ *
+ * @param   pibAttribute - attribute
+ *          pValue - its new value
+ *
+ * @return  MAC_SUCCESS
+ */
+uint8 MAC_MlmeSetReq( uint8 pibAttribute, void *pValue )
+{
+  switch ( pibAttribute )
+  {
+    case MAC_SHORT_ADDRESS:
+      osal_memcpy( &macHostShortAddr, pValue, sizeof( uint16 ) );
+      break;
+
+    case MAC_PAN_ID:
+      osal_memcpy( &macHostPanId, pValue, sizeof( uint16 ) );
+      break;
+
+    case MAC_EXTENDED_ADDRESS:
+      osal_memcpy( macHostExtAddr, pValue, SADDR_EXT_LEN );
+      break;
+
+    case MAC_ASSOCIATED_PAN_COORD:
+      macHostAssocPanCoord = *(uint8 *)pValue;
+      break;
+
+    default:
+      break;
+  }
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_McpsDataAlloc
+ *
+ * @brief   Allocates a data request with room for the MSDU after it, from the OSAL
+ *          message heap as the MAC does.
+ *
+ * @param   len - MSDU length
+ *          securityLevel - unused, no room is needed for a MIC
+ *          keyIdMode - unused
+ *
+ * @return  the request, or NULL
+ */
+macMcpsDataReq_t *MAC_McpsDataAlloc( uint8 len, uint8 securityLevel, uint8 keyIdMode )
+{
+  macMcpsDataReq_t *pReq;
+
+  (void)securityLevel;
+  (void)keyIdMode;
+
+  pReq = (macMcpsDataReq_t *)osal_msg_allocate( sizeof( macMcpsDataReq_t ) + len );
+  if ( pReq != NULL )
+  {
+    osal_memset( pReq, 0, sizeof( macMcpsDataReq_t ) );
+    pReq->msdu.p = (uint8 *)(pReq + 1);
+    pReq->msdu.len = len;
+  }
+
+  return ( pReq );
+}
+
+/*********************************************************************
+ * @fn      MAC_McpsDataReq
+ *
+ * @brief   With no channel model no one hears the frame: confirms it at once, with
+ *          MAC_NO_ACK if an ack was asked for.
+ *
+ * @param   pData - the request, freed with the confirm
+ *
+ * @return  none
+ */
+void MAC_McpsDataReq( macMcpsDataReq_t *pData )
+{
+  macMcpsDataCnf_t cnf;
+
+  pData->internal.txOptions = pData->mac.txOptions;
+
+  osal_memset( &cnf, 0, sizeof( cnf ) );
+  cnf.hdr.event = MAC_MCPS_DATA_CNF;
+  cnf.hdr.status = (pData->mac.txOptions & MAC_TXOPTION_ACK) ? MAC_NO_ACK : MAC_SUCCESS;
+  cnf.msduHandle = pData->mac.msduHandle;
+  cnf.pDataReq = pData;
+
+  MAC_CbackEvent( (macCbackEvent_t *)&cnf );
+}
+
+/*********************************************************************
+ * @fn      mac_msg_deallocate
+ *
+ * @brief   Frees a MAC message and clears the caller's pointer to it.
+ *
+ * @param   msg_ptr - pointer to the message pointer
+ *
+ * @return  none
+ */
+void mac_msg_deallocate( uint8 **msg_ptr )
+{
+  if ( *msg_ptr != NULL )
+  {
+    osal_msg_deallocate( *msg_ptr );
+    *msg_ptr = NULL;
+  }
+}
+
+/*********************************************************************
+ * @fn      macStateIdle
+ *
+ * @brief   The MAC never has work of its own in progress.
+ *
+ * @return  TRUE
+ */
+bool macStateIdle( void )
+{
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      MAC_McpsPurgeReq
+ *
+ * @brief   Nothing is queued to purge.
+ */
+void MAC_McpsPurgeReq( uint8 msduHandle )
+{
+  (void)msduHandle;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeAssociateReq
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmeAssociateReq( macMlmeAssociateReq_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeAssociateRsp
+ *
+ * @brief   Not simulated.
+ */
+uint8 MAC_MlmeAssociateRsp( macMlmeAssociateRsp_t *pData )
+{
+  (void)pData;
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeDisassociateReq
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmeDisassociateReq( macMlmeDisassociateReq_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeOrphanRsp
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmeOrphanRsp( macMlmeOrphanRsp_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmePollReq
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmePollReq( macMlmePollReq_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeScanReq
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmeScanReq( macMlmeScanReq_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeStartReq
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmeStartReq( macMlmeStartReq_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_MlmeSyncReq
+ *
+ * @brief   Not simulated.
+ */
+void MAC_MlmeSyncReq( macMlmeSyncReq_t *pData )
+{
+  (void)pData;
+}
+
+/*********************************************************************
+ * @fn      MAC_PwrOnReq
+ *
+ * @brief   The radio is always on.
+ */
+void MAC_PwrOnReq( void )
+{
+}
+
+/*********************************************************************
+ * @fn      MAC_PwrMode
+ *
+ * @brief   The radio is always on.
+ */
+uint8 MAC_PwrMode( void )
+{
+  return ( MAC_PWR_ON );
+}
+
+/*********************************************************************
+ * @fn      MAC_SrcMatchEnable
+ *
+ * @brief   No frames are held, so there is nothing to match.
+ */
+uint8 MAC_SrcMatchEnable( uint8 addrType, uint8 num )
+{
+  (void)addrType;
+  (void)num;
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_SrcMatchAddEntry
+ *
+ * @brief   No frames are held, so there is nothing to match.
+ */
+uint8 MAC_SrcMatchAddEntry( sAddr_t *addr, uint16 panID )
+{
+  (void)addr;
+  (void)panID;
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_SrcMatchDeleteEntry
+ *
+ * @brief   No frames are held, so there is nothing to match.
+ */
+uint8 MAC_SrcMatchDeleteEntry( sAddr_t *addr, uint16 panID )
+{
+  (void)addr;
+  (void)panID;
+
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      MAC_SrcMatchAckAllPending
+ *
+ * @brief   No frames are held, so there is nothing to match.
+ */
+void MAC_SrcMatchAckAllPending( uint8 option )
+{
+  (void)option;
+}
+
+/*********************************************************************
+ * @fn      MAC_SrcMatchCheckAllPending
+ *
+ * @brief   No frames are held, so there is nothing to match.
+ */
+uint8 MAC_SrcMatchCheckAllPending( void )
+{
+  return ( MAC_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      nwk_broadcastSend
+ *
+ * @brief   Hands a broadcast to the NWK task, as it does the other indications; the NWK
+ *          library would queue it for its own relaying.
+ *
+ * @param   msg_ptr - the data indication
+ *
+ * @return  SUCCESS, the message is always taken
+ */
+uint8 nwk_broadcastSend( uint8 *msg_ptr )
+{
+  // osal_msg_send() frees what it cannot deliver.
+  (void)osal_msg_send( NWK_TaskID, msg_ptr );
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      nwkDB_ReturnIndirectHoldingCnt
+ *
+ * @brief   No frames are held for sleeping children.
+ *
+ * @return  0
+ */
+uint8 nwkDB_ReturnIndirectHoldingCnt( void )
+{
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -231,7 +231,7 @@ void SampleApp_Init( uint8 task_id )
   // By default, all devices start out in Group 1
   SampleApp_Group.ID = 0x0001;
   osal_memcpy( SampleApp_Group.name, "Group 1", 7  );
-  aps_AddGroup( SAMPLEAPP_ENDPOINT, &SampleApp_Group );
+  afAddGroup( SAMPLEAPP_ENDPOINT, &SampleApp_Group );
 
 #if defined ( LCD_SUPPORTED )
   HalLcdWriteString( "SampleApp", HAL_LCD_LINE_1 );
@@ -365,12 +365,12 @@ void SampleApp_HandleKeys( uint8 shift, uint8 keys )
     if ( grp )
     {
       // Remove from the group
-      aps_RemoveGroup( SAMPLEAPP_ENDPOINT, SAMPLEAPP_FLASH_GROUP );
+      afRemoveGroup( SAMPLEAPP_ENDPOINT, SAMPLEAPP_FLASH_GROUP );
     }
     else
     {
       // Add to the flash group
-      aps_AddGroup( SAMPLEAPP_ENDPOINT, &SampleApp_Group );
+      afAddGroup( SAMPLEAPP_ENDPOINT, &SampleApp_Group );
     }
   }
 }
@@ -0,0 +1,194 @@
+/**************************************************************************************************
+  Filename:       OnBoard.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Board support for running OSAL in a POSIX process.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+
+#include "ZComDef.h"
+#include "OnBoard.h"
+#include "OSAL.h"
+
+/* Hal */
+#include "hal_mcu.h"
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// 64-bit Extended Address of this device
+uint8 aExtendedAddress[8];
+
+// Seed of Onboard_rand(), 0 seeds from the clock
+uint32 halHostRandSeed = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint32 onboardRandState = 1;
+
+/*********************************************************************
+ * @fn      InitBoard()
+ * @brief   Initialize the host simulation
+ * @param   level: COLD,WARM,READY
+ * @return  None
+ */
+void InitBoard( uint8 level )
+{
+  if ( level == OB_COLD )
+  {
+    // Start the simulated clock and seed the random numbers, from it unless
+    // the harness chose a seed so that every node repeats its run.
+    onboardRandState = ( halHostRandSeed != 0 ) ? halHostRandSeed : halHostClockUs();
+    if ( onboardRandState == 0 )
+    {
+      onboardRandState = 1;  // xorshift never leaves 0
+    }
+    HAL_ENABLE_INTERRUPTS();
+  }
+}
+
+/*********************************************************************
+ * @fn      TimerElapsed()
+ * @brief   There is no sleep timer to catch up with on the host, the
+ *          OSAL clock follows CLOCK_MONOTONIC in osalTimeUpdate().
+ * @param   None
+ * @return  0
+ */
+uint32 TimerElapsed( void )
+{
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      _itoa
+ *
+ * @brief   convert a 16bit number to ASCII
+ *
+ * @param   num -
+ *          buf -
+ *          radix -
+ *
+ * @return  void
+ *
+ *********************************************************************/
+void _itoa(uint16 num, uint8 *buf, uint8 radix)
+{
+  char c,i;
+  uint8 *p, rst[5];
+
+  p = rst;
+  for ( i=0; i<5; i++,p++ )
+  {
+    c = num % radix;  // Isolate a digit
+    *p = c + (( c < 10 ) ? '0' : '7');  // Convert to Ascii
+    num /= radix;
+    if ( !num )
+      break;
+  }
+
+  for ( c=0 ; c<=i; c++ )
+    *buf++ = *p--;  // Reverse character order
+
+  *buf = '\0';
+}
+
+/*********************************************************************
+ * @fn        Onboard_rand
+ *
+ * @brief    Random number generator - xorshift32, so that a seeded
+ *           run draws the same numbers on every host libc.
+ *
+ * @param   none
+ *
+ * @return  uint16 - new random number
+ *
+ *********************************************************************/
+uint16 Onboard_rand( void )
+{
+  onboardRandState ^= onboardRandState << 13;
+  onboardRandState ^= onboardRandState >> 17;
+  onboardRandState ^= onboardRandState << 5;
+
+  return ( (uint16)(onboardRandState >> 16) );
+}
+
+/*********************************************************************
+ * @fn        Onboard_wait
+ *
+ * @brief    Delay wait - with the virtual clock the time is
+ *           accounted for instead of spent.
+ *
+ * @param   uint16 - time to wait in micro-seconds
+ *
+ * @return  none
+ *
+ *********************************************************************/
+void Onboard_wait( uint16 timeout )
+{
+#if HAL_HOST_VIRTUAL_CLOCK
+  halHostClockAdvance( timeout );
+#else
+  uint32 start = halHostClockUs();
+
+  while ( (uint32)(halHostClockUs() - start) < timeout )
+  {
+  }
+#endif
+}
+
+/*********************************************************************
+ * @fn      Onboard_soft_reset
+ *
+ * @brief   Effect a soft reset.
+ *
+ * @param   none
+ *
+ * @return  none
+ *
+ *********************************************************************/
+void Onboard_soft_reset( void )
+{
+  HAL_SYSTEM_RESET();
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,153 @@
+/**************************************************************************************************
+  Filename:       OnBoard.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Board definitions for the POSIX host simulation.
+
+
+  Copyright 2006-2010 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef ONBOARD_H
+#define ONBOARD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "hal_mcu.h"
+#include "hal_uart.h"
+#include "hal_sleep.h"
+#include "OSAL.h"
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// 64-bit Extended Address of this device
+extern uint8 aExtendedAddress[8];
+
+// Seed of Onboard_rand(), set before InitBoard( OB_COLD ) to repeat a run; 0 seeds from the clock
+extern uint32 halHostRandSeed;
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Timer clock and power-saving definitions
+#define TIMER_DECR_TIME    1  // 1ms - has to be matched with TC_OCC
+
+/* OSAL timer defines */
+#define TICK_TIME   1000   // Timer per tick - in micro-sec
+#define TICK_COUNT  1
+
+// Restart system from absolute beginning
+#define SystemReset()       \
+{                           \
+  HAL_DISABLE_INTERRUPTS(); \
+  HAL_SYSTEM_RESET();       \
+}
+
+#define SystemResetSoft()  Onboard_soft_reset()
+
+/* Reset reason for reset indication - always power-on */
+#define ResetReason() (0)
+
+#define WatchDogEnable(wdti)
+
+// Wait for specified microseconds
+#define MicroWait(t) Onboard_wait(t)
+
+#define OSAL_SET_CPU_INTO_SLEEP(timeout) halSleep(timeout); /* Called from OSAL_PwrMgr */
+
+/* Same heap sizes as the TI2530DB target, so heap benchmarks see target pressure. */
+#if !defined INT_HEAP_LEN
+#if defined RTR_NWK
+  #define INT_HEAP_LEN  3072
+#else
+  #define INT_HEAP_LEN  2048
+#endif
+#endif
+#define MAXMEMHEAP INT_HEAP_LEN
+
+// Initialization levels
+#define OB_COLD  0
+#define OB_WARM  1
+#define OB_READY 2
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+  /*
+   * Initialize the Peripherals
+   *    level: 0=cold, 1=warm, 2=ready
+   */
+  extern void InitBoard( uint8 level );
+
+ /*
+  * Get elapsed timer clock counts
+  */
+  extern uint32 TimerElapsed( void );
+
+  /*
+   * Convert an interger to an ascii string
+   */
+  extern void _itoa( uint16 num, uint8 *buf, uint8 radix );
+
+  /*
+   * Board specific random number generator
+   */
+  extern uint16 Onboard_rand( void );
+
+  /*
+   * Board specific micro-second wait
+   */
+  extern void Onboard_wait( uint16 timeout );
+
+  /*
+   * Board specific soft reset.
+   */
+  extern void Onboard_soft_reset( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ONBOARD_H